@@ -14,17 +14,53 @@
 
 #include "grok3d/ecs/component/TransformComponent.h"
 #include "grok3d/ecs/component/GameLogicComponent.h"
+#include "grok3d/ecs/component/BoundsComponent.h"
+#include "grok3d/ecs/component/NameComponent.h"
 #include "grok3d/ecs/component/ComponentHandle.h"
 
+#include "grok3d/ecs/cell/CellBlob.h"
+
+#include "grok3d/ecs/name/SymbolIndex.h"
+
+#include "grok3d/ecs/query/EntityQuery.h"
+
+#include "grok3d/ecs/snapshot/WorldSnapshot.h"
+
+#include "grok3d/ecs/spatial/SpatialHashGrid.h"
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+#include "grok3d/ecs/store/ComponentStore.h"
+#include "grok3d/ecs/store/EntityIndex.h"
+#include "grok3d/ecs/store/IndexRanges.h"
+#include "grok3d/ecs/store/RuntimeComponentStore.h"
+#include "grok3d/ecs/store/StoreOrdering.h"
+
 #include "grok3d/ecs/system/SystemManager.h"
 
-#include "notstd/bidir_map.h"
+#include "grok3d/ecs/transform/StaticTransformPartition.h"
+#include "grok3d/ecs/transform/TransformHierarchy.h"
+
+#include "notstd/span.h"
 #include "notstd/tupleextensions.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
 #include <vector>
 #include <tuple>
 #include <unordered_map>
 #include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 namespace Grok3d {
 /**
@@ -61,22 +97,40 @@ class GRK_EntityComponentManager__ {
  private:
   /**A tuple containing all the types in ComponentTypes*/
   using ComponentTuple = std::tuple<ComponentTypes...>;
-  /**A tuple of vectors of each ComponentType**/
-  using ComponentStoreTuple = std::tuple<std::vector<ComponentTypes>...>;
+  /**A tuple of the stores of each ComponentType, a vector unless the type opted in to another
+   * layout (see @link GRK_ComponentStoreSelector GRK_ComponentStoreSelector @endlink)**/
+  using ComponentStoreTuple = std::tuple<GRK_ComponentStore<ComponentTypes>...>;
+  /**A tuple of the entity to index lookup of each ComponentType, picked by its @link
+   * GRK_EntityIndexStrategyOf GRK_EntityIndexStrategyOf @endlink*/
+  using EntityIndexTuple = std::tuple<GRK_EntityIndex<ComponentTypes>...>;
 
  public:
+  /// The snapshot type published by this manager, see PublishSnapshot.
+  using WorldSnapshot = GRK_WorldSnapshot__<ComponentTypes...>;
+
   GRK_EntityComponentManager__() noexcept :
       nextEntityId_(1),
       deletedUncleanedEntities_(std::vector<GRK_Entity>()),
       entityComponentsBitMaskMap_(std::unordered_map<GRK_Entity, GRK_ComponentBitMask>(c_initial_entity_array_size)),
-      entityComponentIndexMaps_(std::vector<notstd::unordered_bidir_map<GRK_Entity, ComponentInstance>>()),
+      capacityPolicies_{GRK_ComponentCapacityPolicy<ComponentTypes>::value...},
       systemManager_(nullptr) /*This must be injected later by the engine.*/ {
     static_assert(notstd::ensure_parameter_pack_unique<ComponentTypes...>::value,
                   "The template arguments to GRK_EntityComponentManager__ must all be unique");
+    static_assert(sizeof...(ComponentTypes) <= kMaxComponentTypes,
+                  "There are more component types than bits in GRK_ComponentBitMask");
+    static_assert((GRK_IsValidCapacityPolicy(GRK_ComponentCapacityPolicy<ComponentTypes>::value) && ...),
+                  "GRK_ComponentCapacityPolicy specializations must have non zero denominators");
 
     deletedUncleanedEntities_.reserve(c_initial_entity_array_size / 4);
 
     setup_component_stores(*this, componentStores_);
+
+    transformHierarchy_.SetResolver([this](GRK_Entity entity) -> GRK_TransformComponent* {
+      const auto instance = GetEntityIndex<GRK_TransformComponent>().at(entity);
+      return instance == kNoComponentInstance
+             ? nullptr
+             : &std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_)[instance];
+    });
   }
 
   /**
@@ -110,16 +164,22 @@ class GRK_EntityComponentManager__ {
    * of the game engine, this class entirely encapsulates the concept of an entity and all
    * it's components
    *
+   * @param[in] mobility pass @link GRK_TransformMobility::Static Static @endlink for entities
+   * that will never move once placed, their transforms are baked into @link
+   * GRK_EntityComponentManager__::GetStaticTransforms GetStaticTransforms @endlink instead of
+   * being swept every tick
+   *
    * @returns A handle to the newly created entity*/
-  auto CreateEntity() -> GRK_EntityHandle {
+  auto CreateEntity(GRK_TransformMobility mobility = GRK_TransformMobility::Dynamic)
+      -> GRK_EntityHandle__<GRK_EntityComponentManager__> {
     //I could do a check here to see if we overflowed to 0 but that's just inconceivable that we'd have that many (2^32) entities
     auto id = nextEntityId_++;
 
     entityComponentsBitMaskMap_[id] = 0;
 
-    this->AddComponent(id, GRK_TransformComponent());
+    this->AddComponent(id, GRK_TransformComponent(mobility));
 
-    return GRK_EntityHandle(this, id);
+    return GRK_EntityHandle__<GRK_EntityComponentManager__>(this, id);
   }
 
   /**
@@ -159,7 +219,7 @@ class GRK_EntityComponentManager__ {
     deletedUncleanedEntities_.push_back(entity);
 
     // send a component bit mask of 0 to all Systems, no components means any system will unregister
-    systemManager_->UnregisterEntity(GRK_EntityHandle(this, entity));
+    UnregisterFromSystems(entity);
 
     return GRK_Result::Ok;
   }
@@ -183,6 +243,12 @@ class GRK_EntityComponentManager__ {
     return notstd::type_to_index<ComponentType, ComponentTuple>::value;
   }
 
+  /**The number of compile time component types, runtime registered components are given the
+   * bits after these*/
+  static constexpr auto GetComponentTypeCount() -> size_t {
+    return sizeof...(ComponentTypes);
+  }
+
   /**
    * @brief Adds a component to the an entity in the scene
    *
@@ -205,7 +271,8 @@ class GRK_EntityComponentManager__ {
    *  @returns
    *  @link GRK_Result::Ok Ok @endlink
    *  @link GRK_Result::EntityAlreadyDeleted EntityAlreadyDeleted @endlink
-   *  @link GRK_Result::ComponentAlreadyAdded ComponentAlreadyAdded @endlink*/
+   *  @link GRK_Result::ComponentAlreadyAdded ComponentAlreadyAdded @endlink
+   *  @link GRK_Result::NameAlreadyTaken NameAlreadyTaken @endlink*/
   template<class ComponentType>
   auto AddComponent(GRK_Entity entity, ComponentType&& newComponent) -> GRK_Result {
     static_assert(notstd::param_pack_has_type<ComponentType, ComponentTypes...>::value,
@@ -221,34 +288,59 @@ class GRK_EntityComponentManager__ {
     if ((entityComponentsBitMaskMap_[entity] & IndexToMask(componentTypeIndex)) == 0) {
       // TODO should be ref but will be updated soon
       auto& componentTypeVector =
-          std::get<std::vector<ComponentType>>(componentStores_);
+          std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+
+      if constexpr (std::is_same<ComponentType, GRK_NameComponent>::value) {
+        if (nameIndex_.Find(newComponent.GetName()) != 0) {
+          return GRK_Result::NameAlreadyTaken;
+        }
+      }
 
       if (componentTypeVector.size() == componentTypeVector.max_size()) {
         return GRK_Result::NoSpaceRemaining;
       } else {
-        //TODO 8 have 2 CVARs that customizes load reallocation size, for now i'm doing 10% larger
-        //SCALE NUM and SCALE DEN
-        //DOCUMENTATION put the formula for scale factor of this in the docs, %scale = (1+NUM/DEN)
+        //names are looked up through nameIndex_
+        if constexpr (std::is_same<ComponentType, GRK_NameComponent>::value) {
+          nameIndex_.Put(newComponent.GetName(), entity);
+        }
 
-        //resize vector if necessary
+        //transforms keep their depth level up to date in transformHierarchy_
+        if constexpr (std::is_same<ComponentType, GRK_TransformComponent>::value) {
+          newComponent.JoinHierarchy(&transformHierarchy_, entity);
+        }
+
+        //bounds keep a proxy in spatialIndex_
+        if constexpr (std::is_same<ComponentType, GRK_BoundsComponent>::value) {
+          newComponent.JoinSpatialIndex(&spatialIndex_, entity, ComputeWorldBounds(entity, newComponent.GetLocalBounds()));
+        }
+
+        //resize vector if necessary, by the type's GRK_CapacityPolicy (scale = 1 + NUM/DEN)
         const auto cap = componentTypeVector.capacity();
         if (cap == componentTypeVector.size()) {
-          componentTypeVector.reserve(cap + cap / 10);
+          componentTypeVector.reserve(GRK_GrowCapacity(capacityPolicies_[componentTypeIndex], cap));
         }
 
         //add the component to the end our vector
         componentTypeVector.push_back(std::move(newComponent));
 
-        auto& entityInstanceMap = entityComponentIndexMaps_.at(componentTypeIndex);
+        auto& entityInstanceMap = GetEntityIndex<ComponentType>();
 
         //the new size - 1 is the index of the vector the element is stored at
         entityInstanceMap.put(entity, static_cast<ComponentInstance>(componentTypeVector.size() - 1));
+        storeVersions_[componentTypeIndex]++;
+        storeLayoutVersions_[componentTypeIndex]++;
+
+        //enabled entities' components go before the disabled ones
+        if ((entityComponentsBitMaskMap_[entity] & kDisabledEntityMask) == 0) {
+          auto& activeCount = activeCounts_[componentTypeIndex];
+          SwapComponentsInStore<ComponentType>(componentTypeVector.size() - 1, activeCount);
+          activeCount++;
+        }
 
-        entityComponentsBitMaskMap_[entity] |=
-            IndexToMask(componentTypeIndex);
+        SetEntityComponentsBitMask(entity, entityComponentsBitMaskMap_[entity] | IndexToMask(componentTypeIndex));
 
         //inform all systems of new component added to this entity
-        systemManager_->UpdateSystemEntities(GRK_EntityHandle(this, entity));
+        UpdateSystemEntities(entity);
 
         return GRK_Result::Ok;
       }
@@ -268,9 +360,11 @@ class GRK_EntityComponentManager__ {
    *
    * @tparam ComponentType the type of component you'd like to get a handle for*/
   template<class ComponentType>
-  auto GetComponent(GRK_Entity entity) -> GRK_ComponentHandle<ComponentType> {
+  auto GetComponent(GRK_Entity entity) -> GRK_ComponentHandle<ComponentType, GRK_EntityComponentManager__> {
     static_assert(notstd::param_pack_has_type<ComponentType, ComponentTypes...>::value,
                   "GetComponent Function requires ComponentType be one of the template params of GRK_EntityComponentManager__");
+    static_assert(!GRK_UseSoALayout<ComponentType>::value,
+                  "Components stored as struct of arrays have no address, use GetComponentReference or GetComponentColumn");
 
     auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
 
@@ -278,26 +372,131 @@ class GRK_EntityComponentManager__ {
         static_cast<GRK_ComponentBitMask>(IndexToMask(componentTypeIndex));
 
     if (entity == 0 || (entityComponentsBitMaskMap_.at(entity) & componentMask) == 0) {
-      return GRK_ComponentHandle<ComponentType>(nullptr, nullptr, -1);
+      return GRK_ComponentHandle<ComponentType, GRK_EntityComponentManager__>(nullptr, nullptr, -1);
     } else if ((entityComponentsBitMaskMap_.at(entity) & componentMask) == componentMask) {
       //this is a vector of the type we are trying to remove
       // TODO should be ref but will be changed soon
       const auto& componentTypeVector =
-          std::get<std::vector<ComponentType>>(componentStores_);
+          std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
 
-      const auto& entityInstanceMap = entityComponentIndexMaps_.at(componentTypeIndex);
+      const auto& entityInstanceMap = GetEntityIndex<ComponentType>();
 
       //get the instance (index in our vector) from teh entityInstanceMap
       const auto instance = entityInstanceMap.at(entity);
 
+      //the handle can be written through, so the store counts as changed for snapshots
+      storeVersions_[componentTypeIndex]++;
+
       //use the instance to index the array of that componenttype
       const auto* const componentPointer = &(componentTypeVector.at(instance));
 
       //return it in a handle
-      return GRK_ComponentHandle<ComponentType>(this, componentPointer, entity);
+      return GRK_ComponentHandle<ComponentType, GRK_EntityComponentManager__>(this, componentPointer, entity);
     } else {
-      return GRK_ComponentHandle<ComponentType>(nullptr, nullptr, -1);
+      return GRK_ComponentHandle<ComponentType, GRK_EntityComponentManager__>(nullptr, nullptr, -1);
+    }
+  }
+
+  /**
+   * @brief Get a proxy reference to a component stored as struct of arrays
+   *
+   * @details
+   * Components that opted in to @link GRK_UseSoALayout GRK_UseSoALayout @endlink are not
+   * stored as whole objects so there is nothing for a @link GRK_ComponentHandle
+   * GRK_ComponentHandle @endlink to point at, this hands out a @link GRK_SoAReference__
+   * GRK_SoAReference @endlink instead.  Like pointers into a vector it is invalidated by
+   * adding or removing components of the same type.
+   *
+   * @param[in] entity the entity you would like to query about
+   *
+   * @tparam ComponentType the struct of arrays component type
+   *
+   * @returns the reference, which is not @link GRK_SoAReference__::IsValid valid @endlink if
+   * the entity does not have the component*/
+  template<class ComponentType>
+  auto GetComponentReference(GRK_Entity entity) -> GRK_SoAReference<ComponentType> {
+    static_assert(GRK_UseSoALayout<ComponentType>::value,
+                  "GetComponentReference is only for struct of arrays components, use GetComponent");
+
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    const auto componentMask = static_cast<GRK_ComponentBitMask>(IndexToMask(componentTypeIndex));
+
+    if (entity == 0 || (GetEntityComponentsBitMask(entity) & componentMask) == 0) {
+      return GRK_SoAReference<ComponentType>(nullptr, 0);
+    }
+
+    auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    const auto instance = GetEntityIndex<ComponentType>().at(entity);
+    storeVersions_[componentTypeIndex]++;
+    return store[instance];
+  }
+
+  /**
+   * @brief Get the component of an entity that is known to have it, without checking its mask
+   *
+   * @details
+   * For loops over a @link GRK_EntityQuery GRK_EntityQuery @endlink whose signature already
+   * includes ComponentType, such as the ones in @link GRK_SystemPipeline__
+   * GRK_SystemPipeline__ @endlink.  Calling this for an entity without the component is
+   * undefined.
+   *
+   * @returns a reference to the component, or a @link GRK_SoAReference__ GRK_SoAReference
+   * @endlink for struct of arrays components*/
+  template<class ComponentType>
+  auto GetQueriedComponent(GRK_Entity entity) -> decltype(auto) {
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    const auto instance = GetEntityIndex<ComponentType>().at(entity);
+    storeVersions_[componentTypeIndex]++;
+    return store[instance];
+  }
+
+  /**
+   * @brief Get one field of every component of a struct of arrays type as a contiguous array
+   *
+   * @details
+   * This is what systems that only care about one field and vector kernels iterate over.  The
+   * order matches @link GRK_EntityComponentManager__::GetComponentStore GetComponentStore
+   * @endlink and it is invalidated by adding or removing components of the same type.
+   *
+   * @tparam ComponentType the struct of arrays component type
+   * @tparam Member pointer to the field, eg &GRK_MyComponent::position_*/
+  template<class ComponentType, auto Member>
+  auto GetComponentColumn() -> notstd::span<typename GRK_SoAComponentStore<ComponentType>::template FieldType<Member>> {
+    static_assert(GRK_UseSoALayout<ComponentType>::value,
+                  "GetComponentColumn is only for struct of arrays components");
+    storeVersions_[GetComponentTypeAccessIndex<ComponentType>()]++;
+    return std::get<GRK_ComponentStore<ComponentType>>(componentStores_).template Column<Member>();
+  }
+
+  /**
+   * @brief Rebuild the hot record of a hot/cold split component after modifying it
+   *
+   * @details
+   * see @link GRK_HotColdComponentStore GRK_HotColdComponentStore @endlink, the hot record is
+   * copied out of the component when it is added so changes made through a handle are not seen
+   * by loops over the hot records until this is called
+   *
+   * @param[in] entity the entity whose component changed
+   *
+   * @tparam ComponentType a component type with a @link GRK_HotRecordOf GRK_HotRecordOf @endlink
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink*/
+  template<class ComponentType>
+  auto RefreshHotRecord(GRK_Entity entity) -> GRK_Result {
+    static_assert(!std::is_void<typename GRK_HotRecordOf<ComponentType>::type>::value,
+                  "RefreshHotRecord is only for components with a GRK_HotRecordOf");
+
+    const auto& entityInstanceMap = GetEntityIndex<ComponentType>();
+    if (entity == 0 || !entityInstanceMap.contains(entity)) {
+      return GRK_Result::NoSuchElement;
     }
+
+    std::get<GRK_ComponentStore<ComponentType>>(componentStores_).RefreshHotRecord(entityInstanceMap.at(entity));
+    storeVersions_[GetComponentTypeAccessIndex<ComponentType>()]++;
+    return GRK_Result::Ok;
   }
 
   /**
@@ -309,8 +508,15 @@ class GRK_EntityComponentManager__ {
    *
    * @tparam ComponentType the type of component store vector you'd like to get a refernce of*/
   template<class ComponentType>
-  auto GetComponentStore() const -> const std::vector<ComponentType>* {
-    return &std::get<std::vector<ComponentType>>(componentStores_);
+  auto GetComponentStore() const -> const GRK_ComponentStore<ComponentType>* {
+    return &std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+  }
+
+  /**Changes whenever a component of ComponentType is added, removed or moved to another index
+   * of its store, so anything mirroring the store by index has to be rebuilt*/
+  template<class ComponentType>
+  auto GetStoreLayoutVersion() const -> std::uint64_t {
+    return storeLayoutVersions_[GetComponentTypeAccessIndex<ComponentType>()];
   }
 
   /**
@@ -353,174 +559,2235 @@ class GRK_EntityComponentManager__ {
     }
   }
 
-  // Garbage collects deleted entities (this is Components are always directly deleted as of now)
-  auto GarbageCollect() -> void {
-    //TODO dont always do this lets be smarter
-    garbage_collect_iter();
-  }
+  /**
+   * @brief Disables or re-enables an entity without adding or removing anything
+   *
+   * @details
+   * A disabled entity keeps all of its components, but it drops out of every system and query
+   * (it gets @link kDisabledEntityMask kDisabledEntityMask @endlink in its mask) and each of its
+   * components is swapped to the tail of its store, past @link
+   * GRK_EntityComponentManager__::GetActiveComponentCount GetActiveComponentCount @endlink,
+   * so loops over the enabled part of a store never touch it.  Both directions cost one swap per
+   * component type the entity has.  Runtime registered components are not moved.
+   *
+   * @param[in] entity the entity to change
+   * @param[in] enabled false to disable, true to enable again
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink also if it already was in that state
+   * @link GRK_Result::EntityAlreadyDeleted EntityAlreadyDeleted @endlink
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink*/
+  auto SetEntityEnabled(GRK_Entity entity, bool enabled) -> GRK_Result {
+    if (entity == 0) {
+      return GRK_Result::EntityAlreadyDeleted;
+    }
 
- private:
-  /**This function does most of the nitty gritty work of @link
-   * GRK_EntityComponentManager__::RemoveComponent RemoveComponent but is broken out
-   * for convenience and reuse in other scenarios such as GarbageCollection*/
-  template<class ComponentType>
-  auto RemoveComponentHelper(GRK_Entity entity) -> GRK_Result {
-    static_assert(notstd::param_pack_has_type<ComponentType, ComponentTypes...>::value,
-                  "RemoveComponentHelper Function requires ComponentType be one of the template params of GRK_EntityComponentManager__");
+    const auto maskIt = entityComponentsBitMaskMap_.find(entity);
+    if (maskIt == entityComponentsBitMaskMap_.end() || maskIt->second == 0) {
+      return GRK_Result::NoSuchEntity;
+    }
 
-    const auto componentAccessIndex = GetComponentTypeAccessIndex<ComponentType>();
-    //this is a vector of the type we are trying to remove
-    auto& componentTypeVector = std::get<std::vector<ComponentType>>(componentStores_);
+    const auto mask = maskIt->second;
+    if (((mask & kDisabledEntityMask) == 0) == enabled) {
+      return GRK_Result::Ok;
+    }
 
-    //this is the map of entity to components for this type
-    auto& entityInstanceMap = entityComponentIndexMaps_.at(componentAccessIndex);
+    (MoveAcrossActivePartition<ComponentTypes>(entity, mask, enabled), ...);
 
-    //check if the elment is in the map
-    //and do what we need to if it is not
-    if (entityInstanceMap.find(entity) == entityInstanceMap.end()) {
-      return GRK_Result::NoSuchElement;
-    } else {
-      //this entity exists so we move the last element of the components vector
-      //to the spot that this one was taking up
+    SetEntityComponentsBitMask(entity, enabled ? mask & ~kDisabledEntityMask : mask | kDisabledEntityMask);
 
-      // Index of element we are removing
-      const auto removeIndex = entityInstanceMap.at(entity);
+    //systems skip disabled entities
+    UpdateSystemEntities(entity);
 
-      // Instance of element we are moving
-      auto lastElementEntity = entityInstanceMap.reverse_at(componentTypeVector.size() - 1);
+    return GRK_Result::Ok;
+  }
 
-      // if element is not last then we move last into this one's place
-      if (lastElementEntity != entity) {
-        // Element we are moving into it's old place
-        auto& lastElement = componentTypeVector.back();
+  /**
+   * @brief The number of components at the front of ComponentType's store that belong to
+   * enabled entities
+   *
+   * @details
+   * Components of disabled entities are kept in [GetActiveComponentCount, size()) so loops that
+   * should skip them stop here*/
+  template<class ComponentType>
+  auto GetActiveComponentCount() const -> std::size_t {
+    return activeCounts_[GetComponentTypeAccessIndex<ComponentType>()];
+  }
+
+  /**
+   * @brief Reorders a component store by a user supplied key
+   *
+   * @details
+   * Swap removal moves the last component into every hole, so over time the order of a store has
+   * nothing to do with which entities are near each other.  This sorts the store (stable, in
+   * ascending key order) and fixes up the entity to index map as it goes, so loops that walk the
+   * store touch related components together.  Useful keys are @link GRK_MortonKey
+   * GRK_MortonKey @endlink of the position for spatial passes, or the parent entity for
+   * hierarchy passes.
+   *
+   * The components of enabled and disabled entities are sorted separately so the disabled ones
+   * stay at the tail.  Every component is moved at most once, but this still touches the whole store so it is
+   * meant for load time or after big changes, see @link
+   * GRK_EntityComponentManager__::SortComponentStoreIncremental SortComponentStoreIncremental
+   * @endlink for spreading the work over frames.  Like removal it invalidates handles and
+   * pointers into the store.
+   *
+   * @param[in] key called with (GRK_Entity, component) or just (component) for each component,
+   * returns anything with operator<.  For struct of arrays components the component is a const
+   * @link GRK_SoAReference__ GRK_SoAReference__ @endlink
+   *
+   * @tparam ComponentType the store to sort*/
+  template<class ComponentType, class KeyFunction>
+  auto SortComponentStore(KeyFunction&& key) -> void {
+    const auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    const auto size = store.size();
+    using Key = decltype(ComponentSortKey<ComponentType>(key, 0));
+
+    std::vector<std::pair<Key, std::size_t>> keyedIndices;
+    keyedIndices.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+      keyedIndices.emplace_back(ComponentSortKey<ComponentType>(key, i), i);
+    }
 
-        //use std::move so we cannibilize any allocated components and dont copy them
-        componentTypeVector[removeIndex] = std::move(lastElement);
+    // Enabled entities' components stay ahead of the disabled ones, each part is sorted alone.
+    const auto activeCount = activeCounts_[GetComponentTypeAccessIndex<ComponentType>()];
+    std::stable_sort(
+        keyedIndices.begin(),
+        keyedIndices.end(),
+        [activeCount](const auto& lhs, const auto& rhs) {
+          const auto lhsDisabled = lhs.second >= activeCount;
+          const auto rhsDisabled = rhs.second >= activeCount;
+          return lhsDisabled != rhsDisabled ? rhsDisabled : lhs.first < rhs.first;
+        });
+
+    // Walk the sorted order swapping each component into its slot, positionOf and componentAt
+    // track where the components that were at each original index are now.
+    std::vector<std::size_t> positionOf(size);
+    std::vector<std::size_t> componentAt(size);
+    std::iota(positionOf.begin(), positionOf.end(), 0);
+    std::iota(componentAt.begin(), componentAt.end(), 0);
+
+    for (std::size_t i = 0; i < size; i++) {
+      const auto wanted = keyedIndices[i].second;
+      const auto current = positionOf[wanted];
+      if (current != i) {
+        SwapComponentsInStore<ComponentType>(i, current);
+
+        const auto displaced = componentAt[i];
+        componentAt[current] = displaced;
+        positionOf[displaced] = current;
+        componentAt[i] = wanted;
+        positionOf[wanted] = i;
       }
+    }
 
-      //then remove it from the map
-      //and shorten our vector
-      entityInstanceMap.erase(entity);
-      componentTypeVector.pop_back();
+    sortCursors_[GetComponentTypeAccessIndex<ComponentType>()] = 0;
+  }
 
-      // If there is nothing in componentTypeVector we just erased the last element, so no need to update map
-      if (componentTypeVector.size() > 0) {
-        entityInstanceMap.reverse_erase(componentTypeVector.size());
-        entityInstanceMap.put(lastElementEntity, removeIndex);
+  /**
+   * @brief Does a bounded amount of work towards sorting a component store by key
+   *
+   * @details
+   * An odd-even style pass that compares neighbouring components and swaps them if they are out
+   * of order, picking up where the last call for ComponentType stopped and wrapping around at
+   * the end of the store.  Call it every frame with a small budget to keep a store that changes
+   * slowly (a few swap removals and moving entities) close to sorted without ever paying for a
+   * whole sort in one frame.  A badly scrambled store takes many passes to converge, use @link
+   * GRK_EntityComponentManager__::SortComponentStore SortComponentStore @endlink for that.
+   *
+   * @param[in] key see @link GRK_EntityComponentManager__::SortComponentStore
+   * SortComponentStore @endlink
+   * @param[in] maxComparisons the number of neighbouring pairs to look at in this call
+   *
+   * @tparam ComponentType the store to sort
+   *
+   * @returns the number of swaps made, 0 over a whole pass means the store is sorted*/
+  template<class ComponentType, class KeyFunction>
+  auto SortComponentStoreIncremental(KeyFunction&& key, std::size_t maxComparisons) -> std::size_t {
+    const auto size = std::get<GRK_ComponentStore<ComponentType>>(componentStores_).size();
+    const auto activeCount = activeCounts_[GetComponentTypeAccessIndex<ComponentType>()];
+    auto& cursor = sortCursors_[GetComponentTypeAccessIndex<ComponentType>()];
+    std::size_t swaps = 0;
+
+    if (size < 2) {
+      return swaps;
+    }
+
+    for (std::size_t comparison = 0; comparison < maxComparisons; comparison++) {
+      if (cursor + 1 >= size) {
+        cursor = 0;
       }
 
-      //remove it from bitmask
-      entityComponentsBitMaskMap_[entity] &= ~(IndexToMask(componentAccessIndex));
+      // Never swap across the boundary between enabled and disabled entities' components.
+      if (cursor + 1 != activeCount &&
+          ComponentSortKey<ComponentType>(key, cursor + 1) < ComponentSortKey<ComponentType>(key, cursor)) {
+        SwapComponentsInStore<ComponentType>(cursor, cursor + 1);
+        swaps++;
+      }
 
-      return GRK_Result::Ok;
+      cursor++;
     }
+
+    return swaps;
   }
 
- private:
-  /** @fn
-   * @brief Meta function which sets up component store vectors stored in the
-   * @link GRK_EntityComponentManager__::componentStores_ componentStores_ tuple
-   * @endlink
+  /**
+   * @brief Orders a component store like another one so that components of the same entities
+   * are at matching positions
    *
    * @details
-   * This is done by going through each index in the tuple and reserving some space in the
-   * vectors to prevent long load times later and initializing the map of entities to indexes in
-   * the stores
+   * After sorting the leader (eg the transforms by @link GRK_MortonKey GRK_MortonKey @endlink)
+   * call this for the types that are iterated alongside it so walking both stores stays
+   * coherent.  Entities without a LeaderComponentType go at the end.
    *
-   * @tparam index the index in the tuple to intialize
-   * @tparam Ts variadic list of types that are the types in the tuple to be initialized*/
-  template<int index, class... Ts>
-  struct setup_component_stores_impl {
-    /**
-     * the applictive operator for the meta function
-     *
-     * @param ecm refernce to this
-     * @param t the tuple member of ecm being initialized*/
-    auto operator()(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {
-      auto& elem = std::get<index>(t);
-      elem.reserve(c_initial_entity_array_size);
-      ecm.entityComponentIndexMaps_.push_back(
-          notstd::unordered_bidir_map<GRK_Entity, ComponentInstance>(c_initial_entity_array_size));
-      setup_component_stores_impl<index - 1, Ts...>{}(ecm, t);
-    }
-  };
-
-  /**@overload*/
-  template<class... Ts>
-  struct setup_component_stores_impl<-1, Ts...> {
-    auto operator()(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {}
-  };
+   * @tparam ComponentType the store to reorder
+   * @tparam LeaderComponentType the store whose order is copied*/
+  template<class ComponentType, class LeaderComponentType>
+  auto MatchComponentStoreOrder() -> void {
+    const auto& leaderInstanceMap = GetEntityIndex<LeaderComponentType>();
+
+    // Entities without a leader component get kNoComponentInstance, which sorts last.
+    SortComponentStore<ComponentType>(
+        [&leaderInstanceMap](GRK_Entity entity, const auto&) { return leaderInstanceMap.at(entity); });
+  }
 
-  /**Meta convenience function to call the setup_component_stores meta function
+  /**
+   * @brief Registers a new component type at runtime
    *
-   * @param ecm this class
-   * @param t the tuple that is being iterated through and set up
+   * @details
+   * Compile time component types (the ComponentTypes pack) are stored in typed stores and every
+   * function using them is instantiated for them.  Runtime components instead live in a @link
+   * GRK_RuntimeComponentStore GRK_RuntimeComponentStore @endlink that only knows the type
+   * through the size, alignment and functions in info, so a game module can add its own
+   * components without recompiling the engine or growing every template instantiation.
    *
-   * @tparam Ts deduced from the tuple that is passed to this function*/
-  template<class... Ts>
-  auto setup_component_stores(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {
-    const auto size = sizeof...(Ts);
-    setup_component_stores_impl<size - 1, Ts...>{}(ecm, t);
+   * Runtime components get the bits after the compile time components in the @link
+   * GRK_ComponentBitMask GRK_ComponentBitMask @endlink (see @link
+   * GRK_EntityComponentManager__::GetRuntimeComponentMask GetRuntimeComponentMask @endlink) so
+   * systems can require them like any other component.
+   *
+   * @param[in] info the layout and function table of the type, see @link
+   * GRK_MakeRuntimeComponentInfo GRK_MakeRuntimeComponentInfo @endlink
+   * @param[out] id the id to use with the other runtime component functions
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSpaceRemaining NoSpaceRemaining @endlink if every bit of the mask is
+   * taken
+   * @link GRK_Result::InvalidArgument InvalidArgument @endlink if the alignment is not a power of
+   * two or the capacity policy is not @link GRK_IsValidCapacityPolicy valid @endlink*/
+  auto RegisterRuntimeComponent(GRK_RuntimeComponentInfo info, GRK_RuntimeComponentID& id) -> GRK_Result {
+    if (info.alignment == 0 || (info.alignment & (info.alignment - 1)) != 0 ||
+        !GRK_IsValidCapacityPolicy(info.capacityPolicy)) {
+      return GRK_Result::InvalidArgument;
+    }
+
+    if (sizeof...(ComponentTypes) + runtimeComponentStores_.size() >= kMaxComponentTypes) {
+      return GRK_Result::NoSpaceRemaining;
+    }
+
+    id = runtimeComponentStores_.size();
+    const auto minimumCapacity = info.capacityPolicy.minimumCapacity;
+    runtimeComponentStores_.push_back(std::make_unique<GRK_RuntimeComponentStore>(std::move(info)));
+    runtimeComponentStores_.back()->Reserve(minimumCapacity);
+    runtimeUnderusedCollections_.push_back(0);
+
+    return GRK_Result::Ok;
   }
 
-  /** @fn
-   * @brief Meta function for garbage collection iteration
+  /**@overload
+   * @tparam ComponentType the C++ type to register, the function table is generated for it*/
+  template<class ComponentType>
+  auto RegisterRuntimeComponent(std::string name, GRK_RuntimeComponentID& id) -> GRK_Result {
+    return RegisterRuntimeComponent(GRK_MakeRuntimeComponentInfo<ComponentType>(std::move(name)), id);
+  }
+
+  /**The bit representing the runtime component id in an entity's @link GRK_ComponentBitMask
+   * GRK_ComponentBitMask @endlink*/
+  static constexpr auto GetRuntimeComponentMask(GRK_RuntimeComponentID id) -> GRK_ComponentBitMask {
+    return IndexToMask(sizeof...(ComponentTypes) + id);
+  }
+
+  /**
+   * @brief Adds a runtime registered component to an entity
    *
    * @details
-   * This function iterates through each of the types of Components and checks if that
-   * component type is contained in a deleted entity that is being garbage collected, if so it
-   * runs the @link GRK_EntityComponentManager__::RemoveComponentHelper
-   * RemoveComponentHelper @endlink function on it
+   * works like @link GRK_EntityComponentManager__::AddComponent AddComponent @endlink, the
+   * component at component is moved from (it still needs to be destroyed by the caller)
    *
-   * @tparam ComponentIndex the index in Ts we are checking for removal
-   * @tparam Ts ComponentTypes passed to the meta function
-   * */
-  template<int ComponentIndex, class... Ts>
-  struct garbage_collect_iter_impl {
-    /** The applicitive operator of the meta function*/
-    auto operator()(GRK_EntityComponentManager__& ecm) -> void {
-      for (auto& entity : ecm.deletedUncleanedEntities_) {
-        using ComponentType = typename notstd::index_to_type<ComponentIndex, Ts...>::type;
-        if ((ecm.entityComponentsBitMaskMap_[entity] & IndexToMask(ComponentIndex)) > 0) {
-          ecm.template RemoveComponentHelper<ComponentType>(entity);
-        }
-      }
+   * @param[in] entity the entity to add to
+   * @param[in] id the registered type of component
+   * @param[in] component pointer to the component to move into the store
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::EntityAlreadyDeleted EntityAlreadyDeleted @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink if id is not registered
+   * @link GRK_Result::ComponentAlreadyAdded ComponentAlreadyAdded @endlink*/
+  auto AddRuntimeComponent(GRK_Entity entity, GRK_RuntimeComponentID id, void* component) -> GRK_Result {
+    if (entity == 0) {
+      return GRK_Result::EntityAlreadyDeleted;
+    }
 
-      garbage_collect_iter_impl<ComponentIndex - 1, Ts...>{}(ecm);
+    if (id >= runtimeComponentStores_.size()) {
+      return GRK_Result::NoSuchElement;
     }
-  };
 
-  /**@overload*/
-  template<class... Ts>
-  struct garbage_collect_iter_impl<-1, Ts...> {
-    auto operator()(GRK_EntityComponentManager__& ecm) -> void {}
-  };
+    const auto result = runtimeComponentStores_[id]->Add(entity, component);
+    if (result != GRK_Result::Ok) {
+      return result;
+    }
 
-  /**Meta convenience function to call the garbage_collect_iter_impl meta function*/
-  auto garbage_collect_iter() -> void {
-    const auto size = sizeof...(ComponentTypes);
-    garbage_collect_iter_impl<size - 1, ComponentTypes...>{}(*this);
-    deletedUncleanedEntities_.clear();
+    SetEntityComponentsBitMask(entity, entityComponentsBitMaskMap_[entity] | GetRuntimeComponentMask(id));
+
+    //inform all systems of new component added to this entity
+    UpdateSystemEntities(entity);
+
+    return GRK_Result::Ok;
   }
 
- private:
-  /// The tuple of vectors which store each component type.
-  ComponentStoreTuple componentStores_;
+  /**@overload*/
+  template<class ComponentType>
+  auto AddRuntimeComponent(GRK_Entity entity, GRK_RuntimeComponentID id, ComponentType&& component) -> GRK_Result {
+    return AddRuntimeComponent(entity, id, static_cast<void*>(&component));
+  }
 
-  /// The next entity ID that is incremened each time an entity is made.
-  GRK_Entity nextEntityId_;
+  /**
+   * @brief Get a runtime registered component of an entity
+   *
+   * @returns a pointer to the component, nullptr if the entity does not have one.  Like any
+   * pointer into a store it is invalidated by adding or removing components of the same type*/
+  auto GetRuntimeComponent(GRK_Entity entity, GRK_RuntimeComponentID id) -> void* {
+    if (entity == 0 || id >= runtimeComponentStores_.size()) {
+      return nullptr;
+    }
 
-  /// List of deleted entites that need to be Garbage Collected.
-  std::vector<GRK_Entity> deletedUncleanedEntities_;
+    return runtimeComponentStores_[id]->Get(entity);
+  }
 
-  /// Index into vector for component.
-  typedef size_t ComponentInstance;
+  /**@overload
+   * @tparam ComponentType the type that was registered as id*/
+  template<class ComponentType>
+  auto GetRuntimeComponent(GRK_Entity entity, GRK_RuntimeComponentID id) -> ComponentType* {
+    return static_cast<ComponentType*>(GetRuntimeComponent(entity, id));
+  }
 
-  ///this is a map of entities to a bitmask of their components, used for system registration/component deletion checks etc
-  std::unordered_map<GRK_Entity, GRK_ComponentBitMask> entityComponentsBitMaskMap_;
+  /**
+   * @brief remove a runtime registered component from an entity
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::EntityAlreadyDeleted EntityAlreadyDeleted @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink*/
+  auto RemoveRuntimeComponent(GRK_Entity entity, GRK_RuntimeComponentID id) -> GRK_Result {
+    if (entity == 0) {
+      return GRK_Result::EntityAlreadyDeleted;
+    }
+
+    if (id >= runtimeComponentStores_.size()) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    const auto result = runtimeComponentStores_[id]->Remove(entity);
+    if (result == GRK_Result::Ok) {
+      SetEntityComponentsBitMask(entity, entityComponentsBitMaskMap_[entity] & ~GetRuntimeComponentMask(id));
+    }
+
+    return result;
+  }
+
+  /**The whole store of a runtime registered component type for iterating, nullptr if id is
+   * not registered*/
+  auto GetRuntimeComponentStore(GRK_RuntimeComponentID id) const -> const GRK_RuntimeComponentStore* {
+    return id < runtimeComponentStores_.size() ? runtimeComponentStores_[id].get() : nullptr;
+  }
+
+  /**
+   * @brief Get the cached query of every entity that has all the components in include and none
+   * of the ones in exclude
+   *
+   * @details
+   * The first call for a signature scans every entity once, after that the manager keeps the
+   * query up to date as components are added and removed (and entities are garbage collected)
+   * so reading it never rescans anything.  Every caller asking for the same signature shares one
+   * @link GRK_EntityQuery GRK_EntityQuery @endlink, which lives as long as this manager.
+   *
+   * Runtime registered components can be used with @link
+   * GRK_EntityComponentManager__::GetRuntimeComponentMask GetRuntimeComponentMask @endlink.
+   *
+   * @param[in] include mask of the required components
+   * @param[in] exclude mask of the components a matched entity must not have
+   *
+   * @returns the query, never nullptr*/
+  auto GetQuery(GRK_ComponentBitMask include, GRK_ComponentBitMask exclude = 0) -> const GRK_EntityQuery* {
+    const GRK_QuerySignature signature{include, exclude};
+
+    auto queryIt = queries_.find(signature);
+    if (queryIt != queries_.end()) {
+      return queryIt->second.get();
+    }
+
+    auto query = std::make_unique<GRK_EntityQuery>(signature);
+    for (const auto& entityMask : entityComponentsBitMaskMap_) {
+      query->OnEntityMaskChanged(entityMask.first, 0, entityMask.second);
+    }
+
+    return queries_.emplace(signature, std::move(query)).first->second.get();
+  }
+
+  /**@overload
+   * @tparam IncludedComponentTypes the components a matched entity must have*/
+  template<class... IncludedComponentTypes>
+  auto GetQuery() -> const GRK_EntityQuery* {
+    return GetQuery((IndexToMask(GetComponentTypeAccessIndex<IncludedComponentTypes>()) | ... | 0u));
+  }
+
+  /**
+   * @brief The entity whose @link GRK_NameComponent GRK_NameComponent @endlink is name
+   *
+   * @details
+   * Never allocates.  A deleted entity can still be found by its name until it is garbage
+   * collected.
+   *
+   * @returns the entity, 0 if no entity has the name*/
+  auto FindEntityByName(GRK_Symbol name) const -> GRK_Entity {
+    return nameIndex_.Find(name);
+  }
+
+  /**@overload
+   * @details Looks the string up in the @link GRK_SymbolTable::Global global symbol table
+   * @endlink without interning it*/
+  auto FindEntityByName(std::string_view name) const -> GRK_Entity {
+    return nameIndex_.Find(GRK_SymbolTable::Global().Find(name));
+  }
+
+  /**
+   * @brief Makes entity a member of cell, moving it out of the cell it was in
+   *
+   * @details
+   * Cell members are streamed out with @link GRK_EntityComponentManager__::UnloadCell
+   * UnloadCell @endlink and saved with @link GRK_EntityComponentManager__::SaveCell SaveCell
+   * @endlink.  Pass @link kNoCell kNoCell @endlink to stop streaming the entity.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::EntityAlreadyDeleted EntityAlreadyDeleted @endlink
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink*/
+  auto SetEntityCell(GRK_Entity entity, GRK_CellID cell) -> GRK_Result {
+    if (entity == 0) {
+      return GRK_Result::EntityAlreadyDeleted;
+    }
+
+    const auto maskIt = entityComponentsBitMaskMap_.find(entity);
+    if (maskIt == entityComponentsBitMaskMap_.end() || maskIt->second == 0) {
+      return GRK_Result::NoSuchEntity;
+    }
+
+    ForgetEntityCell(entity);
+    if (cell != kNoCell) {
+      auto& members = cellEntities_[cell];
+      entityCells_[entity] = CellMembership{cell, members.size()};
+      members.push_back(entity);
+    }
+    spatialIndex_.MarkBoundsChanged(entity);
+
+    return GRK_Result::Ok;
+  }
+
+  /**The cell entity is a member of, kNoCell if none*/
+  auto GetEntityCell(GRK_Entity entity) const -> GRK_CellID {
+    const auto membershipIt = entityCells_.find(entity);
+    return membershipIt == entityCells_.end() ? kNoCell : membershipIt->second.cell;
+  }
+
+  /**The members of cell, in no particular order*/
+  auto GetCellEntities(GRK_CellID cell) const -> const std::vector<GRK_Entity>& {
+    static const std::vector<GRK_Entity> noEntities;
+    const auto cellIt = cellEntities_.find(cell);
+    return cellIt == cellEntities_.end() ? noEntities : cellIt->second;
+  }
+
+  /**
+   * @brief Anchors the transforms of cell's members at a double precision origin
+   *
+   * @details
+   * The world positions of a cell's member transforms are relative to its origin, so with
+   * single precision transform storage (see @link GRK_TransformScalar GRK_TransformScalar
+   * @endlink) a cell's members stay precise no matter how far from the scene origin the cell is.
+   * The origin is saved with the cell and dropped when it is unloaded.  Cells start at the scene
+   * origin.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink for kNoCell*/
+  auto SetCellOrigin(GRK_CellID cell, glm::dvec3 origin) -> GRK_Result {
+    if (cell == kNoCell) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    cellOrigins_[cell] = origin;
+    for (const auto entity : GetCellEntities(cell)) {
+      spatialIndex_.MarkBoundsChanged(entity);
+    }
+    return GRK_Result::Ok;
+  }
+
+  /**The origin of cell, the scene origin if it has none*/
+  auto GetCellOrigin(GRK_CellID cell) const -> glm::dvec3 {
+    const auto originIt = cellOrigins_.find(cell);
+    return originIt == cellOrigins_.end() ? glm::dvec3(0) : originIt->second;
+  }
+
+  /**
+   * @brief Deletes every member of cell and all of their components right away
+   *
+   * @details
+   * Unlike calling @link GRK_EntityComponentManager__::DeleteEntity DeleteEntity @endlink on
+   * each of them the systems are told about all of them in one call, and the components are
+   * removed by the garbage collection pass, one store per worker thread when there are enough of
+   * them.  Like garbage collection this invalidates iteration over any store or query.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink if the cell has no members*/
+  auto UnloadCell(GRK_CellID cell) -> GRK_Result {
+    auto cellIt = cellEntities_.find(cell);
+    if (cell == kNoCell || cellIt == cellEntities_.end()) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    // Drop the whole cell first so collecting its members does not update it one by one.
+    const auto members = std::move(cellIt->second);
+    cellEntities_.erase(cellIt);
+    cellOrigins_.erase(cell);
+
+    UnregisterFromSystems(members);
+
+    deletedUncleanedEntities_.insert(deletedUncleanedEntities_.end(), members.begin(), members.end());
+    garbage_collect_iter();
+
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Serializes the members of cell and their components into blob
+   *
+   * @details
+   * Only components with a @link GRK_CellSerializer GRK_CellSerializer @endlink are saved,
+   * entities waiting to be garbage collected are left out.  The layout is described by @link
+   * GRK_CellBlobHeader GRK_CellBlobHeader @endlink.
+   *
+   * @param[in] cell the cell to save
+   * @param[out] blob replaced with the serialized cell
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink if the cell has no members*/
+  auto SaveCell(GRK_CellID cell, std::vector<std::byte>& blob) const -> GRK_Result {
+    const auto cellIt = cellEntities_.find(cell);
+    if (cell == kNoCell || cellIt == cellEntities_.end()) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    std::vector<GRK_Entity> entities;
+    entities.reserve(cellIt->second.size());
+    for (const auto entity : cellIt->second) {
+      const auto isDeleted = std::find(deletedUncleanedEntities_.begin(), deletedUncleanedEntities_.end(), entity)
+          != deletedUncleanedEntities_.end();
+      if (!isDeleted) {
+        entities.push_back(entity);
+      }
+    }
+
+    std::vector<std::uint32_t> flags(entities.size());
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      const auto mask = entityComponentsBitMaskMap_.at(entities[ordinal]);
+      flags[ordinal] = (mask & kDisabledEntityMask) != 0 ? CellEntityDisabled : 0u;
+    }
+
+    std::unordered_map<GRK_Entity, std::uint64_t> ordinalOf;
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      ordinalOf[entities[ordinal]] = ordinal;
+    }
+    std::vector<GRK_CellBlobParentLink> links(entities.size(), GRK_CellBlobParentLink{kNoCellParent, 0});
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      auto* transform = transformHierarchy_.GetTransform(entities[ordinal]);
+      const auto parentIt = transform == nullptr ? ordinalOf.end() : ordinalOf.find(transform->GetParentEntity());
+      if (parentIt != ordinalOf.end()) {
+        links[ordinal] = GRK_CellBlobParentLink{parentIt->second, transform->GetSiblingIndex()};
+      }
+    }
+
+    blob.clear();
+    const auto origin = GetCellOrigin(cell);
+    GRK_CellBlobHeader header{kCellBlobMagic, kCellBlobVersion, cell, entities.size(), 0, 0, {origin.x, origin.y, origin.z}};
+    GRK_AppendToCellBlob(blob, &header, sizeof(header));
+    GRK_AppendToCellBlob(blob, flags.data(), flags.size() * sizeof(std::uint32_t));
+    GRK_AppendToCellBlob(blob, links.data(), links.size() * sizeof(GRK_CellBlobParentLink));
+
+    (SaveCellSection<ComponentTypes>(entities, blob, header.sectionCount), ...);
+
+    // The section count is only known now.
+    std::memcpy(blob.data(), &header, sizeof(header));
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Creates the entities and components of a blob made by @link
+   * GRK_EntityComponentManager__::SaveCell SaveCell @endlink
+   *
+   * @details
+   * The whole blob is checked before anything is created.  The entities get new ids and are
+   * made members of the blob's cell.  Each component type is appended to its store in one go (a
+   * single memcpy for trivially copyable components in vector stores), then the transforms are
+   * linked back to their parents in the cell, and queries and systems are told about each
+   * entity once after all of its components are in.
+   *
+   * The blob is only read, so it can point straight into a memory mapped file.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::MalformedData MalformedData @endlink
+   * @link GRK_Result::CellAlreadyLoaded CellAlreadyLoaded @endlink*/
+  auto LoadCell(notstd::span<const std::byte> blob) -> GRK_Result {
+    GRK_CellBlobHeader header{};
+    std::vector<GRK_ComponentBitMask> masks;
+    std::vector<GRK_CellBlobParentLink> links;
+    if (!ValidateCellBlob(blob, header, masks, links)) {
+      return GRK_Result::MalformedData;
+    }
+
+    if (header.cell == kNoCell || !GetCellEntities(header.cell).empty()) {
+      return GRK_Result::CellAlreadyLoaded;
+    }
+
+    const auto origin = glm::dvec3(header.origin[0], header.origin[1], header.origin[2]);
+    if (origin != glm::dvec3(0)) {
+      cellOrigins_[header.cell] = origin;
+    }
+
+    // Entities start without components, each gets its final mask once at the end.
+    std::vector<GRK_Entity> entities(header.entityCount);
+    auto& members = cellEntities_[header.cell];
+    members.reserve(entities.size());
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      entities[ordinal] = nextEntityId_++;
+      entityComponentsBitMaskMap_[entities[ordinal]] = 0;
+      entityCells_[entities[ordinal]] = CellMembership{header.cell, members.size()};
+      members.push_back(entities[ordinal]);
+    }
+
+    auto offset = GRK_CellBlobPadded(sizeof(GRK_CellBlobHeader)) +
+        GRK_CellBlobPadded(entities.size() * sizeof(std::uint32_t)) +
+        GRK_CellBlobPadded(entities.size() * sizeof(GRK_CellBlobParentLink));
+    for (std::uint32_t i = 0; i < header.sectionCount; i++) {
+      GRK_CellBlobSection section{};
+      std::memcpy(&section, blob.data() + offset, sizeof(section));
+
+      const auto* ordinals = blob.data() + offset + GRK_CellBlobPadded(sizeof(section));
+      const auto* payload = ordinals + GRK_CellBlobPadded(section.count * sizeof(std::uint64_t));
+      (LoadCellSection<ComponentTypes>(section, ordinals, payload, entities, masks), ...);
+
+      offset = static_cast<std::size_t>(payload - blob.data()) + GRK_CellBlobPadded(section.count * section.elementSize);
+    }
+
+    // Every transform is in now, children are appended to their parents in their saved order.
+    std::vector<std::size_t> children;
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      if (links[ordinal].parent != kNoCellParent) {
+        children.push_back(ordinal);
+      }
+    }
+    std::stable_sort(children.begin(), children.end(), [&links](std::size_t a, std::size_t b) {
+      return links[a].siblingIndex < links[b].siblingIndex;
+    });
+    for (const auto ordinal : children) {
+      transformHierarchy_.GetTransform(entities[ordinal])->SetParent(
+          transformHierarchy_.GetTransform(entities[links[ordinal].parent]));
+    }
+
+    for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+      SetEntityComponentsBitMask(entities[ordinal], masks[ordinal]);
+    }
+    UpdateSystemEntities(entities);
+
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Publishes a read only snapshot of the stores of SnapshotComponentTypes for other
+   * threads
+   *
+   * @details
+   * Call this on the main thread at a point where nothing is modifying the world, between
+   * system updates for instance.  Every store carries a version that is bumped by anything that
+   * can write to it (adding, removing, sorting, and handing out mutable access through @link
+   * GRK_EntityComponentManager__::GetComponent GetComponent @endlink and friends), so only the
+   * stores that changed since the last publish are copied.  The rest, and the entity masks if
+   * they did not change, are shared with the previous snapshot.
+   *
+   * The new snapshot replaces the old one atomically: readers that already hold the old one keep
+   * it as long as they like and never block this, and it is freed when the last of them releases
+   * it.  Runtime registered components are not captured.
+   *
+   * @tparam SnapshotComponentTypes the (copy constructible) component types to capture*/
+  template<class... SnapshotComponentTypes>
+  auto PublishSnapshot() -> void {
+    static_assert((std::is_copy_constructible<SnapshotComponentTypes>::value && ...),
+                  "Only copy constructible components can be captured in a snapshot");
+
+    const auto previous = std::atomic_load(&publishedSnapshot_);
+    auto snapshot = std::make_shared<WorldSnapshot>();
+
+    snapshot->sequence_ = previous == nullptr ? 1 : previous->sequence_ + 1;
+    snapshot->entityMasksVersion_ = entityMasksVersion_;
+    if (previous != nullptr && previous->entityMasksVersion_ == entityMasksVersion_) {
+      snapshot->entityMasks_ = previous->entityMasks_;
+    } else {
+      snapshot->entityMasks_ = std::make_shared<const typename WorldSnapshot::EntityMaskMap>(entityComponentsBitMaskMap_);
+    }
+
+    (SnapshotComponentStore<SnapshotComponentTypes>(*snapshot, previous.get()), ...);
+
+    std::atomic_store(&publishedSnapshot_, std::shared_ptr<const WorldSnapshot>(std::move(snapshot)));
+  }
+
+  /**
+   * @brief The most recently published snapshot, safe to call from any thread
+   *
+   * @returns the snapshot, nullptr if none was published yet.  It stays valid and unchanged for
+   * as long as the caller holds it*/
+  auto AcquireSnapshot() const -> std::shared_ptr<const WorldSnapshot> {
+    return std::atomic_load(&publishedSnapshot_);
+  }
+
+  /**
+   * @brief Replaces the @link GRK_CapacityPolicy GRK_CapacityPolicy @endlink of a component
+   * type, which starts out as @link GRK_ComponentCapacityPolicy GRK_ComponentCapacityPolicy
+   * @endlink
+   *
+   * @details
+   * The store is not resized right away, the new policy applies from the next time it grows or
+   * is considered for shrinking.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::InvalidArgument InvalidArgument @endlink if policy is not @link
+   * GRK_IsValidCapacityPolicy valid @endlink, the old policy is kept*/
+  template<class ComponentType>
+  auto SetCapacityPolicy(const GRK_CapacityPolicy& policy) -> GRK_Result {
+    if (!GRK_IsValidCapacityPolicy(policy)) {
+      return GRK_Result::InvalidArgument;
+    }
+
+    capacityPolicies_[GetComponentTypeAccessIndex<ComponentType>()] = policy;
+    return GRK_Result::Ok;
+  }
+
+  /**@overload
+   * @param[in] id the runtime registered component type
+   * @returns also @link GRK_Result::NoSuchElement NoSuchElement @endlink if id is not registered*/
+  auto SetCapacityPolicy(GRK_RuntimeComponentID id, const GRK_CapacityPolicy& policy) -> GRK_Result {
+    if (id >= runtimeComponentStores_.size()) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    if (!GRK_IsValidCapacityPolicy(policy)) {
+      return GRK_Result::InvalidArgument;
+    }
+
+    runtimeComponentStores_[id]->SetCapacityPolicy(policy);
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Reports the memory used and reserved by every component store and its entity to
+   * index lookup
+   *
+   * @details
+   * One entry per compile time component type in mask order followed by one per runtime
+   * registered type.  Component bytes are exact, lookup bytes are estimates of the hash map
+   * nodes and buckets.*/
+  auto GetMemoryReport() const -> std::vector<GRK_StoreMemoryReport> {
+    std::vector<GRK_StoreMemoryReport> reports;
+    reports.reserve(sizeof...(ComponentTypes) + runtimeComponentStores_.size());
+
+    (reports.push_back(ReportStoreMemory<ComponentTypes>()), ...);
+
+    for (std::size_t id = 0; id < runtimeComponentStores_.size(); id++) {
+      GRK_StoreMemoryReport report{};
+      report.componentTypeIndex = sizeof...(ComponentTypes) + id;
+      report.name = runtimeComponentStores_[id]->GetInfo().name;
+      runtimeComponentStores_[id]->ReportMemory(report);
+      reports.push_back(std::move(report));
+    }
+
+    return reports;
+  }
+
+  /**
+   * @brief Propagates local transform changes to the cached world transforms
+   *
+   * @details
+   * One sweep over the levels of the @link GRK_TransformHierarchy GRK_TransformHierarchy
+   * @endlink, roots first, so every dirty transform is recomputed once and its parent is always
+   * already up to date.  Levels with at least c_parallel_transform_level_threshold transforms are
+   * split across worker threads.  Static transforms queued for baking are baked first, into
+   * @link GRK_EntityComponentManager__::GetStaticTransforms GetStaticTransforms @endlink.  Every
+   * transform recomputed this tick, by the sweep, a bake or earlier,
+   * is listed in @link GRK_EntityComponentManager__::GetMovedEntities GetMovedEntities @endlink
+   * and the spatial index proxies of those with bounds are refit.  The engine runs this at the
+   * end of every tick, and each call ends a tick for @link
+   * GRK_TransformComponent::GetInterpolatedWorldMatrix GetInterpolatedWorldMatrix @endlink.*/
+  auto UpdateWorldTransforms() -> void {
+    movedEntities_.clear();
+    BakeStaticTransforms();
+
+    for (const auto& level : transformHierarchy_.GetLevels()) {
+      if (level.size() < c_parallel_transform_level_threshold) {
+        UpdateWorldTransformRange(level, 0, level.size(), movedEntities_);
+        continue;
+      }
+
+      //each chunk lists its moved entities separately and they are appended in chunk order
+      const auto workerCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+      const auto chunkSize = (level.size() + workerCount - 1) / workerCount;
+      std::vector<std::vector<GRK_Entity>> chunkMoved((level.size() + chunkSize - 1) / chunkSize);
+      std::vector<std::future<void>> tasks;
+      for (std::size_t begin = chunkSize; begin < level.size(); begin += chunkSize) {
+        tasks.push_back(std::async(
+            std::launch::async,
+            [this, &level, &chunkMoved, begin, chunkSize]() {
+              UpdateWorldTransformRange(
+                  level,
+                  begin,
+                  std::min(begin + chunkSize, level.size()),
+                  chunkMoved[begin / chunkSize]);
+            }));
+      }
+      UpdateWorldTransformRange(level, 0, std::min(chunkSize, level.size()), movedEntities_);
+
+      for (auto& task : tasks) {
+        task.wait();
+      }
+      for (std::size_t chunk = 1; chunk < chunkMoved.size(); chunk++) {
+        movedEntities_.insert(movedEntities_.end(), chunkMoved[chunk].begin(), chunkMoved[chunk].end());
+      }
+    }
+
+    //the sweep wrote world matrices, so snapshots must copy the transform store again
+    if (!movedEntities_.empty()) {
+      storeVersions_[GetComponentTypeAccessIndex<GRK_TransformComponent>()]++;
+    }
+
+    RefitSpatialIndex();
+    CoalesceChangedTransforms();
+    transformHierarchy_.AdvanceTick();
+  }
+
+  /**The baked world matrices of the static transforms, see @link GRK_TransformMobility
+   * GRK_TransformMobility @endlink*/
+  auto GetStaticTransforms() const -> const GRK_StaticTransformPartition& {
+    return staticTransforms_;
+  }
+
+  /**The entities whose world transform was recomputed by the last @link
+   * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink, parents
+   * before their children*/
+  auto GetMovedEntities() const -> const std::vector<GRK_Entity>& {
+    return movedEntities_;
+  }
+
+  /**
+   * @brief The dynamic AABB tree over the world bounds of every entity with a @link
+   * GRK_BoundsComponent GRK_BoundsComponent @endlink
+   *
+   * @details
+   * The bounds are in scene space, cell origins included, as of the last @link
+   * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink.  Query it
+   * from any number of threads while nothing adds or removes bounds or updates transforms.*/
+  auto GetSpatialIndex() const -> const GRK_AABBTree& {
+    return spatialIndex_;
+  }
+
+  /**
+   * @brief Rebuilds grid from the scene space position of every enabled entity's transform
+   *
+   * @details
+   * Reads the enabled front of the transform store in store order, cell origins included, from
+   * the world matrices the last @link GRK_EntityComponentManager__::UpdateWorldTransforms
+   * UpdateWorldTransforms @endlink wrote, in chunks on the grid's workers.  Run it once per tick after that for crowds and particles, whose neighbours are
+   * then looked up by entity with @link GRK_SpatialHashGrid::ForEachNeighbour ForEachNeighbour
+   * @endlink.*/
+  auto BuildSpatialHashGrid(GRK_SpatialHashGrid& grid) -> void {
+    const auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    const auto count = GetActiveComponentCount<GRK_TransformComponent>();
+
+    //cell origins are looked up once per cell, and only members of offset cells get one
+    std::vector<std::pair<std::size_t, glm::dvec3>> originOffsets;
+    for (const auto& [cell, origin] : cellOrigins_) {
+      const auto cellIt = cellEntities_.find(cell);
+      if (origin == glm::dvec3(0) || cellIt == cellEntities_.end()) {
+        continue;
+      }
+
+      for (const auto entity : cellIt->second) {
+        if (entityIndex.contains(entity) && entityIndex.at(entity) < count) {
+          originOffsets.emplace_back(entityIndex.at(entity), origin);
+        }
+      }
+    }
+    std::sort(originOffsets.begin(), originOffsets.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    //each worker reads its chunk of the world matrices the sweep last wrote
+    grid.Build(
+        count,
+        [&transforms, &entityIndex, &originOffsets](
+            std::size_t begin, std::size_t end, GRK_Entity* entities, glm::vec3* positions) {
+          for (auto i = begin; i < end; i++) {
+            entities[i] = entityIndex.reverse_at(i);
+            positions[i] = glm::vec3(transforms[i].worldMatrix_[3]);
+          }
+
+          auto offset = std::lower_bound(
+              originOffsets.begin(), originOffsets.end(), begin,
+              [](const auto& originOffset, std::size_t index) { return originOffset.first < index; });
+          for (; offset != originOffsets.end() && offset->first < end; ++offset) {
+            const auto i = offset->first;
+            positions[i] = glm::vec3(glm::dvec3(transforms[i].worldMatrix_[3]) + offset->second);
+          }
+        });
+  }
+
+  /**Every transform's entity bucketed by depth in the transform hierarchy*/
+  auto GetTransformHierarchy() const -> const GRK_TransformHierarchy& {
+    return transformHierarchy_;
+  }
+
+  /**
+   * @brief Writes the single precision world matrices of entities for uploading to the GPU
+   *
+   * @details
+   * The matrices are the ones cached by the last @link
+   * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink, so this
+   * is one conversion per entity and no matrix products unless a transform was changed since.
+   *
+   * @param[in] entities the entities to write the matrices of
+   * @param[out] matrices matrices[i] is set to the world matrix of entities[i], or the identity
+   * if it has no transform
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSpaceRemaining NoSpaceRemaining @endlink if matrices is smaller than
+   * entities, nothing is written
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink if any entity has no transform*/
+  auto GetWorldMatrices(
+      notstd::span<const GRK_Entity> entities,
+      notstd::span<glm::mat4> matrices) const -> GRK_Result {
+    return WriteTransformMatrices(entities, matrices, [](GRK_Entity, const GRK_TransformComponent& transform) {
+      return transform.GetWorldMatrix();
+    });
+  }
+
+  /**
+   * @brief Writes the single precision world matrices of entities part way between the last two
+   * ticks
+   *
+   * @details
+   * For frames rendered between fixed ticks, see @link
+   * GRK_TransformComponent::GetInterpolatedWorldMatrix GetInterpolatedWorldMatrix @endlink.
+   *
+   * @param[in] entities the entities to write the matrices of
+   * @param[in] interpolation 0 for the previous tick's matrices to 1 for the last tick's
+   * @param[out] matrices matrices[i] is set to the interpolated world matrix of entities[i], or
+   * the identity if it has no transform
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSpaceRemaining NoSpaceRemaining @endlink if matrices is smaller than
+   * entities, nothing is written
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink if any entity has no transform*/
+  auto GetInterpolatedWorldMatrices(
+      notstd::span<const GRK_Entity> entities,
+      double interpolation,
+      notstd::span<glm::mat4> matrices) const -> GRK_Result {
+    return WriteTransformMatrices(entities, matrices, [interpolation](GRK_Entity, const GRK_TransformComponent& transform) {
+      return transform.GetInterpolatedWorldMatrix(interpolation);
+    });
+  }
+
+  /**
+   * @brief Writes the single precision world matrices of entities relative to a camera position
+   *
+   * @details
+   * For the render path of large worlds.  Each entity's world translation is offset by its
+   * cell's origin and then by -cameraPosition in double precision before the matrix is narrowed,
+   * so what is near the camera keeps its precision however far it is from the scene origin.  The
+   * view matrix then only has to rotate.  Like @link
+   * GRK_EntityComponentManager__::GetWorldMatrices GetWorldMatrices @endlink the matrices are
+   * the cached ones.
+   *
+   * @param[in] entities the entities to write the matrices of
+   * @param[in] cameraPosition the camera's position relative to the scene origin
+   * @param[out] matrices matrices[i] is set to the camera relative world matrix of entities[i],
+   * or the identity if it has no transform
+   * @param[in] interpolation where between the last two ticks to draw the entities, see @link
+   * GRK_EntityComponentManager__::GetInterpolatedWorldMatrices GetInterpolatedWorldMatrices
+   * @endlink
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSpaceRemaining NoSpaceRemaining @endlink if matrices is smaller than
+   * entities, nothing is written
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink if any entity has no transform*/
+  auto GetCameraRelativeMatrices(
+      notstd::span<const GRK_Entity> entities,
+      glm::dvec3 cameraPosition,
+      notstd::span<glm::mat4> matrices,
+      double interpolation = 1.0) const -> GRK_Result {
+    return WriteTransformMatrices(entities, matrices,
+        [this, cameraPosition, interpolation](GRK_Entity entity, const GRK_TransformComponent& transform) {
+          auto world = transform.GetInterpolatedWorldMatrix(interpolation);
+          world[3] += glm::dvec4(GetCellOrigin(GetEntityCell(entity)) - cameraPosition, 0.0);
+          return world;
+        });
+  }
+
+  /**
+   * @brief The index ranges of the transform store whose world matrices the last @link
+   * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink changed
+   *
+   * @details
+   * For renderers that keep a GPU buffer of every transform's world matrix in store order: only
+   * these ranges need uploading each tick, with glBufferSubData or by writing them straight into
+   * a persistently mapped buffer with @link GRK_EntityComponentManager__::WriteStoreWorldMatrices
+   * WriteStoreWorldMatrices @endlink.  Runs closer than c_transform_upload_max_gap are joined.
+   *
+   * The ranges index the store as it is now.  If @link
+   * GRK_EntityComponentManager__::GetStoreLayoutVersion GetStoreLayoutVersion @endlink of
+   * GRK_TransformComponent changed since the buffer was last written, transforms have moved in
+   * the store and the whole buffer has to be written again.*/
+  auto GetChangedTransformRanges() const -> const std::vector<GRK_IndexRange>& {
+    return changedTransformRanges_;
+  }
+
+  /**
+   * @brief Writes the single precision world matrices of the transforms at store indices first
+   * to first + matrices.size()
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink if the range runs past the end of the
+   * store, nothing is written*/
+  auto WriteStoreWorldMatrices(std::size_t first, notstd::span<glm::mat4> matrices) const -> GRK_Result {
+    const auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    if (first > transforms.size() || matrices.size() > transforms.size() - first) {
+      return GRK_Result::NoSuchElement;
+    }
+
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+      matrices[i] = glm::mat4(transforms[first + i].GetWorldMatrix());
+    }
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Moves each of entities by the matching offset relative to its parent
+   *
+   * @details
+   * The batch form of @link GRK_TransformComponent::TranslateLocal TranslateLocal @endlink for
+   * formations and crowds.  Every entity is looked up and checked once before anything moves, and
+   * the store is only marked written once, instead of once per call through a handle.  The new
+   * positions are added up in one vectorizable loop and written before anything is marked dirty,
+   * then one pass marks the moved subtrees, skipping entities with an ancestor in the batch.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::SizeMismatch SizeMismatch @endlink if there are not as many offsets as
+   * entities
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink if any entity has no transform, nothing
+   * is moved either way*/
+  auto TranslateLocal(
+      notstd::span<const GRK_Entity> entities,
+      notstd::span<const glm::dvec3> offsets) -> GRK_Result {
+    if (offsets.size() != entities.size()) {
+      return GRK_Result::SizeMismatch;
+    }
+    if (!ResolveTransformBatch(entities)) {
+      return GRK_Result::NoSuchEntity;
+    }
+
+    const auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    batchPositions_.resize(entities.size());
+    for (std::size_t i = 0; i < entities.size(); i++) {
+      batchPositions_[i] = transforms[batchInstances_[i]].GetLocalPosition();
+    }
+
+    AddPositions(batchPositions_, offsets);
+    WriteBatchLocalPositions(0, entities.size());
+    MarkTransformBatchDirty(entities);
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Moves each of entities to the matching position in the scene
+   *
+   * @details
+   * The batch form of @link GRK_TransformComponent::SetWorldPosition SetWorldPosition @endlink,
+   * checked like @link GRK_EntityComponentManager__::TranslateLocal TranslateLocal @endlink.
+   * Runs of entities with the same parent, such as the members of a formation, share one
+   * inversion of the parent's world matrix and are brought into its space in one vectorizable
+   * loop.  Entities with children are marked dirty as soon as they are written so the entities
+   * after them see where they moved, the others in one pass at the end.
+   *
+   * @returns see @link GRK_EntityComponentManager__::TranslateLocal TranslateLocal @endlink*/
+  auto SetWorldPositions(
+      notstd::span<const GRK_Entity> entities,
+      notstd::span<const glm::dvec3> positions) -> GRK_Result {
+    if (positions.size() != entities.size()) {
+      return GRK_Result::SizeMismatch;
+    }
+    if (!ResolveTransformBatch(entities)) {
+      return GRK_Result::NoSuchEntity;
+    }
+
+    auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    batchPositions_.resize(entities.size());
+    for (std::size_t begin = 0, end = 0; begin < entities.size(); begin = end) {
+      const auto parent = transforms[batchInstances_[begin]].GetParentEntity();
+      for (end = begin + 1; end < entities.size(); end++) {
+        if (transforms[batchInstances_[end]].GetParentEntity() != parent) {
+          break;
+        }
+      }
+
+      //siblings do not move each other, so the run's parent is the same for all of it
+      const auto parentInverse = parent == 0
+                                 ? glm::dmat4(1)
+                                 : glm::inverse(transforms[batchInstances_[begin]].GetParent()->GetWorldMatrix());
+      TransformPoints(
+          parentInverse,
+          positions.subspan(begin, end - begin),
+          notstd::span<glm::dvec3>(batchPositions_.data() + begin, end - begin));
+      WriteBatchLocalPositions(begin, end);
+
+      //later runs may be under these
+      for (auto i = begin; i < end; i++) {
+        auto& transform = transforms[batchInstances_[i]];
+        if (transform.ChildCount() > 0) {
+          transform.MarkWorldDirty();
+        }
+      }
+    }
+
+    MarkTransformBatchDirty(entities);
+    return GRK_Result::Ok;
+  }
+
+  /**
+   * @brief Writes the position in the scene of each of entities
+   *
+   * @details
+   * The batch form of @link GRK_TransformComponent::GetWorldPosition GetWorldPosition @endlink,
+   * from the cached world transforms unless a transform was changed since the last update.
+   *
+   * @param[out] positions positions[i] is set to the position of entities[i], or the origin if
+   * it has no transform
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSpaceRemaining NoSpaceRemaining @endlink if positions is smaller than
+   * entities, nothing is written
+   * @link GRK_Result::NoSuchEntity NoSuchEntity @endlink if any entity has no transform*/
+  auto GetWorldPositions(
+      notstd::span<const GRK_Entity> entities,
+      notstd::span<glm::dvec3> positions) const -> GRK_Result {
+    if (positions.size() < entities.size()) {
+      return GRK_Result::NoSpaceRemaining;
+    }
+
+    const auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    auto result = GRK_Result::Ok;
+    for (std::size_t i = 0; i < entities.size(); i++) {
+      const auto instance = entityIndex.at(entities[i]);
+      if (instance == kNoComponentInstance) {
+        positions[i] = glm::dvec3(0);
+        result = GRK_Result::NoSuchEntity;
+      } else {
+        positions[i] = transforms[instance].GetWorldPosition();
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Garbage collects deleted entities (Components are always directly deleted as of now)
+   *
+   * @details
+   * Afterwards stores that have been underused for long enough under their @link
+   * GRK_CapacityPolicy GRK_CapacityPolicy @endlink are shrunk, which like removal invalidates
+   * pointers into them*/
+  auto GarbageCollect() -> void {
+    //TODO dont always do this lets be smarter
+    garbage_collect_iter();
+
+    (ShrinkStoreIfUnderused<ComponentTypes>(), ...);
+    ShrinkRuntimeStoresIfUnderused();
+  }
+
+ private:
+  /**The system manager only works with @link GRK_EntityComponentManager
+   * GRK_EntityComponentManager @endlink, managers of other component types (such as ones with
+   * test components) have no systems to tell about changes*/
+  static constexpr bool c_hasSystems = std::is_same<GRK_EntityComponentManager__, GRK_EntityComponentManager>::value;
+
+  /**Informs the systems that the mask of entity changed*/
+  auto UpdateSystemEntities(GRK_Entity entity) -> void {
+    if constexpr (c_hasSystems) {
+      systemManager_->UpdateSystemEntities(GRK_EntityHandle(this, entity));
+    }
+  }
+
+  /**Informs the systems that the masks of entities changed*/
+  auto UpdateSystemEntities(notstd::span<const GRK_Entity> entities) -> void {
+    if constexpr (c_hasSystems) {
+      std::vector<GRK_EntityHandle> handles;
+      handles.reserve(entities.size());
+      for (const auto entity : entities) {
+        handles.emplace_back(this, entity);
+      }
+      systemManager_->UpdateSystemEntities(handles);
+    }
+  }
+
+  /**Drops entity from every system, for entities that are being deleted*/
+  auto UnregisterFromSystems(GRK_Entity entity) -> void {
+    if constexpr (c_hasSystems) {
+      systemManager_->UnregisterEntity(GRK_EntityHandle(this, entity));
+    }
+  }
+
+  /**Drops entities from every system, for entities that are being deleted*/
+  auto UnregisterFromSystems(notstd::span<const GRK_Entity> entities) -> void {
+    if constexpr (c_hasSystems) {
+      std::vector<GRK_EntityHandle> handles;
+      handles.reserve(entities.size());
+      for (const auto entity : entities) {
+        handles.emplace_back(this, entity);
+      }
+      systemManager_->UnregisterEntities(handles);
+    }
+  }
+
+  /**Writes matrixOf(entity, transform) of each entity narrowed to single precision, see @link
+   * GRK_EntityComponentManager__::GetWorldMatrices GetWorldMatrices @endlink for the results*/
+  template<class MatrixOf>
+  auto WriteTransformMatrices(
+      notstd::span<const GRK_Entity> entities,
+      notstd::span<glm::mat4> matrices,
+      MatrixOf matrixOf) const -> GRK_Result {
+    if (matrices.size() < entities.size()) {
+      return GRK_Result::NoSpaceRemaining;
+    }
+
+    const auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    auto result = GRK_Result::Ok;
+    for (std::size_t i = 0; i < entities.size(); i++) {
+      const auto instance = entityIndex.at(entities[i]);
+      if (instance == kNoComponentInstance) {
+        matrices[i] = glm::mat4(1.0f);
+        result = GRK_Result::NoSuchEntity;
+      } else {
+        matrices[i] = glm::mat4(matrixOf(entities[i], transforms[instance]));
+      }
+    }
+
+    return result;
+  }
+
+  /**Swaps entity's ComponentType (if it has one) across the boundary between enabled and
+   * disabled entities' components*/
+  template<class ComponentType>
+  auto MoveAcrossActivePartition(GRK_Entity entity, GRK_ComponentBitMask mask, bool enabled) -> void {
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    if ((mask & IndexToMask(componentTypeIndex)) == 0) {
+      return;
+    }
+
+    auto& activeCount = activeCounts_[componentTypeIndex];
+    const auto instance = GetEntityIndex<ComponentType>().at(entity);
+    if (enabled) {
+      SwapComponentsInStore<ComponentType>(instance, activeCount);
+      activeCount++;
+    } else {
+      activeCount--;
+      SwapComponentsInStore<ComponentType>(instance, activeCount);
+    }
+  }
+
+  /**Brings the world transforms of level[begin, end) up to date and appends those recomputed
+   * this tick to moved*/
+  auto UpdateWorldTransformRange(
+      const std::vector<GRK_Entity>& level,
+      std::size_t begin,
+      std::size_t end,
+      std::vector<GRK_Entity>& moved) -> void {
+    auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    const auto tick = transformHierarchy_.GetTick();
+
+    for (auto i = begin; i < end; i++) {
+      auto& transform = transforms[entityIndex.at(level[i])];
+      transform.UpdateWorldTransform();
+      if (transform.GetWorldTick() == tick) {
+        moved.push_back(level[i]);
+      }
+    }
+  }
+
+  /**Bakes the static transforms queued in transformHierarchy_ into staticTransforms_, parents
+   * before children and each once, and marks the transform store written*/
+  auto BakeStaticTransforms() -> void {
+    const auto& queue = transformHierarchy_.GetStaticBakeQueue();
+    if (queue.empty()) {
+      return;
+    }
+
+    std::vector<std::pair<std::size_t, GRK_Entity>> bakes;
+    bakes.reserve(queue.size());
+    for (const auto entity : queue) {
+      if (const auto* transform = transformHierarchy_.GetTransform(entity)) {
+        bakes.emplace_back(transform->GetHierarchyDepth(), entity);
+      }
+    }
+    transformHierarchy_.ClearStaticBakeQueue();
+    std::sort(bakes.begin(), bakes.end());
+    bakes.erase(std::unique(bakes.begin(), bakes.end()), bakes.end());
+
+    storeVersions_[GetComponentTypeAccessIndex<GRK_TransformComponent>()]++;
+    const auto tick = transformHierarchy_.GetTick();
+    for (const auto& bake : bakes) {
+      auto* transform = transformHierarchy_.GetTransform(bake.second);
+      transform->UpdateWorldTransform();
+      if (transform->GetWorldTick() == tick) {
+        staticTransforms_.Put(bake.second, glm::mat4(transform->GetWorldMatrix()));
+        movedEntities_.push_back(bake.second);
+      }
+    }
+  }
+
+  /**Looks up the transform store index of every entity into batchInstances_ and marks the store
+   * written
+   * @returns false if any entity has no transform*/
+  auto ResolveTransformBatch(notstd::span<const GRK_Entity> entities) -> bool {
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    batchInstances_.resize(entities.size());
+    for (std::size_t i = 0; i < entities.size(); i++) {
+      batchInstances_[i] = entities[i] == 0 ? kNoComponentInstance : entityIndex.at(entities[i]);
+      if (batchInstances_[i] == kNoComponentInstance) {
+        return false;
+      }
+    }
+
+    storeVersions_[GetComponentTypeAccessIndex<GRK_TransformComponent>()]++;
+    return true;
+  }
+
+  /**positions[i] += offsets[i] for every i, as one loop over the packed doubles of both*/
+  static auto AddPositions(notstd::span<glm::dvec3> positions, notstd::span<const glm::dvec3> offsets) -> void {
+    static_assert(sizeof(glm::dvec3) == 3 * sizeof(double), "dvec3 arrays must be packed doubles");
+    if (positions.empty()) {
+      return;
+    }
+
+    auto* out = &positions[0].x;
+    const auto* in = &offsets[0].x;
+    const auto count = 3 * positions.size();
+    for (std::size_t i = 0; i < count; i++) {
+      out[i] += in[i];
+    }
+  }
+
+  /**out[i] = the point points[i] transformed by matrix, with the matrix's entries loaded once*/
+  static auto TransformPoints(
+      const glm::dmat4& matrix,
+      notstd::span<const glm::dvec3> points,
+      notstd::span<glm::dvec3> out) -> void {
+    const auto c0 = glm::dvec3(matrix[0]), c1 = glm::dvec3(matrix[1]);
+    const auto c2 = glm::dvec3(matrix[2]), c3 = glm::dvec3(matrix[3]);
+    for (std::size_t i = 0; i < points.size(); i++) {
+      out[i] = c0 * points[i].x + c1 * points[i].y + c2 * points[i].z + c3;
+    }
+  }
+
+  /**Stores batchPositions_[begin, end) as the local positions of the resolved batch without
+   * marking anything dirty*/
+  auto WriteBatchLocalPositions(std::size_t begin, std::size_t end) -> void {
+    auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    for (auto i = begin; i < end; i++) {
+      transforms[batchInstances_[i]].localPosition_ = GRK_TransformVec3(batchPositions_[i]);
+    }
+  }
+
+  /**Marks the subtree of every entity of the resolved batch dirty once, skipping those already
+   * dirty and those with an ancestor in the batch, whose subtree covers them*/
+  auto MarkTransformBatchDirty(notstd::span<const GRK_Entity> entities) -> void {
+    auto& transforms = std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_);
+    batchEntities_.assign(entities.begin(), entities.end());
+    std::sort(batchEntities_.begin(), batchEntities_.end());
+
+    for (std::size_t i = 0; i < entities.size(); i++) {
+      auto& transform = transforms[batchInstances_[i]];
+      if (transform.IsWorldDirty()) {
+        continue;
+      }
+
+      auto* ancestor = transform.GetParent();
+      while (ancestor != nullptr &&
+          !std::binary_search(batchEntities_.begin(), batchEntities_.end(), ancestor->owner_)) {
+        ancestor = ancestor->GetParent();
+      }
+      if (ancestor == nullptr) {
+        transform.MarkWorldDirty();
+      }
+    }
+  }
+
+  /**Turns movedEntities_ into changedTransformRanges_*/
+  auto CoalesceChangedTransforms() -> void {
+    const auto& entityIndex = GetEntityIndex<GRK_TransformComponent>();
+    changedTransformIndices_.clear();
+    for (const auto entity : movedEntities_) {
+      changedTransformIndices_.push_back(entityIndex.at(entity));
+    }
+
+    std::sort(changedTransformIndices_.begin(), changedTransformIndices_.end());
+    GRK_CoalesceIndexRanges(changedTransformIndices_, c_transform_upload_max_gap, changedTransformRanges_);
+  }
+
+  /**localBounds in scene space, through entity's world matrix (if it has a transform) and its
+   * cell's origin*/
+  auto ComputeWorldBounds(GRK_Entity entity, const GRK_AABB& localBounds) const -> GRK_AABB {
+    const auto instance = GetEntityIndex<GRK_TransformComponent>().at(entity);
+    auto worldMatrix = instance == kNoComponentInstance
+                       ? glm::dmat4(1)
+                       : std::get<GRK_ComponentStore<GRK_TransformComponent>>(componentStores_)[instance].GetWorldMatrix();
+    worldMatrix[3] += glm::dvec4(GetCellOrigin(GetEntityCell(entity)), 0.0);
+    return localBounds.Transformed(worldMatrix);
+  }
+
+  /**Moves the proxies of the entities in movedEntities_ and those marked in spatialIndex_ to
+   * their current world bounds*/
+  auto RefitSpatialIndex() -> void {
+    const auto& bounds = std::get<GRK_ComponentStore<GRK_BoundsComponent>>(componentStores_);
+    const auto& boundsIndex = GetEntityIndex<GRK_BoundsComponent>();
+    auto refit = [this, &bounds, &boundsIndex](GRK_Entity entity) {
+      const auto instance = boundsIndex.at(entity);
+      if (instance != kNoComponentInstance) {
+        spatialIndex_.MoveProxy(bounds[instance].GetProxy(), ComputeWorldBounds(entity, bounds[instance].GetLocalBounds()));
+      }
+    };
+
+    if (boundsIndex.size() == 0) {
+      spatialIndex_.ClearChangedBounds();
+      return;
+    }
+
+    for (const auto entity : movedEntities_) {
+      refit(entity);
+    }
+    for (const auto entity : spatialIndex_.GetChangedBounds()) {
+      refit(entity);
+    }
+    spatialIndex_.ClearChangedBounds();
+  }
+
+  /**Removes entity from the cell it is a member of, if any*/
+  auto ForgetEntityCell(GRK_Entity entity) -> void {
+    const auto membershipIt = entityCells_.find(entity);
+    if (membershipIt == entityCells_.end()) {
+      return;
+    }
+
+    // Unloaded cells are dropped before their members are collected.
+    const auto membership = membershipIt->second;
+    entityCells_.erase(membershipIt);
+    auto cellIt = cellEntities_.find(membership.cell);
+    if (cellIt == cellEntities_.end()) {
+      return;
+    }
+
+    // Move the last member into the hole.
+    auto& members = cellIt->second;
+    members[membership.position] = members.back();
+    entityCells_[members.back()].position = membership.position;
+    members.pop_back();
+
+    if (members.empty()) {
+      cellEntities_.erase(cellIt);
+    }
+  }
+
+  /**Appends the section of ComponentType's components owned by entities to a cell blob*/
+  template<class ComponentType>
+  auto SaveCellSection(
+      const std::vector<GRK_Entity>& entities,
+      std::vector<std::byte>& blob,
+      std::uint32_t& sectionCount) const -> void {
+    using Serializer = GRK_CellSerializer<ComponentType>;
+    if constexpr (Serializer::kIsSerializable) {
+      const auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+      const auto& entityIndex = GetEntityIndex<ComponentType>();
+
+      std::vector<std::uint64_t> ordinals;
+      for (std::size_t ordinal = 0; ordinal < entities.size(); ordinal++) {
+        if (entityIndex.contains(entities[ordinal])) {
+          ordinals.push_back(ordinal);
+        }
+      }
+
+      if (ordinals.empty()) {
+        return;
+      }
+
+      const GRK_CellBlobSection section{
+          static_cast<std::uint32_t>(GetComponentTypeAccessIndex<ComponentType>()),
+          static_cast<std::uint32_t>(Serializer::kSize),
+          ordinals.size()};
+      GRK_AppendToCellBlob(blob, &section, sizeof(section));
+      GRK_AppendToCellBlob(blob, ordinals.data(), ordinals.size() * sizeof(std::uint64_t));
+
+      const auto payloadOffset = blob.size();
+      blob.resize(payloadOffset + GRK_CellBlobPadded(ordinals.size() * Serializer::kSize));
+      for (std::size_t i = 0; i < ordinals.size(); i++) {
+        Serializer::Write(
+            store[entityIndex.at(entities[ordinals[i]])],
+            blob.data() + payloadOffset + i * Serializer::kSize);
+      }
+
+      sectionCount++;
+    }
+  }
+
+  /**
+   * @brief Checks that a cell blob is complete and consistent before anything is loaded from it
+   *
+   * @param[in] blob the blob
+   * @param[out] header the blob's header
+   * @param[out] masks the component mask each entity will have, by ordinal
+   * @param[out] links the parent link of each entity, by ordinal
+   *
+   * @returns false if the blob is truncated, is from another layout version or component list,
+   * gives an entity a component twice, leaves an entity without a transform or links transforms
+   * into a cycle*/
+  auto ValidateCellBlob(
+      notstd::span<const std::byte> blob,
+      GRK_CellBlobHeader& header,
+      std::vector<GRK_ComponentBitMask>& masks,
+      std::vector<GRK_CellBlobParentLink>& links) const -> bool {
+    constexpr std::array<std::size_t, sizeof...(ComponentTypes)> elementSizes{
+        GRK_CellSerializer<ComponentTypes>::kSize...};
+
+    if (blob.size() < sizeof(header)) {
+      return false;
+    }
+    std::memcpy(&header, blob.data(), sizeof(header));
+
+    // Every entity takes at least its flags, which bounds entityCount before allocating.
+    auto offset = GRK_CellBlobPadded(sizeof(header));
+    if (header.magic != kCellBlobMagic || header.version != kCellBlobVersion ||
+        header.entityCount > (blob.size() - offset) / sizeof(std::uint32_t)) {
+      return false;
+    }
+
+    masks.assign(header.entityCount, 0);
+    for (std::size_t ordinal = 0; ordinal < header.entityCount; ordinal++) {
+      std::uint32_t flags;
+      std::memcpy(&flags, blob.data() + offset + ordinal * sizeof(flags), sizeof(flags));
+      masks[ordinal] = (flags & CellEntityDisabled) != 0 ? kDisabledEntityMask : 0u;
+    }
+    offset += GRK_CellBlobPadded(header.entityCount * sizeof(std::uint32_t));
+
+    const auto linksSize = GRK_CellBlobPadded(header.entityCount * sizeof(GRK_CellBlobParentLink));
+    if (blob.size() < offset || blob.size() - offset < linksSize) {
+      return false;
+    }
+    links.resize(header.entityCount);
+    std::memcpy(links.data(), blob.data() + offset, header.entityCount * sizeof(GRK_CellBlobParentLink));
+    offset += linksSize;
+    if (!IsCellHierarchyAcyclic(links)) {
+      return false;
+    }
+
+    for (std::uint32_t i = 0; i < header.sectionCount; i++) {
+      GRK_CellBlobSection section{};
+      if (blob.size() - offset < GRK_CellBlobPadded(sizeof(section))) {
+        return false;
+      }
+      std::memcpy(&section, blob.data() + offset, sizeof(section));
+      offset += GRK_CellBlobPadded(sizeof(section));
+
+      if (section.componentTypeIndex >= elementSizes.size() ||
+          elementSizes[section.componentTypeIndex] == 0 ||
+          section.elementSize != elementSizes[section.componentTypeIndex] ||
+          section.count > header.entityCount) {
+        return false;
+      }
+
+      const auto ordinalsSize = GRK_CellBlobPadded(section.count * sizeof(std::uint64_t));
+      const auto payloadSize = GRK_CellBlobPadded(section.count * section.elementSize);
+      if (blob.size() - offset < ordinalsSize + payloadSize) {
+        return false;
+      }
+
+      const auto componentMask = IndexToMask(section.componentTypeIndex);
+      for (std::size_t j = 0; j < section.count; j++) {
+        std::uint64_t ordinal;
+        std::memcpy(&ordinal, blob.data() + offset + j * sizeof(ordinal), sizeof(ordinal));
+        if (ordinal >= header.entityCount || (masks[ordinal] & componentMask) != 0) {
+          return false;
+        }
+        masks[ordinal] |= componentMask;
+      }
+
+      offset += ordinalsSize + payloadSize;
+    }
+
+    const auto transformMask = IndexToMask(GetComponentTypeAccessIndex<GRK_TransformComponent>());
+    return std::all_of(masks.begin(), masks.end(), [transformMask](GRK_ComponentBitMask mask) {
+      return (mask & transformMask) != 0;
+    });
+  }
+
+  /**true if every parent link of a cell blob names another entity of the blob or none, and
+   * following them from any entity ends at a root*/
+  static auto IsCellHierarchyAcyclic(const std::vector<GRK_CellBlobParentLink>& links) -> bool {
+    //0 unvisited, 1 on the current path, 2 known to end at a root
+    std::vector<std::uint8_t> state(links.size(), 0);
+    std::vector<std::size_t> path;
+    for (std::size_t start = 0; start < links.size(); start++) {
+      auto ordinal = start;
+      while (state[ordinal] == 0) {
+        state[ordinal] = 1;
+        path.push_back(ordinal);
+        const auto parent = links[ordinal].parent;
+        if (parent == kNoCellParent) {
+          break;
+        }
+        if (parent >= links.size() || state[parent] == 1) {
+          return false;
+        }
+        ordinal = static_cast<std::size_t>(parent);
+      }
+
+      for (const auto visited : path) {
+        state[visited] = 2;
+      }
+      path.clear();
+    }
+    return true;
+  }
+
+  /**Appends the components of a validated cell blob section to ComponentType's store, if the
+   * section is ComponentType's*/
+  template<class ComponentType>
+  auto LoadCellSection(
+      const GRK_CellBlobSection& section,
+      const std::byte* ordinals,
+      const std::byte* payload,
+      const std::vector<GRK_Entity>& entities,
+      const std::vector<GRK_ComponentBitMask>& masks) -> void {
+    using Serializer = GRK_CellSerializer<ComponentType>;
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    if constexpr (Serializer::kIsSerializable) {
+      if (section.componentTypeIndex != componentTypeIndex) {
+        return;
+      }
+
+      auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+      auto& entityIndex = GetEntityIndex<ComponentType>();
+      const auto first = store.size();
+      const auto count = static_cast<std::size_t>(section.count);
+
+      if (store.capacity() < first + count) {
+        store.reserve(std::max(first + count, GRK_GrowCapacity(capacityPolicies_[componentTypeIndex], store.capacity())));
+      }
+
+      if constexpr (Serializer::kIsRawCopy &&
+          std::is_same<GRK_ComponentStore<ComponentType>, std::vector<ComponentType>>::value) {
+        store.resize(first + count);
+        std::memcpy(static_cast<void*>(store.data() + first), payload, count * sizeof(ComponentType));
+      } else {
+        for (std::size_t i = 0; i < count; i++) {
+          store.push_back(Serializer::Read(payload + i * Serializer::kSize));
+        }
+      }
+      storeVersions_[componentTypeIndex]++;
+      storeLayoutVersions_[componentTypeIndex]++;
+
+      auto& activeCount = activeCounts_[componentTypeIndex];
+      for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t ordinal;
+        std::memcpy(&ordinal, ordinals + i * sizeof(ordinal), sizeof(ordinal));
+        entityIndex.put(entities[ordinal], first + i);
+        if constexpr (std::is_same<ComponentType, GRK_TransformComponent>::value) {
+          store[first + i].JoinHierarchy(&transformHierarchy_, entities[ordinal]);
+        }
+        if constexpr (std::is_same<ComponentType, GRK_BoundsComponent>::value) {
+          store[first + i].JoinSpatialIndex(
+              &spatialIndex_,
+              entities[ordinal],
+              ComputeWorldBounds(entities[ordinal], store[first + i].GetLocalBounds()));
+        }
+
+        //enabled entities' components go before the disabled ones
+        if ((masks[ordinal] & kDisabledEntityMask) == 0) {
+          SwapComponentsInStore<ComponentType>(first + i, activeCount);
+          activeCount++;
+        }
+      }
+    }
+  }
+
+  /**The memory report of ComponentType's store*/
+  template<class ComponentType>
+  auto ReportStoreMemory() const -> GRK_StoreMemoryReport {
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    const auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    const auto& entityInstanceMap = GetEntityIndex<ComponentType>();
+    const auto elementSize = GRK_StoreElementSize(store);
+
+    GRK_StoreMemoryReport report{};
+    report.componentTypeIndex = componentTypeIndex;
+    report.size = store.size();
+    report.capacity = store.capacity();
+    report.storeBytesUsed = store.size() * elementSize;
+    report.storeBytesReserved = store.capacity() * elementSize;
+    entityInstanceMap.EstimateBytes(report.indexBytesUsed, report.indexBytesReserved);
+
+    return report;
+  }
+
+  /**Counts another collection towards shrinking ComponentType's store and shrinks it (and its
+   * index map) once it has been underused for long enough*/
+  template<class ComponentType>
+  auto ShrinkStoreIfUnderused() -> void {
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    const auto& policy = capacityPolicies_[componentTypeIndex];
+    auto& underusedCollections = underusedCollections_[componentTypeIndex];
+
+    if (!GRK_IsUnderused(policy, store.size(), store.capacity())) {
+      underusedCollections = 0;
+      return;
+    }
+
+    if (++underusedCollections < policy.shrinkAfterCollections) {
+      return;
+    }
+
+    underusedCollections = 0;
+    GRK_ShrinkStoreTo(store, GRK_ShrunkCapacity(policy, store.size()));
+    GetEntityIndex<ComponentType>().shrink_to_fit();
+  }
+
+  /**@link GRK_EntityComponentManager__::ShrinkStoreIfUnderused ShrinkStoreIfUnderused
+   * @endlink for the runtime registered stores*/
+  auto ShrinkRuntimeStoresIfUnderused() -> void {
+    for (std::size_t id = 0; id < runtimeComponentStores_.size(); id++) {
+      auto& store = *runtimeComponentStores_[id];
+      const auto& policy = store.GetInfo().capacityPolicy;
+      auto& underusedCollections = runtimeUnderusedCollections_[id];
+
+      if (!GRK_IsUnderused(policy, store.Size(), store.Capacity())) {
+        underusedCollections = 0;
+      } else if (++underusedCollections >= policy.shrinkAfterCollections) {
+        underusedCollections = 0;
+        store.ShrinkTo(GRK_ShrunkCapacity(policy, store.Size()));
+      }
+    }
+  }
+
+  /**Puts ComponentType's store into snapshot, reusing the copy in previous if the store has not
+   * been written to since*/
+  template<class ComponentType>
+  auto SnapshotComponentStore(WorldSnapshot& snapshot, const WorldSnapshot* previous) const -> void {
+    using StoreSnapshotPointer = std::shared_ptr<const GRK_StoreSnapshot<ComponentType>>;
+
+    const auto componentTypeIndex = GetComponentTypeAccessIndex<ComponentType>();
+    const auto version = storeVersions_[componentTypeIndex];
+    auto& storeSnapshot = std::get<StoreSnapshotPointer>(snapshot.stores_);
+
+    if (previous != nullptr) {
+      const auto& previousStoreSnapshot = std::get<StoreSnapshotPointer>(previous->stores_);
+      if (previousStoreSnapshot != nullptr && previousStoreSnapshot->GetVersion() == version) {
+        storeSnapshot = previousStoreSnapshot;
+        return;
+      }
+    }
+
+    auto store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    if constexpr (std::is_same<ComponentType, GRK_TransformComponent>::value) {
+      DetachTransformCopies(store);
+    }
+
+    storeSnapshot = std::make_shared<const GRK_StoreSnapshot<ComponentType>>(
+        version,
+        std::move(store),
+        GetEntityIndex<ComponentType>());
+  }
+
+  /**Cleans the world matrices of copies of the transform store and cuts them off from
+   * transformHierarchy_, so readers on other threads never reach a live transform through them*/
+  auto DetachTransformCopies(GRK_ComponentStore<GRK_TransformComponent>& copies) const -> void {
+    for (auto& copy : copies) {
+      if (copy.worldDirty_) {
+        copy.worldMatrix_ = copy.ComputeWorldMatrix();
+        copy.worldDirty_ = false;
+      }
+      copy.hierarchy_ = nullptr;
+    }
+  }
+
+  /**The lookup between entities and indexes of ComponentType's store*/
+  template<class ComponentType>
+  auto GetEntityIndex() -> GRK_EntityIndex<ComponentType>& {
+    return std::get<GRK_EntityIndex<ComponentType>>(entityComponentIndexes_);
+  }
+
+  /**@overload*/
+  template<class ComponentType>
+  auto GetEntityIndex() const -> const GRK_EntityIndex<ComponentType>& {
+    return std::get<GRK_EntityIndex<ComponentType>>(entityComponentIndexes_);
+  }
+
+  /**Calls a sort key function with the entity and component at index, or just the component
+   * if that is all it takes*/
+  template<class ComponentType, class KeyFunction>
+  auto ComponentSortKey(KeyFunction& key, std::size_t index) const {
+    const auto& store = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+    if constexpr (std::is_invocable<KeyFunction&, GRK_Entity, decltype(store[index])>::value) {
+      const auto& entityInstanceMap = GetEntityIndex<ComponentType>();
+      return key(entityInstanceMap.reverse_at(index), store[index]);
+    } else {
+      return key(store[index]);
+    }
+  }
+
+  /**Swaps two components in a store and the entries in the entity to index map that point at
+   * them*/
+  template<class ComponentType>
+  auto SwapComponentsInStore(std::size_t lhs, std::size_t rhs) -> void {
+    auto& entityInstanceMap = GetEntityIndex<ComponentType>();
+    const auto lhsEntity = entityInstanceMap.reverse_at(lhs);
+    const auto rhsEntity = entityInstanceMap.reverse_at(rhs);
+
+    GRK_SwapStoreElements(std::get<GRK_ComponentStore<ComponentType>>(componentStores_), lhs, rhs);
+
+    entityInstanceMap.put(lhsEntity, rhs);
+    entityInstanceMap.put(rhsEntity, lhs);
+    storeVersions_[GetComponentTypeAccessIndex<ComponentType>()]++;
+    storeLayoutVersions_[GetComponentTypeAccessIndex<ComponentType>()]++;
+  }
+
+  /**Sets an entity's component mask and brings every cached query up to date with the change,
+   * all writes to @link GRK_EntityComponentManager__::entityComponentsBitMaskMap_
+   * entityComponentsBitMaskMap_ @endlink after creation go through here*/
+  auto SetEntityComponentsBitMask(GRK_Entity entity, GRK_ComponentBitMask newMask) -> void {
+    auto& mask = entityComponentsBitMaskMap_[entity];
+    const auto oldMask = mask;
+    mask = newMask;
+
+    if (oldMask == newMask) {
+      return;
+    }
+
+    entityMasksVersion_++;
+
+    for (auto& query : queries_) {
+      query.second->OnEntityMaskChanged(entity, oldMask, newMask);
+    }
+  }
+
+  /**This function does most of the nitty gritty work of @link
+   * GRK_EntityComponentManager__::RemoveComponent RemoveComponent but is broken out
+   * for convenience and reuse in other scenarios such as GarbageCollection*/
+  template<class ComponentType>
+  auto RemoveComponentHelper(GRK_Entity entity) -> GRK_Result {
+    static_assert(notstd::param_pack_has_type<ComponentType, ComponentTypes...>::value,
+                  "RemoveComponentHelper Function requires ComponentType be one of the template params of GRK_EntityComponentManager__");
+
+    const auto componentAccessIndex = GetComponentTypeAccessIndex<ComponentType>();
+
+    //unlink the transform like garbage collection does, its children become roots
+    if constexpr (std::is_same<ComponentType, GRK_TransformComponent>::value) {
+      if (auto* transform = transformHierarchy_.GetTransform(entity)) {
+        transform->DetachChildren();
+        transform->SetParent(nullptr);
+      }
+    }
+
+    const auto result = RemoveComponentFromStore<ComponentType>(entity);
+
+    if (result == GRK_Result::Ok) {
+      //remove it from bitmask
+      SetEntityComponentsBitMask(entity, entityComponentsBitMaskMap_[entity] & ~(IndexToMask(componentAccessIndex)));
+
+      //and from the sweep and the static bakes, its bounds are back in scene space
+      if constexpr (std::is_same<ComponentType, GRK_TransformComponent>::value) {
+        transformHierarchy_.Erase(entity);
+        staticTransforms_.Erase(entity);
+        spatialIndex_.MarkBoundsChanged(entity);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Removes the component from its store and index map without touching the entity's bitmask
+   *
+   * @details
+   * Only the store and index map belonging to ComponentType are modified, so calls for different
+   * ComponentTypes can safely run at the same time (this is what garbage collection does).  The
+   * caller is responsible for clearing the entity's bit in @link
+   * GRK_EntityComponentManager__::entityComponentsBitMaskMap_ entityComponentsBitMaskMap_ @endlink*/
+  template<class ComponentType>
+  auto RemoveComponentFromStore(GRK_Entity entity) -> GRK_Result {
+    const auto componentAccessIndex = GetComponentTypeAccessIndex<ComponentType>();
+    //this is a vector of the type we are trying to remove
+    auto& componentTypeVector = std::get<GRK_ComponentStore<ComponentType>>(componentStores_);
+
+    //this is the map of entity to components for this type
+    auto& entityInstanceMap = GetEntityIndex<ComponentType>();
+
+    //check if the elment is in the map
+    //and do what we need to if it is not
+    if (!entityInstanceMap.contains(entity)) {
+      return GRK_Result::NoSuchElement;
+    } else {
+      //if it is an enabled entity's component first swap it with the last enabled one, so that
+      //the hole is filled from the disabled components and the partition is kept
+      auto& activeCount = activeCounts_[componentAccessIndex];
+      if (entityInstanceMap.at(entity) < activeCount) {
+        activeCount--;
+        SwapComponentsInStore<ComponentType>(entityInstanceMap.at(entity), activeCount);
+      }
+
+      //this entity exists so we move the last element of the components vector
+      //to the spot that this one was taking up
+
+      // Index of element we are removing
+      const auto removeIndex = entityInstanceMap.at(entity);
+
+      if constexpr (std::is_same<ComponentType, GRK_NameComponent>::value) {
+        nameIndex_.Erase(componentTypeVector[removeIndex].GetName());
+      }
+      if constexpr (std::is_same<ComponentType, GRK_BoundsComponent>::value) {
+        componentTypeVector[removeIndex].LeaveSpatialIndex();
+      }
+
+      // Instance of element we are moving
+      auto lastElementEntity = entityInstanceMap.reverse_at(componentTypeVector.size() - 1);
+
+      // if element is not last then we move last into this one's place
+      if (lastElementEntity != entity) {
+        //move so we cannibilize any allocated components and dont copy them
+        GRK_MoveStoreElement(componentTypeVector, componentTypeVector.size() - 1, removeIndex);
+      }
+
+      //then remove it from the map
+      //and shorten our vector
+      entityInstanceMap.erase(entity);
+      componentTypeVector.pop_back();
+      storeVersions_[componentAccessIndex]++;
+      storeLayoutVersions_[componentAccessIndex]++;
+
+      // If the removed component was the last one there is nothing that moved, so no need to update map
+      if (lastElementEntity != entity) {
+        entityInstanceMap.reverse_erase(componentTypeVector.size());
+        entityInstanceMap.put(lastElementEntity, removeIndex);
+      }
+
+      return GRK_Result::Ok;
+    }
+  }
+
+ private:
+  /** @fn
+   * @brief Meta function which sets up component store vectors stored in the
+   * @link GRK_EntityComponentManager__::componentStores_ componentStores_ tuple
+   * @endlink
+   *
+   * @details
+   * This is done by going through each index in the tuple and reserving some space in the
+   * vectors to prevent long load times later and initializing the map of entities to indexes in
+   * the stores
+   *
+   * @tparam index the index in the tuple to intialize
+   * @tparam Ts variadic list of types that are the types in the tuple to be initialized*/
+  template<int index, class... Ts>
+  struct setup_component_stores_impl {
+    /**
+     * the applictive operator for the meta function
+     *
+     * @param ecm refernce to this
+     * @param t the tuple member of ecm being initialized*/
+    auto operator()(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {
+      auto& elem = std::get<index>(t);
+      elem.reserve(ecm.capacityPolicies_[index].minimumCapacity);
+      std::get<index>(ecm.entityComponentIndexes_).reserve(ecm.capacityPolicies_[index].minimumCapacity);
+      setup_component_stores_impl<index - 1, Ts...>{}(ecm, t);
+    }
+  };
+
+  /**@overload*/
+  template<class... Ts>
+  struct setup_component_stores_impl<-1, Ts...> {
+    auto operator()(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {}
+  };
+
+  /**Meta convenience function to call the setup_component_stores meta function
+   *
+   * @param ecm this class
+   * @param t the tuple that is being iterated through and set up
+   *
+   * @tparam Ts deduced from the tuple that is passed to this function*/
+  template<class... Ts>
+  auto setup_component_stores(GRK_EntityComponentManager__& ecm, std::tuple<Ts...>& t) -> void {
+    const auto size = sizeof...(Ts);
+    setup_component_stores_impl<size - 1, Ts...>{}(ecm, t);
+  }
+
+  /** @fn
+   * @brief Meta function for garbage collection iteration
+   *
+   * @details
+   * This function iterates through each of the types of Components and checks if that
+   * component type is contained in a deleted entity that is being garbage collected, if so it
+   * runs the @link GRK_EntityComponentManager__::RemoveComponentFromStore
+   * RemoveComponentFromStore @endlink function on it.
+   *
+   * The removals for one ComponentType never touch another type's store or index map, so when
+   * inParallel is set each type is handed to a worker thread and its future is appended to
+   * tasks.  Types flagged with @link GRK_IsMainThreadComponent GRK_IsMainThreadComponent
+   * @endlink are always removed on the calling thread, in a second pass (mainThreadPass) run
+   * after every task is done so their destructors never run alongside the workers.  Entity
+   * bitmasks are left alone, they are cleared in one sequential pass at the end.
+   *
+   * @tparam ComponentIndex the index in Ts we are checking for removal
+   * @tparam Ts ComponentTypes passed to the meta function
+   * */
+  template<int ComponentIndex, class... Ts>
+  struct garbage_collect_iter_impl {
+    /** The applicitive operator of the meta function*/
+    auto operator()(
+        GRK_EntityComponentManager__& ecm,
+        bool inParallel,
+        bool mainThreadPass,
+        std::vector<std::future<void>>& tasks) -> void {
+      using ComponentType = typename notstd::index_to_type<ComponentIndex, Ts...>::type;
+
+      auto removeDeletedComponents = [&ecm]() {
+        // Only reads from the mask map, it must not be modified while other tasks are running.
+        const auto& bitMaskMap = ecm.entityComponentsBitMaskMap_;
+        for (const auto entity : ecm.deletedUncleanedEntities_) {
+          const auto maskIt = bitMaskMap.find(entity);
+          if (maskIt != bitMaskMap.end() && (maskIt->second & IndexToMask(ComponentIndex)) > 0) {
+            ecm.template RemoveComponentFromStore<ComponentType>(entity);
+          }
+        }
+      };
+
+      const auto onMainThread = !inParallel || GRK_IsMainThreadComponent<ComponentType>::value;
+      if (onMainThread != mainThreadPass) {
+        //removed by the other pass
+      } else if (onMainThread) {
+        removeDeletedComponents();
+      } else {
+        tasks.push_back(std::async(std::launch::async, removeDeletedComponents));
+      }
+
+      garbage_collect_iter_impl<ComponentIndex - 1, Ts...>{}(ecm, inParallel, mainThreadPass, tasks);
+    }
+  };
+
+  /**@overload*/
+  template<class... Ts>
+  struct garbage_collect_iter_impl<-1, Ts...> {
+    auto operator()(
+        GRK_EntityComponentManager__& ecm,
+        bool inParallel,
+        bool mainThreadPass,
+        std::vector<std::future<void>>& tasks) -> void {}
+  };
+
+  /**Meta convenience function to call the garbage_collect_iter_impl meta function, then merge
+   * the results back into the entity bitmasks*/
+  auto garbage_collect_iter() -> void {
+    if (deletedUncleanedEntities_.empty()) {
+      return;
+    }
+
+    // Unlink the transforms while their relatives can still be looked up, children become roots.
+    for (const auto entity : deletedUncleanedEntities_) {
+      if (auto* transform = transformHierarchy_.GetTransform(entity)) {
+        transform->DetachChildren();
+        transform->SetParent(nullptr);
+      }
+    }
+
+    const auto size = sizeof...(ComponentTypes);
+    const auto inParallel = deletedUncleanedEntities_.size() >= c_parallel_garbage_collect_threshold;
+
+    auto removeFromRuntimeStores = [this, inParallel](bool mainThreadPass, std::vector<std::future<void>>& tasks) {
+      for (auto& runtimeStore : runtimeComponentStores_) {
+        auto* store = runtimeStore.get();
+        auto removeDeletedComponents = [this, store]() {
+          for (const auto entity : deletedUncleanedEntities_) {
+            store->Remove(entity);
+          }
+        };
+
+        const auto onMainThread = !inParallel || store->GetInfo().destroyOnMainThread;
+        if (onMainThread != mainThreadPass) {
+          continue;
+        } else if (onMainThread) {
+          removeDeletedComponents();
+        } else {
+          tasks.push_back(std::async(std::launch::async, removeDeletedComponents));
+        }
+      }
+    };
+
+    // Hand the thread safe types to the workers first, then once they are all done remove the
+    // main thread types, whose destructors may read any other store.
+    std::vector<std::future<void>> tasks;
+    garbage_collect_iter_impl<size - 1, ComponentTypes...>{}(*this, inParallel, false, tasks);
+    removeFromRuntimeStores(false, tasks);
+
+    for (auto& task : tasks) {
+      task.wait();
+    }
+
+    garbage_collect_iter_impl<size - 1, ComponentTypes...>{}(*this, inParallel, true, tasks);
+    removeFromRuntimeStores(true, tasks);
+
+    // Every component of these entities is gone now, nothing else touches the mask map so this
+    // is done here instead of once per removed component.  This also drops them from every query.
+    for (const auto entity : deletedUncleanedEntities_) {
+      SetEntityComponentsBitMask(entity, 0);
+      ForgetEntityCell(entity);
+      transformHierarchy_.Erase(entity);
+      staticTransforms_.Erase(entity);
+    }
+
+    deletedUncleanedEntities_.clear();
+  }
+
+ private:
+  /// The tuple of vectors which store each component type.
+  ComponentStoreTuple componentStores_;
+
+  /// The next entity ID that is incremened each time an entity is made.
+  GRK_Entity nextEntityId_;
+
+  /// List of deleted entites that need to be Garbage Collected.
+  std::vector<GRK_Entity> deletedUncleanedEntities_;
+
+  /// Index into vector for component.
+  typedef size_t ComponentInstance;
+
+  ///this is a map of entities to a bitmask of their components, used for system registration/component deletion checks etc
+  std::unordered_map<GRK_Entity, GRK_ComponentBitMask> entityComponentsBitMaskMap_;
+
+  ///tuple of the lookups between entities and component indexes into std::get<ComponetIndex>(componentStores_)[]
+  EntityIndexTuple entityComponentIndexes_;
+
+  /// Stores of the component types registered at runtime, indexed by GRK_RuntimeComponentID.
+  std::vector<std::unique_ptr<GRK_RuntimeComponentStore>> runtimeComponentStores_;
+
+  /// Number of components of enabled entities at the front of each component store.
+  std::array<std::size_t, sizeof...(ComponentTypes)> activeCounts_{};
+
+  /// Where SortComponentStoreIncremental left off in each component store.
+  std::array<std::size_t, sizeof...(ComponentTypes)> sortCursors_{};
+
+  /// Write version of each component store, bumped by anything that can change it.
+  std::array<std::uint64_t, sizeof...(ComponentTypes)> storeVersions_{};
+
+  /// Layout version of each component store, bumped whenever a component is added, removed or moved.
+  std::array<std::uint64_t, sizeof...(ComponentTypes)> storeLayoutVersions_{};
+
+  /// Write version of entityComponentsBitMaskMap_.
+  std::uint64_t entityMasksVersion_ = 0;
+
+  /// The last published snapshot, only accessed with the atomic shared_ptr functions.
+  std::shared_ptr<const WorldSnapshot> publishedSnapshot_;
+
+  /// Capacity policy of each component store.
+  std::array<GRK_CapacityPolicy, sizeof...(ComponentTypes)> capacityPolicies_;
+
+  /// Consecutive garbage collections each component store has been underused for.
+  std::array<std::size_t, sizeof...(ComponentTypes)> underusedCollections_{};
+
+  /// Consecutive garbage collections each runtime store has been underused for.
+  std::vector<std::size_t> runtimeUnderusedCollections_;
+
+  /// Where an entity is in the member list of its cell.
+  struct CellMembership {
+    GRK_CellID cell;
+    std::size_t position;
+  };
+
+  /// Entities with transforms by depth, kept up to date by the transforms.
+  GRK_TransformHierarchy transformHierarchy_;
+
+  /// Baked world matrices of the static transforms.
+  GRK_StaticTransformPartition staticTransforms_;
+
+  /// The cell of each streamed entity.
+  std::unordered_map<GRK_Entity, CellMembership> entityCells_;
+
+  /// The members of each cell that has any.
+  std::unordered_map<GRK_CellID, std::vector<GRK_Entity>> cellEntities_;
+
+  /// The origin of each cell that is not at the scene origin.
+  std::unordered_map<GRK_CellID, glm::dvec3> cellOrigins_;
+
+  /// World bounds of every GRK_BoundsComponent, refit by UpdateWorldTransforms.
+  GRK_AABBTree spatialIndex_;
+
+  /// Entities whose world transform the last UpdateWorldTransforms recomputed.
+  std::vector<GRK_Entity> movedEntities_;
+
+  /// Transform store indices of movedEntities_, sorted, kept to not reallocate every tick.
+  std::vector<std::size_t> changedTransformIndices_;
+
+  /// changedTransformIndices_ joined into ranges.
+  std::vector<GRK_IndexRange> changedTransformRanges_;
+
+  /// Transform store indices of the entities of the running batch call.
+  std::vector<std::size_t> batchInstances_;
+
+  /// The new local positions of the running batch call, by batch index.
+  std::vector<glm::dvec3> batchPositions_;
+
+  /// The entities of the running batch call, sorted.
+  std::vector<GRK_Entity> batchEntities_;
+
+  /// Entity of each GRK_NameComponent name.
+  GRK_SymbolIndex nameIndex_;
+
+  /// Cached queries by signature, kept up to date by SetEntityComponentsBitMask.
+  std::unordered_map<GRK_QuerySignature, std::unique_ptr<GRK_EntityQuery>> queries_;
 
-  ///vector of bidirectional maps from entity to component index into std::get<ComponetIndex>(componentStores_)[]
-  mutable std::vector<notstd::unordered_bidir_map<GRK_Entity, ComponentInstance>> entityComponentIndexMaps_;
+  /// The number of distinct component types an entity's bit mask can represent, the top bit is kDisabledEntityMask.
+  static constexpr std::size_t kMaxComponentTypes = sizeof(GRK_ComponentBitMask) * 8 - 1;
 
   /// The system manager that handles updating the state stored here.
   GRK_SystemManager * systemManager_;
@@ -0,0 +1,205 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * The serialized form of a world cell, see @link GRK_EntityComponentManager__::SaveCell
+ * SaveCell @endlink and @link GRK_EntityComponentManager__::LoadCell LoadCell @endlink*/
+
+#ifndef __CELLBLOB__H
+#define __CELLBLOB__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/component/BoundsComponent.h"
+#include "grok3d/ecs/component/NameComponent.h"
+#include "grok3d/ecs/component/TransformComponent.h"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace Grok3d {
+/// A spatial cell of the world that is streamed in and out as a whole.
+using GRK_CellID = std::uint64_t;
+
+/// The cell of entities that are not streamed.
+constexpr GRK_CellID kNoCell = 0;
+
+/// "GRKC", the first four bytes of every cell blob.
+constexpr std::uint32_t kCellBlobMagic = 0x434b5247u;
+
+/// Bumped whenever the blob layout changes.
+constexpr std::uint32_t kCellBlobVersion = 6;
+
+/// Every part of a cell blob starts at a multiple of this many bytes.
+constexpr std::size_t kCellBlobAlignment = 8;
+
+/**
+ * @brief The start of a cell blob
+ *
+ * @details
+ * A blob is this header, one std::uint32_t of @link GRK_CellBlobEntityFlags flags @endlink per
+ * entity, one @link GRK_CellBlobParentLink GRK_CellBlobParentLink @endlink per entity, then
+ * sectionCount sections.  Entities are referred to by their ordinal in the blob, the
+ * ids they get are only decided when the blob is loaded.  Each part is padded to @link
+ * kCellBlobAlignment kCellBlobAlignment @endlink.
+ *
+ * The component types are identified by their index in the manager's component list and stored
+ * in their in memory layout, so a blob can only be loaded by a build with the same component
+ * list as the one that saved it.  This is what lets loading be mostly memcpy.*/
+struct GRK_CellBlobHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  GRK_CellID cell;
+  std::uint64_t entityCount;
+  std::uint32_t sectionCount;
+  std::uint32_t reserved;
+
+  /// The cell's origin, see GRK_EntityComponentManager__::SetCellOrigin.
+  double origin[3];
+};
+
+/// Flags of one entity in a cell blob.
+enum GRK_CellBlobEntityFlags : std::uint32_t {
+  CellEntityDisabled = 1u << 0u ///< The entity was disabled when saved.
+};
+
+/// The parent ordinal of an entity whose transform has no parent, or one outside the cell.
+constexpr std::uint64_t kNoCellParent = ~std::uint64_t(0);
+
+/**Where an entity's transform hangs in the hierarchy of its cell, links to transforms outside
+ * the cell are dropped and those transforms load as roots*/
+struct GRK_CellBlobParentLink {
+  /// Ordinal of the parent, kNoCellParent for none.
+  std::uint64_t parent;
+
+  /// Position among the parent's children when saved, to link them back in the same order.
+  std::uint64_t siblingIndex;
+};
+
+/**
+ * @brief The start of the components of one type in a cell blob
+ *
+ * @details
+ * Followed by count std::uint64_t entity ordinals and then count elements of elementSize bytes,
+ * the element at i belonging to the entity at ordinal i.*/
+struct GRK_CellBlobSection {
+  std::uint32_t componentTypeIndex;
+  std::uint32_t elementSize;
+  std::uint64_t count;
+};
+
+/**
+ * @brief How a component type is written to and read from a cell blob
+ *
+ * @details
+ * Trivially copyable components are copied byte for byte and loaded into plain vector stores
+ * with a single memcpy.  Other components are skipped when saving a cell unless they specialize
+ * this with kIsSerializable, a fixed kSize and Write/Read functions, with kIsRawCopy false.*/
+template<class ComponentType, class = void>
+struct GRK_CellSerializer {
+  static constexpr bool kIsSerializable = false;
+  static constexpr bool kIsRawCopy = false;
+  static constexpr std::size_t kSize = 0;
+};
+
+template<class ComponentType>
+struct GRK_CellSerializer<ComponentType, std::enable_if_t<std::is_trivially_copyable<ComponentType>::value>> {
+  static constexpr bool kIsSerializable = true;
+  static constexpr bool kIsRawCopy = true;
+  static constexpr std::size_t kSize = sizeof(ComponentType);
+
+  static auto Write(const ComponentType& component, std::byte* out) -> void {
+    std::memcpy(out, &component, kSize);
+  }
+
+  static auto Read(const std::byte* in) -> ComponentType {
+    ComponentType component;
+    std::memcpy(&component, in, kSize);
+    return component;
+  }
+};
+
+/**Transforms are saved as their local position, scale and rotation and whether they are
+ * static, their parents are saved as @link GRK_CellBlobParentLink GRK_CellBlobParentLink
+ * @endlink since entity ids change*/
+template<>
+struct GRK_CellSerializer<GRK_TransformComponent> {
+  static constexpr bool kIsSerializable = true;
+  static constexpr bool kIsRawCopy = false;
+  static constexpr std::size_t kSize = 2 * sizeof(glm::dvec3) + sizeof(glm::dquat) + sizeof(std::uint64_t);
+
+  static auto Write(const GRK_TransformComponent& component, std::byte* out) -> void {
+    const glm::dvec3 fields[2] = {component.GetLocalPosition(), component.GetLocalScale()};
+    const auto rotation = component.GetLocalRotation();
+    const std::uint64_t isStatic = component.IsStatic() ? 1 : 0;
+    std::memcpy(out, fields, sizeof(fields));
+    std::memcpy(out + sizeof(fields), &rotation, sizeof(rotation));
+    std::memcpy(out + sizeof(fields) + sizeof(rotation), &isStatic, sizeof(isStatic));
+  }
+
+  static auto Read(const std::byte* in) -> GRK_TransformComponent {
+    glm::dvec3 fields[2];
+    glm::dquat rotation;
+    std::uint64_t isStatic;
+    std::memcpy(fields, in, sizeof(fields));
+    std::memcpy(&rotation, in + sizeof(fields), sizeof(rotation));
+    std::memcpy(&isStatic, in + sizeof(fields) + sizeof(rotation), sizeof(isStatic));
+
+    GRK_TransformComponent component(isStatic != 0 ? GRK_TransformMobility::Static : GRK_TransformMobility::Dynamic);
+    component.TranslateLocal(fields[0]);
+    component.SetLocalScale(fields[1]);
+    component.SetLocalRotation(rotation);
+    return component;
+  }
+};
+
+/**Names are symbols of this process's symbol table, which mean nothing to the next one*/
+template<>
+struct GRK_CellSerializer<GRK_NameComponent> {
+  static constexpr bool kIsSerializable = false;
+  static constexpr bool kIsRawCopy = false;
+  static constexpr std::size_t kSize = 0;
+};
+
+/**Bounds are saved as their local box, the proxy belongs to the live spatial index and is
+ * made again when the cell is loaded*/
+template<>
+struct GRK_CellSerializer<GRK_BoundsComponent> {
+  static constexpr bool kIsSerializable = true;
+  static constexpr bool kIsRawCopy = false;
+  static constexpr std::size_t kSize = sizeof(GRK_AABB);
+
+  static auto Write(const GRK_BoundsComponent& component, std::byte* out) -> void {
+    std::memcpy(out, &component.GetLocalBounds(), kSize);
+  }
+
+  static auto Read(const std::byte* in) -> GRK_BoundsComponent {
+    GRK_AABB localBounds;
+    std::memcpy(&localBounds, in, kSize);
+    return GRK_BoundsComponent(localBounds);
+  }
+};
+
+/**Appends size bytes at data to blob and pads it to kCellBlobAlignment*/
+inline auto GRK_AppendToCellBlob(std::vector<std::byte>& blob, const void* data, std::size_t size) -> void {
+  const auto offset = blob.size();
+  blob.resize(offset + size + (kCellBlobAlignment - size % kCellBlobAlignment) % kCellBlobAlignment);
+  if (size > 0) {
+    std::memcpy(blob.data() + offset, data, size);
+  }
+}
+
+/**size rounded up to kCellBlobAlignment*/
+constexpr auto GRK_CellBlobPadded(std::size_t size) -> std::size_t {
+  return (size + kCellBlobAlignment - 1) / kCellBlobAlignment * kCellBlobAlignment;
+}
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,51 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "grok3d/ecs/component/BoundsComponent.h"
+
+using namespace Grok3d;
+
+GRK_BoundsComponent::GRK_BoundsComponent() noexcept :
+    GRK_BoundsComponent(GRK_AABB{glm::dvec3(0), glm::dvec3(0)}) {
+}
+
+GRK_BoundsComponent::GRK_BoundsComponent(const GRK_AABB& localBounds) noexcept :
+    localBounds_(localBounds),
+    tree_(nullptr),
+    owner_(0),
+    proxy_(GRK_AABBTree::kNullNode) {
+}
+
+auto GRK_BoundsComponent::GetLocalBounds() const -> const GRK_AABB& {
+  return localBounds_;
+}
+
+auto GRK_BoundsComponent::SetLocalBounds(const GRK_AABB& localBounds) -> void {
+  localBounds_ = localBounds;
+  if (tree_ != nullptr) {
+    tree_->MarkBoundsChanged(owner_);
+  }
+}
+
+auto GRK_BoundsComponent::GetProxy() const -> std::int32_t {
+  return proxy_;
+}
+
+auto GRK_BoundsComponent::JoinSpatialIndex(
+    GRK_AABBTree* const tree,
+    const GRK_Entity owner,
+    const GRK_AABB& worldBounds) -> void {
+  tree_ = tree;
+  owner_ = owner;
+  proxy_ = tree_->CreateProxy(worldBounds, owner);
+}
+
+auto GRK_BoundsComponent::LeaveSpatialIndex() -> void {
+  if (tree_ != nullptr) {
+    tree_->DestroyProxy(proxy_);
+  }
+  tree_ = nullptr;
+  proxy_ = GRK_AABBTree::kNullNode;
+}
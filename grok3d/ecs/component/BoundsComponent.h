@@ -0,0 +1,71 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/**
+ * @file
+ * Definition for the bounds component.
+ */
+
+#ifndef __BOUNDSCOMPONENT__H
+#define __BOUNDSCOMPONENT__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/spatial/AABB.h"
+#include "grok3d/ecs/spatial/AABBTree.h"
+
+#include <cstdint>
+
+namespace Grok3d {
+/**
+ * @brief The box around an entity in its own space, which puts it in the spatial index
+ *
+ * @details
+ * The @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink keeps the box,
+ * transformed by the entity's world matrix and moved to its cell's origin, as a proxy in its
+ * @link GRK_AABBTree GRK_AABBTree @endlink for as long as the entity has this component.  The
+ * proxy is refit at the end of @link GRK_EntityComponentManager__::UpdateWorldTransforms
+ * UpdateWorldTransforms @endlink for every entity whose world transform changed that tick.*/
+class GRK_BoundsComponent {
+ public:
+  /**A point at the entity's origin*/
+  GRK_BoundsComponent() noexcept;
+
+  explicit GRK_BoundsComponent(const GRK_AABB& localBounds) noexcept;
+
+  auto GetLocalBounds() const -> const GRK_AABB&;
+
+  /**Replaces the box, the spatial index sees it at the end of the next @link
+   * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink*/
+  auto SetLocalBounds(const GRK_AABB& localBounds) -> void;
+
+  /**The component's proxy in the spatial index, @link GRK_AABBTree::kNullNode kNullNode
+   * @endlink if it is not in one*/
+  auto GetProxy() const -> std::int32_t;
+
+  /**Called by the @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink when
+   * the component is added to owner, creates its proxy in tree at worldBounds*/
+  auto JoinSpatialIndex(GRK_AABBTree* tree, GRK_Entity owner, const GRK_AABB& worldBounds) -> void;
+
+  /**Called by the @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink when
+   * the component is removed, destroys its proxy*/
+  auto LeaveSpatialIndex() -> void;
+
+ private:
+  /// The box in the entity's space.
+  GRK_AABB localBounds_;
+
+  /// The index holding the proxy, nullptr until the component joins one.
+  GRK_AABBTree* tree_;
+
+  /// The entity this component is on.
+  GRK_Entity owner_;
+
+  /// The leaf in tree_.
+  std::int32_t proxy_;
+};
+} /*Grok3d*/
+
+#endif
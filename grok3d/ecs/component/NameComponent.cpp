@@ -0,0 +1,26 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "grok3d/ecs/component/NameComponent.h"
+
+using namespace Grok3d;
+
+GRK_NameComponent::GRK_NameComponent() noexcept : name_(kNoSymbol) {
+}
+
+GRK_NameComponent::GRK_NameComponent(const std::string_view name) noexcept :
+    name_(GRK_SymbolTable::Global().Intern(name)) {
+}
+
+GRK_NameComponent::GRK_NameComponent(const GRK_Symbol name) noexcept : name_(name) {
+}
+
+auto GRK_NameComponent::GetName() const -> GRK_Symbol {
+  return name_;
+}
+
+auto GRK_NameComponent::GetNameString() const -> std::string_view {
+  return GRK_SymbolTable::Global().GetString(name_);
+}
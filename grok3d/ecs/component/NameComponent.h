@@ -0,0 +1,50 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/**
+ * @file
+ * Definition for the name component.
+ */
+
+#ifndef __NAMECOMPONENT__H
+#define __NAMECOMPONENT__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/name/SymbolTable.h"
+
+#include <string_view>
+
+namespace Grok3d {
+/**
+ * @brief An optional, unique name for an entity, such as "player" or "boss_turret_3"
+ *
+ * @details
+ * The name is stored as a @link GRK_Symbol GRK_Symbol @endlink from the @link
+ * GRK_SymbolTable::Global global symbol table @endlink so names compare as integers.  The
+ * @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink keeps an index of
+ * named entities, look them up with @link GRK_EntityComponentManager__::FindEntityByName
+ * FindEntityByName @endlink.  Two entities can not have the same name at the same time.*/
+class GRK_NameComponent {
+ public:
+  GRK_NameComponent() noexcept;
+
+  /**Interns name*/
+  explicit GRK_NameComponent(std::string_view name) noexcept;
+
+  explicit GRK_NameComponent(GRK_Symbol name) noexcept;
+
+  auto GetName() const -> GRK_Symbol;
+
+  /**The string the name was interned from*/
+  auto GetNameString() const -> std::string_view;
+
+ private:
+  /// The interned name.
+  GRK_Symbol name_;
+};
+} /*Grok3d*/
+
+#endif
@@ -48,6 +48,26 @@ GRK_RenderComponent::GRK_RenderComponent(
 
 }
 
+auto GRK_RenderComponent::MakeHotRecord() const -> GRK_DrawRecord {
+  GRK_DrawRecord record;
+  record.vertexArrayObject = vertexArrayObject_;
+  record.shaderProgramID = shaderProgramID_;
+  record.textureID = GetTextureHandle().GetId();
+  record.primitive = GetPrimitive();
+  record.indexType = static_cast<GLenum>(vertexPrimitiveType_);
+  record.drawFunction = drawFunctionType_;
+
+  if (drawFunctionType_ == GRK_DrawFunction::DrawElements) {
+    record.count = static_cast<GLsizei>(numIndices_);
+    record.offset = static_cast<GLuint>(SizeOfIndexType() * elementBufferObjectOffset_);
+  } else {
+    record.count = static_cast<GLsizei>(vertexCount_);
+    record.offset = static_cast<GLuint>(vertexBufferObjectOffset_);
+  }
+
+  return record;
+}
+
 void GRK_RenderComponent::CreateVertexArrayAndBuffer() {
   // Create Vertex Array Object.
   glGenVertexArrays(1, &vertexArrayObject_);
@@ -41,6 +41,42 @@ struct GRK_VertexAttribute {
   void* offset;
 };
 
+/**
+ * @brief The part of a @link GRK_RenderComponent GRK_RenderComponent @endlink needed to issue
+ * its draw call
+ *
+ * @details
+ * This is the hot record of the render component (see @link GRK_HotRecordOf GRK_HotRecordOf
+ * @endlink), these are stored contiguously and are all the render loop reads, the texture
+ * handle's reference count and everything else in the component stay out of the cache.*/
+struct GRK_DrawRecord {
+  /// Vertex array object to bind.
+  GRK_VertexArrayObject vertexArrayObject;
+
+  /// Shader program to use.
+  Shaders::GRK_ShaderProgramID shaderProgramID;
+
+  /// 2D texture to bind, 0 for none.
+  GLuint textureID;
+
+  /// Triangles, points etc, what is passed to glDraw*.
+  GLenum primitive;
+
+  /// Type of the indices in the element buffer, only used by DrawElements.
+  GLenum indexType;
+
+  /// Draw either element or arrays.
+  GRK_DrawFunction drawFunction;
+
+  /// Number of vertices (DrawArrays) or indices (DrawElements) to draw.
+  GLsizei count;
+
+  /// First vertex (DrawArrays) or byte offset into the element buffer (DrawElements).
+  GLuint offset;
+};
+
+static_assert(sizeof(GRK_DrawRecord) == 32, "GRK_DrawRecord should stay 32 bytes, two per cache line");
+
 // TODO create a constructor that uses already created array/element buffer objects.
 // when this is created, use shared_ptr to reference count them, and move the freeing of those buffers to it's destructor
 // using shared_ptr will require overridding it's constructor/destructor to use OGL.
@@ -92,6 +128,10 @@ class GRK_RenderComponent {
 
   auto GetShaderProgramID() const -> Shaders::GRK_ShaderProgramID { return shaderProgramID_; }
 
+  /**Copy out what is needed to draw this component, see @link GRK_DrawRecord GRK_DrawRecord
+   * @endlink*/
+  auto MakeHotRecord() const -> GRK_DrawRecord;
+
   auto SizeOfIndexType() const -> std::size_t {
     switch (vertexPrimitiveType_) {
       case GRK_GL_PrimitiveType::Unsigned_Int:return sizeof(unsigned int);
@@ -6,86 +6,169 @@
 #include "grok3d/ecs/component/TransformComponent.h"
 #include "grok3d/ecs/component/ComponentHandle.h"
 
+#include "grok3d/ecs/transform/TransformHierarchy.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
 using namespace Grok3d;
 
+namespace {
+/**previous blended towards current, see GRK_TransformComponent::GetInterpolatedWorldMatrix*/
+auto InterpolateWorldMatrix(const glm::dmat4& previous, const glm::dmat4& current, double t) -> glm::dmat4 {
+  const glm::dvec3 previousScale(
+      glm::length(glm::dvec3(previous[0])), glm::length(glm::dvec3(previous[1])), glm::length(glm::dvec3(previous[2])));
+  const glm::dvec3 currentScale(
+      glm::length(glm::dvec3(current[0])), glm::length(glm::dvec3(current[1])), glm::length(glm::dvec3(current[2])));
+
+  //a zero scale axis has no rotation to take apart, blend the matrices instead
+  for (int i = 0; i < 3; i++) {
+    if (previousScale[i] == 0 || currentScale[i] == 0) {
+      return previous * (1.0 - t) + current * t;
+    }
+  }
+
+  auto previousRotation = previous, currentRotation = current;
+  for (int i = 0; i < 3; i++) {
+    previousRotation[i] = previous[i] * (1.0 / previousScale[i]);
+    currentRotation[i] = current[i] * (1.0 / currentScale[i]);
+  }
+  previousRotation[3] = glm::dvec4(0, 0, 0, 1);
+  currentRotation[3] = glm::dvec4(0, 0, 0, 1);
+
+  const auto rotation = glm::slerp(glm::quat_cast(previousRotation), glm::quat_cast(currentRotation), t);
+  const auto translation = glm::mix(glm::dvec3(previous[3]), glm::dvec3(current[3]), t);
+  return glm::scale(glm::translate(glm::dmat4(1), translation) * glm::mat4_cast(rotation),
+                    glm::mix(previousScale, currentScale, t));
+}
+}
+
 GRK_TransformComponent::GRK_TransformComponent() noexcept :
-    parent_(nullptr),
-    children_(std::vector<GRK_TransformComponent*>()),
-    localPosition_(glm::dvec3(0)),
-    localScale_(glm::dvec3(0)) {
+    GRK_TransformComponent(GRK_TransformMobility::Dynamic) {
+}
+
+GRK_TransformComponent::GRK_TransformComponent(const GRK_TransformMobility mobility) noexcept :
+    localPosition_(0),
+    localScale_(1),
+    localRotation_(1, 0, 0, 0),
+    worldMatrix_(1),
+    previousWorldMatrix_(1),
+    worldTick_(0),
+    worldDirty_(true),
+    isStatic_(mobility == GRK_TransformMobility::Static),
+    hierarchy_(nullptr),
+    owner_(0),
+    depth_(0),
+    parent_(0),
+    firstChild_(0),
+    lastChild_(0),
+    previousSibling_(0),
+    nextSibling_(0),
+    childCount_(0),
+    siblingIndex_(0) {
 }
 
 auto GRK_TransformComponent::SetParent(GRK_TransformComponent* newParent) -> void {
-  parent_ = newParent;
-  parent_->AttachChild(this);
+  //links are entities of the manager owning both transforms
+  if (newParent != nullptr && (hierarchy_ == nullptr || newParent->hierarchy_ != hierarchy_)) {
+    return;
+  }
+
+  //a static transform under a dynamic one would move with it
+  if (newParent != nullptr && isStatic_ && !newParent->isStatic_) {
+    return;
+  }
+
+  //parenting under itself or a descendant would make a loop
+  for (auto* ancestor = newParent; ancestor != nullptr; ancestor = Resolve(ancestor->parent_)) {
+    if (ancestor == this) {
+      return;
+    }
+  }
+
+  DetachFromParent();
+
+  if (newParent != nullptr) {
+    //append to the end of the new parent's children
+    parent_ = newParent->owner_;
+    previousSibling_ = newParent->lastChild_;
+    siblingIndex_ = newParent->childCount_;
+    if (auto* lastChild = Resolve(newParent->lastChild_)) {
+      lastChild->nextSibling_ = owner_;
+    } else {
+      newParent->firstChild_ = owner_;
+    }
+    newParent->lastChild_ = owner_;
+    newParent->childCount_++;
+  }
+
+  SetHierarchyDepth(newParent == nullptr ? 0 : newParent->depth_ + 1);
+  MarkWorldDirty();
 }
 
 auto GRK_TransformComponent::AttachChild(GRK_TransformComponent* newChild) -> void {
-  this->children_.push_back(newChild);
+  newChild->SetParent(this);
+}
+
+auto GRK_TransformComponent::GetParent() const -> GRK_TransformComponent* {
+  return Resolve(parent_);
+}
+
+auto GRK_TransformComponent::GetParentEntity() const -> GRK_Entity {
+  return parent_;
 }
 
 auto GRK_TransformComponent::IsChildOf(const GRK_TransformComponent* const possibleParent) const -> bool {
-  return possibleParent == parent_;
+  return possibleParent != nullptr && parent_ != 0 &&
+      possibleParent->hierarchy_ == hierarchy_ && possibleParent->owner_ == parent_;
 }
 
-auto GRK_TransformComponent::GetSiblingIndex() -> std::size_t //use parent and iterate through the list looking for me
-{
-  return parent_->GetChildIndex(this);
+auto GRK_TransformComponent::GetSiblingIndex() -> std::size_t {
+  return parent_ == 0 ? static_cast<std::size_t>(-1) : siblingIndex_;
 }
 
 auto GRK_TransformComponent::GetChildIndex(const GRK_TransformComponent* const possibleChild) const -> std::size_t {
-  for (size_t i = 0; i < children_.size(); ++i) {
-    if (children_[i] == possibleChild) {
-      return i;
-    }
-  }
-  return -1;
+  return possibleChild != nullptr && possibleChild->IsChildOf(this)
+         ? possibleChild->siblingIndex_
+         : static_cast<std::size_t>(-1);
 }
 
 auto GRK_TransformComponent::ChildCount() -> int {
-  return static_cast<int>(this->children_.size());
+  return static_cast<int>(childCount_);
 }
 
 auto GRK_TransformComponent::GetWorldPosition() const -> glm::dvec3 {
-  //if i have no parent, my position is world position
-  //otherwise my position concatonated with my parents' world position (recursive) is my actual position
-  if (parent_ == nullptr) {
-    return localPosition_;
-  } else {
-    return localPosition_ + parent_->GetWorldPosition();
-  }
+  //the translation column of the world matrix
+  return glm::dvec3(GetWorldMatrix()[3]);
 }
 
 auto GRK_TransformComponent::SetWorldPosition(glm::dvec3 v) -> void {
   //if no parent, setting world position is setting my position
-  //otherwise it is these coordinates subtracted from my parent's position recursively
-  if (parent_ == nullptr) {
-    localPosition_ = v;
+  //otherwise it is these coordinates brought into my parent's space
+  auto* parent = Resolve(parent_);
+  if (parent == nullptr) {
+    localPosition_ = GRK_TransformVec3(v);
   } else {
-    localPosition_ = v - parent_->GetWorldPosition();
+    localPosition_ = GRK_TransformVec3(glm::inverse(parent->GetWorldMatrix()) * glm::dvec4(v, 1.0));
   }
+  MarkWorldDirty();
 }
 
 auto GRK_TransformComponent::SetWorldPosition(const double x, const double y, const double z) -> void {
-  //if no parent, setting world position is setting my position
-  //otherwise it is these coordinates subtracted from my parent's position recursively
-  if (parent_ == nullptr) {
-    localPosition_.x = x;
-    localPosition_.y = y;
-    localPosition_.z = z;
-  } else {
-    localPosition_.x = x - parent_->GetWorldPosition().x;
-    localPosition_.y = y - parent_->GetWorldPosition().y;
-    localPosition_.z = z - parent_->GetWorldPosition().z;
-  }
+  SetWorldPosition(glm::dvec3(x, y, z));
 }
 
 auto GRK_TransformComponent::GetLocalPosition() const -> glm::dvec3 {
-  return localPosition_;
+  return glm::dvec3(localPosition_);
 }
 
 auto GRK_TransformComponent::GetLocalPosition(glm::dvec3 v) -> void {
-  this->localPosition_ = v;
+  SetLocalPosition(v);
+}
+
+auto GRK_TransformComponent::SetLocalPosition(glm::dvec3 v) -> void {
+  localPosition_ = GRK_TransformVec3(v);
+  MarkWorldDirty();
 }
 
 auto GRK_TransformComponent::TranslateLocal(glm::dvec3 v) -> void {
@@ -93,34 +176,217 @@ auto GRK_TransformComponent::TranslateLocal(glm::dvec3 v) -> void {
 }
 
 auto GRK_TransformComponent::TranslateLocal(const double x, const double y, const double z) -> void {
-  localPosition_.x += x;
-  localPosition_.y += y;
-  localPosition_.z += z;
+  localPosition_.x += static_cast<GRK_TransformScalar>(x);
+  localPosition_.y += static_cast<GRK_TransformScalar>(y);
+  localPosition_.z += static_cast<GRK_TransformScalar>(z);
+  MarkWorldDirty();
 }
 
 auto GRK_TransformComponent::GetLocalScale() const -> glm::dvec3 {
-  return localScale_;
+  return glm::dvec3(localScale_);
 }
 
 auto GRK_TransformComponent::SetLocalScale(glm::dvec3 v) -> void {
-  localScale_ = v;
+  localScale_ = GRK_TransformVec3(v);
+  MarkWorldDirty();
 }
 
 auto GRK_TransformComponent::SetLocalScale(const double x, const double y, const double z) -> void {
-  localScale_.x = x;
-  localScale_.y = y;
-  localScale_.z = z;
+  SetLocalScale(glm::dvec3(x, y, z));
+}
+
+auto GRK_TransformComponent::GetLocalRotation() const -> glm::dquat {
+  return glm::dquat(localRotation_);
+}
+
+auto GRK_TransformComponent::SetLocalRotation(glm::dquat rotation) -> void {
+  localRotation_ = GRK_TransformQuat(rotation);
+  MarkWorldDirty();
+}
+
+auto GRK_TransformComponent::RotateLocal(glm::dquat rotation) -> void {
+  //renormalize so repeated small rotations do not drift into a scale
+  SetLocalRotation(glm::normalize(rotation * GetLocalRotation()));
+}
+
+auto GRK_TransformComponent::RotateLocal(const double angle, glm::dvec3 axis) -> void {
+  RotateLocal(glm::angleAxis(angle, axis));
+}
+
+auto GRK_TransformComponent::GetLocalMatrix() const -> glm::dmat4 {
+  return glm::dmat4(LocalMatrix());
+}
+
+auto GRK_TransformComponent::GetWorldMatrix() const -> glm::dmat4 {
+  return glm::dmat4(worldDirty_ ? ComputeWorldMatrix() : worldMatrix_);
+}
+
+auto GRK_TransformComponent::GetInterpolatedWorldMatrix(const double interpolation) const -> glm::dmat4 {
+  //only transforms updated in the tick that just ended have moved since the one before, and a
+  //rebaked static transform jumps
+  if (hierarchy_ == nullptr || isStatic_ || worldTick_ + 1 != hierarchy_->GetTick() || interpolation >= 1.0) {
+    return GetWorldMatrix();
+  }
+
+  return InterpolateWorldMatrix(glm::dmat4(previousWorldMatrix_), glm::dmat4(worldMatrix_), interpolation);
 }
 
 auto GRK_TransformComponent::DetachChildren() -> void {
-  for (auto child : children_) {
-    child->SetParent(nullptr);
+  for (auto* child = Resolve(firstChild_); child != nullptr;) {
+    auto* next = Resolve(child->nextSibling_);
+
+    child->parent_ = 0;
+    child->previousSibling_ = 0;
+    child->nextSibling_ = 0;
+    child->siblingIndex_ = 0;
+    child->SetHierarchyDepth(0);
+    child->MarkWorldDirty();
+
+    child = next;
   }
-  children_.clear();
+
+  firstChild_ = 0;
+  lastChild_ = 0;
+  childCount_ = 0;
 }
 
 auto GRK_TransformComponent::GetChild(const unsigned int index) const -> GRK_TransformComponent* {
-  return (index < children_.size() && index > 0) ? children_[index] : nullptr;
+  if (index >= childCount_) {
+    return nullptr;
+  }
+
+  //a snapshot copy has no hierarchy to find its children in
+  auto* child = Resolve(firstChild_);
+  for (unsigned int i = 0; i < index && child != nullptr; i++) {
+    child = Resolve(child->nextSibling_);
+  }
+  return child;
+}
+
+auto GRK_TransformComponent::JoinHierarchy(GRK_TransformHierarchy* hierarchy, GRK_Entity owner) -> void {
+  hierarchy_ = hierarchy;
+  owner_ = owner;
+  if (isStatic_) {
+    hierarchy_->QueueStaticBake(owner_);
+  } else {
+    hierarchy_->SetDepth(owner_, depth_);
+  }
+}
+
+auto GRK_TransformComponent::IsStatic() const -> bool {
+  return isStatic_;
+}
+
+auto GRK_TransformComponent::GetHierarchyDepth() const -> std::size_t {
+  return depth_;
+}
+
+auto GRK_TransformComponent::IsWorldDirty() const -> bool {
+  return worldDirty_;
+}
+
+auto GRK_TransformComponent::GetWorldTick() const -> std::uint64_t {
+  return worldTick_;
+}
+
+auto GRK_TransformComponent::UpdateWorldTransform() -> void {
+  if (!worldDirty_) {
+    return;
+  }
+
+  //keep the matrix from before this tick's first update, a new transform has no earlier one
+  const auto tick = hierarchy_ == nullptr ? 0 : hierarchy_->GetTick();
+  if (worldTick_ != tick) {
+    previousWorldMatrix_ = worldMatrix_;
+  }
+
+  auto* parent = Resolve(parent_);
+  if (parent == nullptr) {
+    worldMatrix_ = LocalMatrix();
+  } else {
+    parent->UpdateWorldTransform();
+    worldMatrix_ = parent->worldMatrix_ * LocalMatrix();
+  }
+
+  if (worldTick_ == 0) {
+    previousWorldMatrix_ = worldMatrix_;
+  }
+  worldTick_ = tick;
+  worldDirty_ = false;
+}
+
+auto GRK_TransformComponent::LocalMatrix() const -> GRK_TransformMat4 {
+  const auto translation = glm::translate(GRK_TransformMat4(1), localPosition_);
+  return glm::scale(translation * glm::mat4_cast(localRotation_), localScale_);
+}
+
+auto GRK_TransformComponent::Resolve(GRK_Entity entity) const -> GRK_TransformComponent* {
+  return entity == 0 || hierarchy_ == nullptr ? nullptr : hierarchy_->GetTransform(entity);
+}
+
+auto GRK_TransformComponent::DetachFromParent() -> void {
+  auto* parent = Resolve(parent_);
+  if (parent == nullptr) {
+    return;
+  }
+
+  //unlink from the sibling list, the siblings after this move up one index
+  if (auto* previous = Resolve(previousSibling_)) {
+    previous->nextSibling_ = nextSibling_;
+  } else {
+    parent->firstChild_ = nextSibling_;
+  }
+  if (auto* next = Resolve(nextSibling_)) {
+    next->previousSibling_ = previousSibling_;
+  } else {
+    parent->lastChild_ = previousSibling_;
+  }
+  for (auto* sibling = Resolve(nextSibling_); sibling != nullptr; sibling = Resolve(sibling->nextSibling_)) {
+    sibling->siblingIndex_--;
+  }
+  parent->childCount_--;
+
+  parent_ = 0;
+  previousSibling_ = 0;
+  nextSibling_ = 0;
+  siblingIndex_ = 0;
+}
+
+auto GRK_TransformComponent::SetHierarchyDepth(std::size_t depth) -> void {
+  depth_ = depth;
+  if (hierarchy_ != nullptr && !isStatic_) {
+    hierarchy_->SetDepth(owner_, depth_);
+  }
+
+  for (auto* child = Resolve(firstChild_); child != nullptr; child = Resolve(child->nextSibling_)) {
+    child->SetHierarchyDepth(depth_ + 1);
+  }
+}
+
+auto GRK_TransformComponent::MarkWorldDirty() -> void {
+  //descendants of a dirty transform are already dirty
+  if (worldDirty_) {
+    return;
+  }
+
+  worldDirty_ = true;
+  if (isStatic_ && hierarchy_ != nullptr) {
+    hierarchy_->QueueStaticBake(owner_);
+  }
+  for (auto* child = Resolve(firstChild_); child != nullptr; child = Resolve(child->nextSibling_)) {
+    child->MarkWorldDirty();
+  }
+}
+
+auto GRK_TransformComponent::ComputeWorldMatrix() const -> GRK_TransformMat4 {
+  //if i have no parent, my local matrix is my world matrix
+  //otherwise it is concatonated with my parents' world matrix
+  auto* parent = Resolve(parent_);
+  if (parent == nullptr) {
+    return LocalMatrix();
+  } else {
+    return (parent->worldDirty_ ? parent->ComputeWorldMatrix() : parent->worldMatrix_) * LocalMatrix();
+  }
 }
 
 //template specialization for GRK_TransformComponent
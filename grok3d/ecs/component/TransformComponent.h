@@ -11,12 +11,57 @@
 #include "grok3d/grok3d_types.h"
 
 #include "glm/fwd.hpp"
+#include "glm/mat4x4.hpp"
 #include "glm/gtc/quaternion.hpp"
 
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace Grok3d {
+class GRK_TransformHierarchy;
+
+/*
+ * Transforms are stored in double precision unless GRK_TRANSFORM_FLOAT32 is defined (bazel
+ * --define grok3d_transform_precision=float32), which halves the bytes every transform pass
+ * moves.  Single precision positions are only exact to about a millimetre a few kilometres out,
+ * so large worlds should keep each cell's transforms relative to the cell's double precision
+ * origin, see GRK_EntityComponentManager__::SetCellOrigin.  The functions of the component take
+ * and return double precision either way.
+ */
+#ifdef GRK_TRANSFORM_FLOAT32
+/// The scalar transforms are stored in.
+using GRK_TransformScalar = float;
+
+/// A stored transform vector.
+using GRK_TransformVec3 = glm::vec3;
+
+/// A stored transform rotation.
+using GRK_TransformQuat = glm::quat;
+
+/// A stored transform matrix.
+using GRK_TransformMat4 = glm::mat4;
+#else
+/// The scalar transforms are stored in.
+using GRK_TransformScalar = double;
+
+/// A stored transform vector.
+using GRK_TransformVec3 = glm::dvec3;
+
+/// A stored transform rotation.
+using GRK_TransformQuat = glm::dquat;
+
+/// A stored transform matrix.
+using GRK_TransformMat4 = glm::dmat4;
+#endif
+
+/**Whether a transform moves after it is spawned, see @link GRK_TransformComponent
+ * GRK_TransformComponent @endlink*/
+enum class GRK_TransformMobility {
+  Dynamic, ///< Recomputed by every tick's sweep when it or an ancestor changes.
+  Static   ///< Baked once into the manager's static partition and left out of the sweep.
+};
+
 /**
  * @brief The component that all entities have that determines their position in the game world.
  *
@@ -29,37 +74,74 @@ namespace Grok3d {
  *
  * Each TransformComponent has a parent they are relative to to facilitate chaining and relative
  * position, or creation of complex objects composed of multiple entities (such as a giant boss
- * with independent rotating turrets...or a boring old tank with a rotating cannon)*/
+ * with independent rotating turrets...or a boring old tank with a rotating cannon)
+ *
+ * The parent, first and last child and previous and next sibling are stored as entities and
+ * looked up through the manager's @link GRK_TransformHierarchy GRK_TransformHierarchy @endlink,
+ * so they survive the store moving components around and the component stays trivially
+ * copyable.  Only transforms owned by a manager can be linked.
+ *
+ * The local transform is a translation, a rotation (as a quaternion) and a scale, applied to
+ * points in scale, rotate, translate order, and the world transform is the parent's world matrix
+ * times the local matrix.
+ *
+ * The world matrix is cached.  Local changes mark the transform and all of its descendants
+ * dirty, and @link GRK_TransformComponent::UpdateWorldTransform UpdateWorldTransform @endlink
+ * (run over every transform once per tick by @link
+ * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink) brings
+ * the cache back up to date, so world queries between a tick and the next local change do not
+ * walk the parent chain.
+ *
+ * The world matrix from before the last tick's update is kept too, so frames rendered between
+ * ticks can be drawn part way from one to the other with @link
+ * GRK_TransformComponent::GetInterpolatedWorldMatrix GetInterpolatedWorldMatrix @endlink.
+ *
+ * A static transform, for level geometry that never moves after it is spawned, is not in the
+ * sweep at all.  It is baked into the manager's @link GRK_StaticTransformPartition
+ * GRK_StaticTransformPartition @endlink by the first sweep after it is created and never looked
+ * at again.  Changing one anyway rebakes it and its static descendants in the next sweep.  Its
+ * parent must be static too, and it is never interpolated.*/
 class GRK_TransformComponent {
  public:
   GRK_TransformComponent() noexcept;
 
+  /**A transform at the origin with the given mobility, which can not be changed later*/
+  explicit GRK_TransformComponent(GRK_TransformMobility mobility) noexcept;
+
   //Functions related to children and other relatives
 
-  //TODO as chaining lots of parents gets really big this will get slow, best to cache and have a dirty bit
   /**
    * @brief Attaches this TransformComponent to a new parent to be relative to.
    * @details
-   * calls @link GRK_TransformComponent::AttachChild AttachChild @endlink
-   * on the new parent
+   * detaches from the old parent and calls @link GRK_TransformComponent::AttachChild AttachChild
+   * @endlink on the new parent, then moves this and its descendants to their new depth in the
+   * @link GRK_TransformHierarchy GRK_TransformHierarchy @endlink
    *
-   * @param[in] newParent the parent that AttachChild will be called on*/
+   * @param[in] newParent the parent that AttachChild will be called on, nullptr to make this a
+   * root.  Nothing happens if it is not owned by the same manager as this, if this is static
+   * and it is not, or if it is this or one of this's descendants*/
   auto SetParent(GRK_TransformComponent* newParent) -> void;
 
   /**
-   * @brief Attaches a child to this parent
+   * @brief Attaches a child to this parent, after its existing children
    *
    * @param[in] newChild the child that will become relative to this parent*/
   auto AttachChild(GRK_TransformComponent* newChild) -> void;
 
+  /**The parent, nullptr for a root*/
+  auto GetParent() const -> GRK_TransformComponent*;
+
+  /**The entity of the parent, 0 for a root*/
+  auto GetParentEntity() const -> GRK_Entity;
+
   /**
    * @brief tests if this class is the child of another TransformComponent
    *
    * param[in] possibleParent The TransformComponent to test if we are the child of*/
   auto IsChildOf(const GRK_TransformComponent* const possibleParent) const -> bool;
 
-  /**Find the index you are in the parents pool of children*/
-  auto GetSiblingIndex() -> std::size_t; //use parent and iterate through the list looking for me
+  /**Find the index you are in the parents pool of children, -1 for a root*/
+  auto GetSiblingIndex() -> std::size_t;
 
   /**
    * @brief get the index in your pool of children for the child
@@ -73,7 +155,12 @@ class GRK_TransformComponent {
 
   //Functions related to position
 
-  /**Get the position relative to the origin of the scene*/
+  /**
+   * @brief Get the position relative to the origin of the scene
+   *
+   * @details
+   * Constant time when the cached world transform is up to date, otherwise it is recomputed up
+   * the parent chain without updating the cache so it stays safe to call on shared snapshots*/
   auto GetWorldPosition() const -> glm::dvec3;
 
   /**Set the position relative to the origin of the scene*/
@@ -88,6 +175,9 @@ class GRK_TransformComponent {
   /**@overload*/
   auto GetLocalPosition(glm::dvec3 v) -> void;
 
+  /**Set the position relative to the parent*/
+  auto SetLocalPosition(glm::dvec3 v) -> void;
+
   /**Change position relative to current position*/
   auto TranslateLocal(glm::dvec3 v) -> void;
 
@@ -105,29 +195,157 @@ class GRK_TransformComponent {
   /**@overload*/
   auto SetLocalScale(double x, double y, double z) -> void;
 
+  //Functions related to rotation
+
+  /**Get rotation of object relative to parent*/
+  auto GetLocalRotation() const -> glm::dquat;
+
+  /**Set rotation of object relative to parent, rotation must be normalized*/
+  auto SetLocalRotation(glm::dquat rotation) -> void;
+
+  /**Rotate relative to the current rotation, applied after it*/
+  auto RotateLocal(glm::dquat rotation) -> void;
+
+  /**@overload
+   * @param[in] angle radians around axis
+   * @param[in] axis normalized axis to rotate around*/
+  auto RotateLocal(double angle, glm::dvec3 axis) -> void;
+
+  //Functions related to matrices
+
+  /**The local translation * rotation * scale matrix*/
+  auto GetLocalMatrix() const -> glm::dmat4;
+
+  /**
+   * @brief The matrix from this transform's space to the scene's
+   *
+   * @details
+   * Like @link GRK_TransformComponent::GetWorldPosition GetWorldPosition @endlink this is the
+   * cached matrix unless the transform is dirty*/
+  auto GetWorldMatrix() const -> glm::dmat4;
+
+  /**
+   * @brief The world matrix part way from the previous tick's to the last tick's
+   *
+   * @details
+   * Translation and scale are interpolated linearly and rotation spherically, so this loses any
+   * shear a non uniformly scaled parent gives its children.  Transforms that did not change in
+   * the last tick, and transforms not owned by a manager, return their world matrix.
+   *
+   * @param[in] interpolation 0 for the previous tick's matrix to 1 for the last tick's, usually
+   * the time left over after the last tick divided by the tick period*/
+  auto GetInterpolatedWorldMatrix(double interpolation) const -> glm::dmat4;
+
   //functionality
 
   /**Detach all of the children from this parent*/
   auto DetachChildren() -> void;
 
-  /**Get a child by index*/
+  /**Get a child by index, nullptr if there are not that many*/
   auto GetChild(unsigned int index) const -> GRK_TransformComponent*;
 
+  //Functions related to the cached world transform
+
+  /**
+   * @brief Keeps hierarchy's level for owner up to date with this transform's depth from now on
+   *
+   * @details
+   * Called by the @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink when
+   * the transform is added to an entity*/
+  auto JoinHierarchy(GRK_TransformHierarchy* hierarchy, GRK_Entity owner) -> void;
+
+  auto IsStatic() const -> bool;
+
+  /**Number of ancestors, 0 for a root*/
+  auto GetHierarchyDepth() const -> std::size_t;
+
+  /**true if a local change to this or an ancestor has not been propagated to the cached world
+   * transform yet*/
+  auto IsWorldDirty() const -> bool;
+
+  /**The @link GRK_TransformHierarchy::GetTick tick @endlink whose update last recomputed the
+   * world transform, 0 if it never was*/
+  auto GetWorldTick() const -> std::uint64_t;
+
+  /**Brings the cached world transform up to date, updating dirty ancestors first.  Each dirty
+   * transform is only recomputed once no matter how many descendants it has*/
+  auto UpdateWorldTransform() -> void;
+
  private:
-  /// The parent of this TransformComponent.
-  GRK_TransformComponent* parent_;
+  /// The batch calls write local positions first and mark them dirty in one pass after.
+  template<class...>
+  friend class GRK_EntityComponentManager__;
+
+  /**The local matrix at storage precision*/
+  auto LocalMatrix() const -> GRK_TransformMat4;
+
+  /**The transform of entity in the same manager, nullptr for 0*/
+  auto Resolve(GRK_Entity entity) const -> GRK_TransformComponent*;
+
+  /**Removes this from its parent's children, leaving it without a parent*/
+  auto DetachFromParent() -> void;
+
+  /**Sets the depth of this and the depths below it of every descendant*/
+  auto SetHierarchyDepth(std::size_t depth) -> void;
+
+  /**Marks this and every descendant as needing its world transform recomputed*/
+  auto MarkWorldDirty() -> void;
 
-  /// The vector of children who are positioned relative to this TransformComponent.
-  std::vector<GRK_TransformComponent*> children_;
+  /**The world matrix from the parent's, recursing while the parent is dirty*/
+  auto ComputeWorldMatrix() const -> GRK_TransformMat4;
 
+ private:
   /// Position relative to parent TransformComponent.
-  glm::dvec3 localPosition_;
+  GRK_TransformVec3 localPosition_;
 
   /// Scale relative to parent TransformComponent.
-  glm::dvec3 localScale_;
+  GRK_TransformVec3 localScale_;
+
+  /// Rotation relative to parent TransformComponent.
+  GRK_TransformQuat localRotation_;
+
+  /// From this transform's space to the scene's, valid unless worldDirty_.
+  GRK_TransformMat4 worldMatrix_;
+
+  /// worldMatrix_ as it was before the update of tick worldTick_.
+  GRK_TransformMat4 previousWorldMatrix_;
+
+  /// The tick worldMatrix_ was last updated in, 0 if it never has been.
+  std::uint64_t worldTick_;
+
+  /// Set by local changes to this or an ancestor, a dirty transform's descendants are all dirty.
+  bool worldDirty_;
+
+  /// Baked into the static partition instead of swept, see GRK_TransformMobility.
+  bool isStatic_;
+
+  /// The depth levels this transform is kept in, nullptr if it is not owned by a manager.
+  GRK_TransformHierarchy* hierarchy_;
 
-  //TODO rotation as quaternion
+  /// The entity this transform belongs to in hierarchy_.
+  GRK_Entity owner_;
+
+  /// Number of ancestors.
+  std::size_t depth_;
+
+  /// The entity of the parent of this TransformComponent, 0 for none.
+  GRK_Entity parent_;
+
+  /// The first and last of the children who are positioned relative to this, 0 for none.
+  GRK_Entity firstChild_, lastChild_;
+
+  /// The siblings before and after this in the parent's children, 0 for none.
+  GRK_Entity previousSibling_, nextSibling_;
+
+  /// Number of children.
+  std::uint32_t childCount_;
+
+  /// Index of this in the parent's children.
+  std::uint32_t siblingIndex_;
 };
+
+static_assert(std::is_trivially_copyable<GRK_TransformComponent>::value,
+              "GRK_TransformComponent is moved around its store with plain copies");
 }
 
 #endif
@@ -120,6 +120,28 @@ class GRK_EntityHandle__ {
             return ((components & componentBits) == componentBits));
   }
 
+  /**Disable the entity, see @link GRK_EntityComponentManager__::SetEntityEnabled
+   * SetEntityEnabled @endlink*/
+  auto Disable() -> GRK_Result {
+    RETURN_FAILURE_IF_ENTITY_DESTROYED(
+        GRK_Result::NoSuchEntity,
+        return manager_->SetEntityEnabled(entity_, false););
+  }
+
+  /**Enable the entity again after @link GRK_EntityHandle__::Disable Disable @endlink*/
+  auto Enable() -> GRK_Result {
+    RETURN_FAILURE_IF_ENTITY_DESTROYED(
+        GRK_Result::NoSuchEntity,
+        return manager_->SetEntityEnabled(entity_, true););
+  }
+
+  /**false if the entity is disabled or destroyed*/
+  auto IsEnabled() const -> bool {
+    RETURN_FAILURE_IF_ENTITY_DESTROYED(
+        false,
+        return (manager_->GetEntityComponentsBitMask(entity_) & kDisabledEntityMask) == 0);
+  }
+
   auto operator==(const GRK_EntityHandle__<ECM>& rhs) const -> bool {
     return this->entity_ == rhs.entity_;
   }
@@ -0,0 +1,141 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * A flat hash map from symbols to entities*/
+
+#ifndef __SYMBOLINDEX__H
+#define __SYMBOLINDEX__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/name/SymbolTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief An open addressing hash map from @link GRK_Symbol GRK_Symbol @endlink to entity
+ *
+ * @details
+ * The slots are one flat array probed linearly, so a lookup is a multiply, a shift and
+ * (usually) one cache line, and never allocates.  Removal shifts the following entries of the
+ * probe run back instead of leaving tombstones, so lookups stay short under churn.  The table
+ * doubles when it is more than half full.*/
+class GRK_SymbolIndex {
+ public:
+  /**The entity with symbol, 0 if there is none*/
+  auto Find(GRK_Symbol symbol) const -> GRK_Entity {
+    if (slots_.empty() || symbol == kNoSymbol) {
+      return 0;
+    }
+
+    for (auto slot = HomeSlot(symbol);; slot = NextSlot(slot)) {
+      if (slots_[slot].symbol == symbol) {
+        return slots_[slot].entity;
+      } else if (slots_[slot].symbol == kNoSymbol) {
+        return 0;
+      }
+    }
+  }
+
+  /**Maps symbol to entity, replacing what it mapped to before*/
+  auto Put(GRK_Symbol symbol, GRK_Entity entity) -> void {
+    if (symbol == kNoSymbol) {
+      return;
+    }
+
+    if ((size_ + 1) * 2 > slots_.size()) {
+      Grow();
+    }
+
+    auto slot = HomeSlot(symbol);
+    while (slots_[slot].symbol != kNoSymbol && slots_[slot].symbol != symbol) {
+      slot = NextSlot(slot);
+    }
+
+    if (slots_[slot].symbol == kNoSymbol) {
+      size_++;
+    }
+    slots_[slot] = Slot{symbol, entity};
+  }
+
+  /**Removes symbol if it is in the index*/
+  auto Erase(GRK_Symbol symbol) -> void {
+    if (slots_.empty() || symbol == kNoSymbol) {
+      return;
+    }
+
+    auto hole = HomeSlot(symbol);
+    while (slots_[hole].symbol != symbol) {
+      if (slots_[hole].symbol == kNoSymbol) {
+        return;
+      }
+      hole = NextSlot(hole);
+    }
+
+    // Pull back every later entry of the run that may sit at or before the hole.
+    for (auto slot = NextSlot(hole); slots_[slot].symbol != kNoSymbol; slot = NextSlot(slot)) {
+      const auto home = HomeSlot(slots_[slot].symbol);
+      const auto distanceToSlot = (slot - home) & Mask();
+      const auto distanceToHole = (hole - home) & Mask();
+      if (distanceToHole < distanceToSlot) {
+        slots_[hole] = slots_[slot];
+        hole = slot;
+      }
+    }
+
+    slots_[hole] = Slot{};
+    size_--;
+  }
+
+  auto Size() const -> std::size_t { return size_; }
+
+ private:
+  struct Slot {
+    GRK_Symbol symbol = kNoSymbol;
+    GRK_Entity entity = 0;
+  };
+
+  auto Mask() const -> std::size_t { return slots_.size() - 1; }
+
+  /**Fibonacci hashing, symbols are handed out in sequence so they need spreading out*/
+  auto HomeSlot(GRK_Symbol symbol) const -> std::size_t {
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(symbol) * 0x9E3779B97F4A7C15u) >> (64u - shift_));
+  }
+
+  auto NextSlot(std::size_t slot) const -> std::size_t { return (slot + 1) & Mask(); }
+
+  auto Grow() -> void {
+    std::vector<Slot> oldSlots(slots_.empty() ? 16 : slots_.size() * 2);
+    oldSlots.swap(slots_);
+    shift_ = 0;
+    while ((std::size_t{1} << shift_) < slots_.size()) {
+      shift_++;
+    }
+
+    size_ = 0;
+    for (const auto& slot : oldSlots) {
+      if (slot.symbol != kNoSymbol) {
+        Put(slot.symbol, slot.entity);
+      }
+    }
+  }
+
+ private:
+  /// The table, its size is a power of two.
+  std::vector<Slot> slots_;
+
+  /// log2 of the table size.
+  unsigned int shift_ = 0;
+
+  /// Number of used slots.
+  std::size_t size_ = 0;
+};
+} /*Grok3d*/
+
+#endif
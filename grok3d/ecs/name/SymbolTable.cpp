@@ -0,0 +1,47 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+#include "grok3d/ecs/name/SymbolTable.h"
+
+using namespace Grok3d;
+
+auto GRK_SymbolTable::Global() -> GRK_SymbolTable& {
+  static GRK_SymbolTable table;
+  return table;
+}
+
+auto GRK_SymbolTable::Intern(const std::string_view name) -> GRK_Symbol {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto symbolIt = symbols_.find(name);
+  if (symbolIt != symbols_.end()) {
+    return symbolIt->second;
+  }
+
+  strings_.emplace_back(name);
+  const auto symbol = static_cast<GRK_Symbol>(strings_.size());
+  symbols_.emplace(strings_.back(), symbol);
+  return symbol;
+}
+
+auto GRK_SymbolTable::Find(const std::string_view name) const -> GRK_Symbol {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto symbolIt = symbols_.find(name);
+  return symbolIt == symbols_.end() ? kNoSymbol : symbolIt->second;
+}
+
+auto GRK_SymbolTable::GetString(const GRK_Symbol symbol) const -> std::string_view {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (symbol == kNoSymbol || symbol > strings_.size()) {
+    return {};
+  }
+  return strings_[symbol - 1];
+}
+
+auto GRK_SymbolTable::Size() const -> std::size_t {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return strings_.size();
+}
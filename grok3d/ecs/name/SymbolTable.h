@@ -0,0 +1,68 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Interning of strings into small integer symbols*/
+
+#ifndef __SYMBOLTABLE__H
+#define __SYMBOLTABLE__H
+
+#include "grok3d/grok3d_types.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Grok3d {
+/// An interned string, equal symbols are equal strings.
+using GRK_Symbol = std::uint32_t;
+
+/// The symbol no string is interned as.
+constexpr GRK_Symbol kNoSymbol = 0;
+
+/**
+ * @brief Maps strings to @link GRK_Symbol GRK_Symbol @endlink s and back
+ *
+ * @details
+ * Interning a string the first time copies it into the table, after that the same string always
+ * gives the same symbol and comparing or hashing names is comparing integers.  Strings are never
+ * removed so a symbol stays valid for the life of the program.
+ *
+ * @link GRK_SymbolTable::Find Find @endlink only looks strings up and never allocates, use it on
+ * paths that run every frame.  All functions are safe to call from any thread.*/
+class GRK_SymbolTable {
+ public:
+  /**The table shared by the whole engine, used by @link GRK_NameComponent GRK_NameComponent
+   * @endlink*/
+  static auto Global() -> GRK_SymbolTable&;
+
+  /**The symbol for name, adding name to the table if it is not in it yet*/
+  auto Intern(std::string_view name) -> GRK_Symbol;
+
+  /**The symbol for name, or kNoSymbol if it was never interned*/
+  auto Find(std::string_view name) const -> GRK_Symbol;
+
+  /**The string symbol was interned from, empty for kNoSymbol or an unknown symbol*/
+  auto GetString(GRK_Symbol symbol) const -> std::string_view;
+
+  /**Number of interned strings*/
+  auto Size() const -> std::size_t;
+
+ private:
+  /// Guards both containers.
+  mutable std::mutex mutex_;
+
+  /// strings_[symbol - 1] is the string of symbol, a deque so the strings never move.
+  std::deque<std::string> strings_;
+
+  /// Views into strings_ to their symbol.
+  std::unordered_map<std::string_view, GRK_Symbol> symbols_;
+};
+} /*Grok3d*/
+
+#endif
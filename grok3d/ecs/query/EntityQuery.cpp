@@ -0,0 +1,53 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+#include "grok3d/ecs/query/EntityQuery.h"
+
+using namespace Grok3d;
+
+GRK_EntityQuery::GRK_EntityQuery(GRK_QuerySignature signature) noexcept : signature_(signature) {
+}
+
+auto GRK_EntityQuery::Contains(const GRK_Entity entity) const -> bool {
+  return entityIndexMap_.find(entity) != entityIndexMap_.end();
+}
+
+auto GRK_EntityQuery::OnEntityMaskChanged(
+    const GRK_Entity entity,
+    const GRK_ComponentBitMask oldMask,
+    const GRK_ComponentBitMask newMask) -> void {
+  const auto matched = signature_.Matches(oldMask);
+  const auto matches = signature_.Matches(newMask);
+
+  if (matches && !matched) {
+    Add(entity);
+  } else if (matched && !matches) {
+    Remove(entity);
+  }
+}
+
+auto GRK_EntityQuery::Add(const GRK_Entity entity) -> void {
+  if (entityIndexMap_.find(entity) != entityIndexMap_.end()) {
+    return;
+  }
+
+  entityIndexMap_[entity] = entities_.size();
+  entities_.push_back(entity);
+}
+
+auto GRK_EntityQuery::Remove(const GRK_Entity entity) -> void {
+  auto indexIt = entityIndexMap_.find(entity);
+  if (indexIt == entityIndexMap_.end()) {
+    return;
+  }
+
+  // Move the last entity into the hole so the list stays dense.
+  const auto removeIndex = indexIt->second;
+  const auto lastEntity = entities_.back();
+  entities_[removeIndex] = lastEntity;
+  entityIndexMap_[lastEntity] = removeIndex;
+
+  entities_.pop_back();
+  entityIndexMap_.erase(entity);
+}
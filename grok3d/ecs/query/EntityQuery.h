@@ -0,0 +1,115 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Cached, incrementally maintained lists of entities matching a component signature*/
+
+#ifndef __ENTITYQUERY__H
+#define __ENTITYQUERY__H
+
+#include "grok3d/grok3d_types.h"
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief Which components an entity must and must not have to be matched by a query
+ *
+ * @details
+ * For example "has Transform and Render but not Static" is
+ * <code>{TransformMask | RenderMask, StaticMask}</code>.*/
+struct GRK_QuerySignature {
+  /// Every one of these components is required.
+  GRK_ComponentBitMask include;
+
+  /// None of these components may be present.
+  GRK_ComponentBitMask exclude;
+
+  /**true if an entity with the components in mask is matched, an entity without any
+   * components (deleted or not yet set up) never is.  Disabled entities are only matched if
+   * include has kDisabledEntityMask*/
+  constexpr auto Matches(GRK_ComponentBitMask mask) const -> bool {
+    const auto effectiveExclude = exclude | (kDisabledEntityMask & ~include);
+    return mask != 0 && (mask & include) == include && (mask & effectiveExclude) == 0;
+  }
+
+  constexpr auto operator==(const GRK_QuerySignature& rhs) const -> bool {
+    return include == rhs.include && exclude == rhs.exclude;
+  }
+};
+
+/**
+ * @brief The entities matching one @link GRK_QuerySignature GRK_QuerySignature @endlink
+ *
+ * @details
+ * Queries are created and owned by the @link GRK_EntityComponentManager__
+ * GRK_EntityComponentManager__ @endlink (see @link GRK_EntityComponentManager__::GetQuery
+ * GetQuery @endlink), which scans the existing entities once when the query is made and from
+ * then on only tells it about entities whose component mask changed.  Any number of systems can
+ * hold a pointer to the same query, asking for a signature twice returns the same object.
+ *
+ * The matched entities are kept in a dense vector so iterating them is a linear walk.  Removal
+ * moves the last entity into the hole so the order is not stable, and like the component stores
+ * adding or removing components that the query depends on while iterating it invalidates the
+ * iteration, defer those changes until after the loop.*/
+class GRK_EntityQuery {
+ public:
+  explicit GRK_EntityQuery(GRK_QuerySignature signature) noexcept;
+
+  auto GetSignature() const -> const GRK_QuerySignature& { return signature_; }
+
+  /**The matched entities, in no particular order*/
+  auto GetEntities() const -> const std::vector<GRK_Entity>& { return entities_; }
+
+  auto Size() const -> std::size_t { return entities_.size(); }
+
+  auto Contains(GRK_Entity entity) const -> bool;
+
+  auto begin() const -> std::vector<GRK_Entity>::const_iterator { return entities_.begin(); }
+
+  auto end() const -> std::vector<GRK_Entity>::const_iterator { return entities_.end(); }
+
+  /**
+   * @brief Updates the match for an entity whose component mask changed from oldMask to newMask
+   *
+   * @details
+   * Called by the manager, this is a no-op unless the entity started or stopped matching.  A
+   * deleted entity's mask goes to 0 which removes it*/
+  auto OnEntityMaskChanged(GRK_Entity entity, GRK_ComponentBitMask oldMask, GRK_ComponentBitMask newMask) -> void;
+
+ private:
+  auto Add(GRK_Entity entity) -> void;
+
+  auto Remove(GRK_Entity entity) -> void;
+
+ private:
+  /// What this query matches.
+  GRK_QuerySignature signature_;
+
+  /// The matched entities.
+  std::vector<GRK_Entity> entities_;
+
+  /// Entity to its index in entities_, for constant time removal.
+  std::unordered_map<GRK_Entity, std::size_t> entityIndexMap_;
+};
+} /*Grok3d*/
+
+namespace std {
+/*hash function for GRK_QuerySignature, mixes the two masks*/
+template<>
+struct hash<Grok3d::GRK_QuerySignature> {
+  using argument_type = Grok3d::GRK_QuerySignature;
+  using result_type = std::size_t;
+
+  auto operator()(argument_type const& s) const -> result_type {
+    return std::hash<std::size_t>{}(s.include) ^ (std::hash<std::size_t>{}(s.exclude) * 31u);
+  }
+};
+}
+
+#endif
@@ -0,0 +1,138 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Immutable copies of component stores that other threads can read while the world changes*/
+
+#ifndef __WORLDSNAPSHOT__H
+#define __WORLDSNAPSHOT__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/store/ComponentStore.h"
+#include "grok3d/ecs/store/EntityIndex.h"
+
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace Grok3d {
+/**
+ * @brief An immutable copy of one component store and its entity to index map
+ *
+ * @details
+ * Snapshots of stores that did not change between two publishes are the same object, so
+ * holding on to one costs nothing extra until the store is written to again.
+ *
+ * @tparam ComponentType the component type of the copied store*/
+template<class ComponentType>
+class GRK_StoreSnapshot {
+ public:
+  using Store = GRK_ComponentStore<ComponentType>;
+  using EntityIndex = GRK_EntityIndex<ComponentType>;
+
+  GRK_StoreSnapshot(std::uint64_t version, Store store, const EntityIndex& entityIndex) :
+      version_(version),
+      store_(std::move(store)),
+      entityIndex_(entityIndex) {
+  }
+
+  /**The write version of the live store this was copied at*/
+  auto GetVersion() const -> std::uint64_t { return version_; }
+
+  /**The copied store, in the order the live store was in*/
+  auto GetStore() const -> const Store& { return store_; }
+
+  auto Size() const -> std::size_t { return store_.size(); }
+
+  /**The entity owning the component at index*/
+  auto EntityAt(std::size_t index) const -> GRK_Entity { return entityIndex_.reverse_at(index); }
+
+  /**entity's component, or nullptr if it did not have one when the snapshot was taken*/
+  auto GetComponent(GRK_Entity entity) const -> const ComponentType* {
+    static_assert(!GRK_UseSoALayout<ComponentType>::value,
+                  "Components stored as struct of arrays have no address, index GetStore instead");
+    return entityIndex_.contains(entity) ? &store_[entityIndex_.at(entity)] : nullptr;
+  }
+
+ private:
+  /// The live store's write version at the time of the copy.
+  std::uint64_t version_;
+
+  /// The copied components.
+  Store store_;
+
+  /// The copied entity to index lookup.
+  EntityIndex entityIndex_;
+};
+
+/**
+ * @brief A consistent, read only view of the world at the moment it was published
+ *
+ * @details
+ * Made by @link GRK_EntityComponentManager__::PublishSnapshot PublishSnapshot @endlink on the
+ * main thread and handed out to any thread by @link GRK_EntityComponentManager__::AcquireSnapshot
+ * AcquireSnapshot @endlink.  Nothing in it is ever modified after it is published so any number
+ * of threads can read it without locks while the main thread keeps updating the live world.  It
+ * is freed when the last reader lets go of its shared_ptr.
+ *
+ * Only the component types named when publishing are captured, @link
+ * GRK_WorldSnapshot__::GetStore GetStore @endlink returns nullptr for the others.  The
+ * components are plain copies, so anything they point at is still the live object and must not
+ * be followed from another thread.  GRK_TransformComponent copies are detached from the live
+ * hierarchy instead: their world matrices are brought up to date when they are copied, they keep
+ * their parent and children only as entities (GetParentEntity), and GetParent, GetChild and
+ * GetInterpolatedWorldMatrix act as if the transform had no manager.
+ *
+ * @tparam ComponentTypes the component types of the @link GRK_EntityComponentManager__
+ * GRK_EntityComponentManager__ @endlink*/
+template<class... ComponentTypes>
+class GRK_WorldSnapshot__ {
+ public:
+  using EntityMaskMap = std::unordered_map<GRK_Entity, GRK_ComponentBitMask>;
+
+  /**Counts up by one with every publish*/
+  auto GetSequence() const -> std::uint64_t { return sequence_; }
+
+  /**The snapshot of ComponentType's store, nullptr if it was not captured*/
+  template<class ComponentType>
+  auto GetStore() const -> const GRK_StoreSnapshot<ComponentType>* {
+    return std::get<std::shared_ptr<const GRK_StoreSnapshot<ComponentType>>>(stores_).get();
+  }
+
+  /**entity's component, or nullptr if it had none or ComponentType was not captured*/
+  template<class ComponentType>
+  auto GetComponent(GRK_Entity entity) const -> const ComponentType* {
+    const auto* store = GetStore<ComponentType>();
+    return store == nullptr ? nullptr : store->GetComponent(entity);
+  }
+
+  /**The component bit mask entity had, 0 if it did not exist*/
+  auto GetEntityComponentsBitMask(GRK_Entity entity) const -> GRK_ComponentBitMask {
+    const auto maskIt = entityMasks_->find(entity);
+    return maskIt == entityMasks_->end() ? 0 : maskIt->second;
+  }
+
+ private:
+  template<class...>
+  friend class GRK_EntityComponentManager__;
+
+  /// Which publish this is.
+  std::uint64_t sequence_ = 0;
+
+  /// The version of the mask map entityMasks_ was copied at.
+  std::uint64_t entityMasksVersion_ = 0;
+
+  /// Every entity's component mask.
+  std::shared_ptr<const EntityMaskMap> entityMasks_;
+
+  /// The captured stores, null for types that were not asked for.
+  std::tuple<std::shared_ptr<const GRK_StoreSnapshot<ComponentTypes>>...> stores_;
+};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,164 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Axis aligned boxes, rays and frustums for spatial queries*/
+
+#ifndef __AABB__H
+#define __AABB__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace Grok3d {
+/**An axis aligned bounding box, empty when any component of min is greater than max*/
+struct GRK_AABB {
+  glm::dvec3 min;
+  glm::dvec3 max;
+
+  auto Overlaps(const GRK_AABB& other) const -> bool {
+    return min.x <= other.max.x && other.min.x <= max.x &&
+        min.y <= other.max.y && other.min.y <= max.y &&
+        min.z <= other.max.z && other.min.z <= max.z;
+  }
+
+  /**true if other is entirely inside this*/
+  auto Contains(const GRK_AABB& other) const -> bool {
+    return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+        other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+  }
+
+  /**The smallest box containing this and other*/
+  auto Merged(const GRK_AABB& other) const -> GRK_AABB {
+    return GRK_AABB{glm::min(min, other.min), glm::max(max, other.max)};
+  }
+
+  /**This grown by margin on every side*/
+  auto Expanded(double margin) const -> GRK_AABB {
+    return GRK_AABB{min - glm::dvec3(margin), max + glm::dvec3(margin)};
+  }
+
+  /**Half the surface area, the cost the tree minimizes when picking where to insert*/
+  auto HalfArea() const -> double {
+    const auto extent = max - min;
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+  }
+
+  /**
+   * @brief The box around this box transformed by matrix
+   *
+   * @details
+   * The center is transformed as a point and the half extents by the absolute value of the
+   * upper 3x3, so this is exact for the eight corners without transforming each of them*/
+  auto Transformed(const glm::dmat4& matrix) const -> GRK_AABB {
+    const auto center = (min + max) * 0.5;
+    const auto halfExtent = (max - min) * 0.5;
+
+    glm::dvec3 newCenter(matrix[3]);
+    glm::dvec3 newHalfExtent(0);
+    for (int column = 0; column < 3; column++) {
+      newCenter += glm::dvec3(matrix[column]) * center[column];
+      newHalfExtent += glm::abs(glm::dvec3(matrix[column])) * halfExtent[column];
+    }
+
+    return GRK_AABB{newCenter - newHalfExtent, newCenter + newHalfExtent};
+  }
+};
+
+/**A half line from origin along direction, which does not have to be normalized*/
+struct GRK_Ray {
+  glm::dvec3 origin;
+  glm::dvec3 direction;
+
+  /**
+   * @brief true if the ray enters box at or before maxDistance times the length of direction
+   *
+   * @details
+   * The slab test, with the inverse direction taken per call.  A ray starting inside box always
+   * hits it*/
+  auto Hits(const GRK_AABB& box, double maxDistance) const -> bool {
+    auto entry = 0.0;
+    auto exit = maxDistance;
+    for (int axis = 0; axis < 3; axis++) {
+      if (direction[axis] == 0) {
+        if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis]) {
+          return false;
+        }
+        continue;
+      }
+
+      const auto inverse = 1.0 / direction[axis];
+      auto slabEntry = (box.min[axis] - origin[axis]) * inverse;
+      auto slabExit = (box.max[axis] - origin[axis]) * inverse;
+      if (slabEntry > slabExit) {
+        std::swap(slabEntry, slabExit);
+      }
+
+      entry = std::max(entry, slabEntry);
+      exit = std::min(exit, slabExit);
+      if (entry > exit) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+};
+
+/**
+ * @brief The six planes bounding a view volume
+ *
+ * @details
+ * Each plane is (normal, distance) with the normal pointing into the volume, a point p is inside
+ * a plane when dot(normal, p) + distance >= 0.*/
+struct GRK_Frustum {
+  std::array<glm::dvec4, 6> planes;
+
+  /**
+   * @brief The frustum of an OpenGL style projection * view matrix
+   *
+   * @details
+   * Gribb and Hartmann's extraction, the planes are the sums and differences of the matrix's
+   * fourth row with the other three, for clip space z from -1 to 1*/
+  static auto FromMatrix(const glm::dmat4& projectionView) -> GRK_Frustum {
+    auto row = [&projectionView](int i) {
+      return glm::dvec4(projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i]);
+    };
+
+    const auto w = row(3);
+    GRK_Frustum frustum{};
+    for (int axis = 0; axis < 3; axis++) {
+      const auto r = row(axis);
+      frustum.planes[2 * axis] = glm::dvec4(w.x + r.x, w.y + r.y, w.z + r.z, w.w + r.w);
+      frustum.planes[2 * axis + 1] = glm::dvec4(w.x - r.x, w.y - r.y, w.z - r.z, w.w - r.w);
+    }
+    return frustum;
+  }
+
+  /**false only if box is entirely outside one of the planes, so boxes near the corners of the
+   * frustum can be let through*/
+  auto Intersects(const GRK_AABB& box) const -> bool {
+    for (const auto& plane : planes) {
+      //the corner furthest along the plane's normal
+      const glm::dvec3 corner(
+          plane.x >= 0 ? box.max.x : box.min.x,
+          plane.y >= 0 ? box.max.y : box.min.y,
+          plane.z >= 0 ? box.max.z : box.min.z);
+      if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,283 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "grok3d/ecs/spatial/AABBTree.h"
+
+#include <algorithm>
+
+using namespace Grok3d;
+
+GRK_AABBTree::GRK_AABBTree(const double margin) noexcept :
+    root_(kNullNode),
+    freeList_(kNullNode),
+    proxyCount_(0),
+    margin_(margin) {
+}
+
+auto GRK_AABBTree::CreateProxy(const GRK_AABB& bounds, const GRK_Entity entity) -> std::int32_t {
+  const auto proxy = AllocateNode();
+  auto& node = nodes_[proxy];
+  node.box = bounds.Expanded(margin_);
+  node.bounds = bounds;
+  node.entity = entity;
+  node.height = 0;
+
+  InsertLeaf(proxy);
+  proxyCount_++;
+  return proxy;
+}
+
+auto GRK_AABBTree::DestroyProxy(const std::int32_t proxy) -> void {
+  RemoveLeaf(proxy);
+  FreeNode(proxy);
+  proxyCount_--;
+}
+
+auto GRK_AABBTree::MoveProxy(const std::int32_t proxy, const GRK_AABB& bounds) -> bool {
+  auto& node = nodes_[proxy];
+  node.bounds = bounds;
+  if (node.box.Contains(bounds)) {
+    return false;
+  }
+
+  RemoveLeaf(proxy);
+  nodes_[proxy].box = bounds.Expanded(margin_);
+  InsertLeaf(proxy);
+  return true;
+}
+
+auto GRK_AABBTree::QueryOverlaps(const GRK_AABB& box, notstd::span<GRK_Entity> results) const -> std::size_t {
+  return Query([&box](const GRK_AABB& nodeBox) { return nodeBox.Overlaps(box); }, results);
+}
+
+auto GRK_AABBTree::QueryRay(
+    const GRK_Ray& ray,
+    const double maxDistance,
+    notstd::span<GRK_Entity> results) const -> std::size_t {
+  return Query([&ray, maxDistance](const GRK_AABB& nodeBox) { return ray.Hits(nodeBox, maxDistance); }, results);
+}
+
+auto GRK_AABBTree::QueryFrustum(const GRK_Frustum& frustum, notstd::span<GRK_Entity> results) const -> std::size_t {
+  return Query([&frustum](const GRK_AABB& nodeBox) { return frustum.Intersects(nodeBox); }, results);
+}
+
+auto GRK_AABBTree::Validate() const -> bool {
+  std::size_t leafCount = 0;
+  if (root_ != kNullNode && nodes_[root_].parent != kNullNode) {
+    return false;
+  }
+  return ValidateNode(root_, leafCount) && leafCount == proxyCount_;
+}
+
+auto GRK_AABBTree::AllocateNode() -> std::int32_t {
+  if (freeList_ == kNullNode) {
+    nodes_.emplace_back();
+    freeList_ = static_cast<std::int32_t>(nodes_.size() - 1);
+    nodes_[freeList_].parent = kNullNode;
+  }
+
+  const auto index = freeList_;
+  auto& node = nodes_[index];
+  freeList_ = node.parent;
+  node.parent = kNullNode;
+  node.child1 = kNullNode;
+  node.child2 = kNullNode;
+  node.entity = 0;
+  node.height = 0;
+  return index;
+}
+
+auto GRK_AABBTree::FreeNode(const std::int32_t node) -> void {
+  nodes_[node].parent = freeList_;
+  nodes_[node].height = -1;
+  freeList_ = node;
+}
+
+auto GRK_AABBTree::InsertLeaf(const std::int32_t leaf) -> void {
+  if (root_ == kNullNode) {
+    root_ = leaf;
+    nodes_[root_].parent = kNullNode;
+    return;
+  }
+
+  //descend to the sibling whose union with the leaf adds the least area to the tree, stopping
+  //early when making a new parent here is cheaper than pushing the leaf into either child
+  const auto leafBox = nodes_[leaf].box;
+  auto index = root_;
+  while (!nodes_[index].IsLeaf()) {
+    const auto& node = nodes_[index];
+    const auto area = node.box.HalfArea();
+    const auto combinedArea = node.box.Merged(leafBox).HalfArea();
+
+    const auto cost = 2.0 * combinedArea;
+    const auto inheritedCost = 2.0 * (combinedArea - area);
+    auto childCost = [this, &leafBox, inheritedCost](std::int32_t child) {
+      const auto& childNode = nodes_[child];
+      const auto mergedArea = childNode.box.Merged(leafBox).HalfArea();
+      return childNode.IsLeaf()
+             ? mergedArea + inheritedCost
+             : mergedArea - childNode.box.HalfArea() + inheritedCost;
+    };
+
+    const auto cost1 = childCost(node.child1);
+    const auto cost2 = childCost(node.child2);
+    if (cost < cost1 && cost < cost2) {
+      break;
+    }
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  const auto sibling = index;
+  const auto oldParent = nodes_[sibling].parent;
+  const auto newParent = AllocateNode();
+  nodes_[newParent].parent = oldParent;
+  nodes_[newParent].box = leafBox.Merged(nodes_[sibling].box);
+  nodes_[newParent].height = nodes_[sibling].height + 1;
+  nodes_[newParent].child1 = sibling;
+  nodes_[newParent].child2 = leaf;
+  nodes_[sibling].parent = newParent;
+  nodes_[leaf].parent = newParent;
+
+  if (oldParent == kNullNode) {
+    root_ = newParent;
+  } else if (nodes_[oldParent].child1 == sibling) {
+    nodes_[oldParent].child1 = newParent;
+  } else {
+    nodes_[oldParent].child2 = newParent;
+  }
+
+  RefitAncestors(newParent);
+}
+
+auto GRK_AABBTree::RemoveLeaf(const std::int32_t leaf) -> void {
+  if (leaf == root_) {
+    root_ = kNullNode;
+    return;
+  }
+
+  //the sibling takes the parent's place
+  const auto parent = nodes_[leaf].parent;
+  const auto grandParent = nodes_[parent].parent;
+  const auto sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+  nodes_[sibling].parent = grandParent;
+  if (grandParent == kNullNode) {
+    root_ = sibling;
+  } else if (nodes_[grandParent].child1 == parent) {
+    nodes_[grandParent].child1 = sibling;
+  } else {
+    nodes_[grandParent].child2 = sibling;
+  }
+  FreeNode(parent);
+
+  RefitAncestors(grandParent);
+}
+
+auto GRK_AABBTree::RefitAncestors(std::int32_t index) -> void {
+  while (index != kNullNode) {
+    index = Balance(index);
+
+    auto& node = nodes_[index];
+    const auto& child1 = nodes_[node.child1];
+    const auto& child2 = nodes_[node.child2];
+    node.height = 1 + std::max(child1.height, child2.height);
+    node.box = child1.box.Merged(child2.box);
+
+    index = node.parent;
+  }
+}
+
+auto GRK_AABBTree::Balance(const std::int32_t iA) -> std::int32_t {
+  auto& a = nodes_[iA];
+  if (a.IsLeaf() || a.height < 2) {
+    return iA;
+  }
+
+  const auto iB = a.child1;
+  const auto iC = a.child2;
+  auto& b = nodes_[iB];
+  auto& c = nodes_[iC];
+  const auto balance = c.height - b.height;
+
+  //takes child's place under a's parent, a becomes its child
+  auto promote = [this, iA, &a](std::int32_t iChild, Node& child) {
+    child.child1 = iA;
+    child.parent = a.parent;
+    a.parent = iChild;
+
+    if (child.parent == kNullNode) {
+      root_ = iChild;
+    } else if (nodes_[child.parent].child1 == iA) {
+      nodes_[child.parent].child1 = iChild;
+    } else {
+      nodes_[child.parent].child2 = iChild;
+    }
+  };
+
+  if (balance > 1) {
+    //c is taller, it moves up keeping its taller child and a takes the other
+    const auto iF = c.child1;
+    const auto iG = c.child2;
+    auto& f = nodes_[iF];
+    auto& g = nodes_[iG];
+    promote(iC, c);
+
+    const auto keepF = f.height > g.height;
+    const auto iKept = keepF ? iF : iG;
+    const auto iMoved = keepF ? iG : iF;
+    c.child2 = iKept;
+    a.child2 = iMoved;
+    nodes_[iMoved].parent = iA;
+    a.box = b.box.Merged(nodes_[iMoved].box);
+    c.box = a.box.Merged(nodes_[iKept].box);
+    a.height = 1 + std::max(b.height, nodes_[iMoved].height);
+    c.height = 1 + std::max(a.height, nodes_[iKept].height);
+    return iC;
+  }
+
+  if (balance < -1) {
+    //b is taller, it moves up keeping its taller child and a takes the other
+    const auto iD = b.child1;
+    const auto iE = b.child2;
+    auto& d = nodes_[iD];
+    auto& e = nodes_[iE];
+    promote(iB, b);
+
+    const auto keepD = d.height > e.height;
+    const auto iKept = keepD ? iD : iE;
+    const auto iMoved = keepD ? iE : iD;
+    b.child2 = iKept;
+    a.child1 = iMoved;
+    nodes_[iMoved].parent = iA;
+    a.box = c.box.Merged(nodes_[iMoved].box);
+    b.box = a.box.Merged(nodes_[iKept].box);
+    a.height = 1 + std::max(c.height, nodes_[iMoved].height);
+    b.height = 1 + std::max(a.height, nodes_[iKept].height);
+    return iB;
+  }
+
+  return iA;
+}
+
+auto GRK_AABBTree::ValidateNode(const std::int32_t index, std::size_t& leafCount) const -> bool {
+  if (index == kNullNode) {
+    return true;
+  }
+
+  const auto& node = nodes_[index];
+  if (node.IsLeaf()) {
+    leafCount++;
+    return node.height == 0 && node.child2 == kNullNode && node.box.Contains(node.bounds);
+  }
+
+  const auto& child1 = nodes_[node.child1];
+  const auto& child2 = nodes_[node.child2];
+  const auto isConsistent =
+      child1.parent == index && child2.parent == index &&
+      node.height == 1 + std::max(child1.height, child2.height) &&
+      node.box.Contains(child1.box) && node.box.Contains(child2.box);
+
+  return isConsistent && ValidateNode(node.child1, leafCount) && ValidateNode(node.child2, leafCount);
+}
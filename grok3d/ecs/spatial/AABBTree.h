@@ -0,0 +1,217 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * A dynamic bounding volume hierarchy of entity bounds*/
+
+#ifndef __AABBTREE__H
+#define __AABBTREE__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/spatial/AABB.h"
+
+#include "notstd/span.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief A dynamic AABB tree over the world bounds of entities
+ *
+ * @details
+ * Every leaf is one entity (a proxy), every inner node's box is the union of its two children.
+ * Leaves are inserted next to the sibling that grows the tree's total surface area the least,
+ * and each node on the way back up is rotated whenever one child is two levels taller than the
+ * other, so the tree stays balanced however the entities move.
+ *
+ * Leaves store a "fat" box, the entity's bounds grown by a margin.  Moving an entity whose new
+ * bounds are still inside its fat box only refits the leaf, the tree is only restructured
+ * (remove and reinsert) when the entity leaves its fat box, so small movements are cheap.
+ *
+ * The queries test inner nodes against fat boxes and leaves against the entity's exact bounds,
+ * keep their traversal stack on the call stack and write entity ids into a caller supplied
+ * span, so they never allocate and any number of threads can query at once as long as nothing
+ * modifies the tree.
+ *
+ * The @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink keeps one over
+ * every entity with a @link GRK_BoundsComponent GRK_BoundsComponent @endlink, see @link
+ * GRK_EntityComponentManager__::GetSpatialIndex GetSpatialIndex @endlink.  It also collects
+ * the entities whose bounds changed without them moving, for the manager to refit.*/
+class GRK_AABBTree {
+ public:
+  /// A node index that is no node.
+  static constexpr std::int32_t kNullNode = -1;
+
+  /// Deepest traversal the queries support, a balanced tree this tall has far more than 2^64 leaves.
+  static constexpr std::size_t kQueryStackSize = 128;
+
+  /**@param[in] margin how far the fat box of each leaf reaches past the entity's bounds*/
+  explicit GRK_AABBTree(double margin = 0.1) noexcept;
+
+  /**
+   * @brief Adds entity's bounds to the tree
+   *
+   * @returns the proxy identifying the entity's leaf until it is destroyed*/
+  auto CreateProxy(const GRK_AABB& bounds, GRK_Entity entity) -> std::int32_t;
+
+  /**Removes a proxy from the tree*/
+  auto DestroyProxy(std::int32_t proxy) -> void;
+
+  /**
+   * @brief Updates the bounds of a proxy after its entity moved
+   *
+   * @returns true if it left its fat box and was reinserted, false if only the leaf was refit*/
+  auto MoveProxy(std::int32_t proxy, const GRK_AABB& bounds) -> bool;
+
+  auto GetEntity(std::int32_t proxy) const -> GRK_Entity { return nodes_[proxy].entity; }
+
+  /**The exact bounds last given for proxy*/
+  auto GetBounds(std::int32_t proxy) const -> const GRK_AABB& { return nodes_[proxy].bounds; }
+
+  /**The bounds of proxy grown by the margin, as stored in the tree*/
+  auto GetFatBounds(std::int32_t proxy) const -> const GRK_AABB& { return nodes_[proxy].box; }
+
+  /**Number of proxies*/
+  auto Size() const -> std::size_t { return proxyCount_; }
+
+  /**Height of the root, 0 for a single leaf and -1 for an empty tree*/
+  auto GetHeight() const -> std::int32_t { return root_ == kNullNode ? -1 : nodes_[root_].height; }
+
+  /**
+   * @brief The entities whose bounds overlap box
+   *
+   * @param[in] box the box to test against
+   * @param[out] results filled with the first results.size() entities found, in no particular
+   * order
+   *
+   * @returns the number of entities found, which is more than results.size() if it was too small
+   * to hold them all*/
+  auto QueryOverlaps(const GRK_AABB& box, notstd::span<GRK_Entity> results) const -> std::size_t;
+
+  /**
+   * @brief The entities whose bounds ray enters within maxDistance
+   *
+   * @details
+   * Like @link GRK_AABBTree::QueryOverlaps QueryOverlaps @endlink, the results are not sorted by
+   * distance
+   *
+   * @param[in] maxDistance how far along the ray to look, in multiples of its direction*/
+  auto QueryRay(const GRK_Ray& ray, double maxDistance, notstd::span<GRK_Entity> results) const -> std::size_t;
+
+  /**
+   * @brief The entities whose bounds are at least partly inside frustum
+   *
+   * @details
+   * Like @link GRK_AABBTree::QueryOverlaps QueryOverlaps @endlink, for culling*/
+  auto QueryFrustum(const GRK_Frustum& frustum, notstd::span<GRK_Entity> results) const -> std::size_t;
+
+  /**Asks for entity's proxy to be refit at the end of the tick, see @link
+   * GRK_BoundsComponent::SetLocalBounds SetLocalBounds @endlink*/
+  auto MarkBoundsChanged(GRK_Entity entity) -> void { changedBounds_.push_back(entity); }
+
+  /**The entities marked by @link GRK_AABBTree::MarkBoundsChanged MarkBoundsChanged @endlink
+   * since the last @link GRK_AABBTree::ClearChangedBounds ClearChangedBounds @endlink*/
+  auto GetChangedBounds() const -> const std::vector<GRK_Entity>& { return changedBounds_; }
+
+  auto ClearChangedBounds() -> void { changedBounds_.clear(); }
+
+  /**Checks the links, heights and boxes of every node, for tests*/
+  auto Validate() const -> bool;
+
+ private:
+  struct Node {
+    /// Fat bounds of a leaf, the union of the children of an inner node.
+    GRK_AABB box;
+
+    /// Exact bounds of a leaf's entity.
+    GRK_AABB bounds;
+
+    /// The entity of a leaf.
+    GRK_Entity entity;
+
+    /// The parent, or the next free node while the node is free.
+    std::int32_t parent;
+
+    /// The children, kNullNode for a leaf.
+    std::int32_t child1, child2;
+
+    /// 0 for a leaf, 1 + the taller child's for an inner node, -1 while free.
+    std::int32_t height;
+
+    auto IsLeaf() const -> bool { return child1 == kNullNode; }
+  };
+
+  auto AllocateNode() -> std::int32_t;
+
+  auto FreeNode(std::int32_t node) -> void;
+
+  auto InsertLeaf(std::int32_t leaf) -> void;
+
+  auto RemoveLeaf(std::int32_t leaf) -> void;
+
+  /**Recomputes the box and height of every node from index up to the root, balancing each*/
+  auto RefitAncestors(std::int32_t index) -> void;
+
+  /**Rotates the taller grandchild of node up if its children's heights differ by more than one
+   * @returns the node now in node's place*/
+  auto Balance(std::int32_t node) -> std::int32_t;
+
+  /**Depth first walk writing the entities of the leaves whose bounds pass test to results,
+   * skipping subtrees whose box fails it*/
+  template<class Test>
+  auto Query(const Test& test, notstd::span<GRK_Entity> results) const -> std::size_t {
+    std::size_t found = 0;
+    std::array<std::int32_t, kQueryStackSize> stack;
+    std::size_t top = 0;
+    if (root_ != kNullNode) {
+      stack[top++] = root_;
+    }
+
+    while (top > 0) {
+      const auto& node = nodes_[stack[--top]];
+      if (node.IsLeaf()) {
+        if (test(node.bounds)) {
+          if (found < results.size()) {
+            results[found] = node.entity;
+          }
+          found++;
+        }
+      } else if (test(node.box)) {
+        stack[top++] = node.child1;
+        stack[top++] = node.child2;
+      }
+    }
+
+    return found;
+  }
+
+  auto ValidateNode(std::int32_t index, std::size_t& leafCount) const -> bool;
+
+ private:
+  /// Every node, free ones included.
+  std::vector<Node> nodes_;
+
+  /// The root, kNullNode if the tree is empty.
+  std::int32_t root_;
+
+  /// Head of the list of free nodes linked through Node::parent.
+  std::int32_t freeList_;
+
+  /// Number of leaves.
+  std::size_t proxyCount_;
+
+  /// How far fat boxes reach past the exact bounds.
+  double margin_;
+
+  /// Entities to refit, possibly repeated or without bounds by now.
+  std::vector<GRK_Entity> changedBounds_;
+};
+} /*Grok3d*/
+
+#endif
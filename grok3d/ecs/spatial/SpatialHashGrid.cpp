@@ -0,0 +1,106 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "grok3d/ecs/spatial/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+using namespace Grok3d;
+
+GRK_SpatialHashGrid::GRK_SpatialHashGrid(const float cellSize, const std::size_t bucketCount) noexcept :
+    cellSize_(cellSize),
+    inverseCellSize_(1.0f / cellSize) {
+  std::size_t powerOfTwo = 1;
+  while (powerOfTwo < bucketCount) {
+    powerOfTwo *= 2;
+  }
+  bucketMask_ = static_cast<std::uint32_t>(powerOfTwo - 1);
+  bucketStarts_.assign(powerOfTwo + 1, 0);
+}
+
+auto GRK_SpatialHashGrid::Build(
+    notstd::span<const GRK_Entity> entities,
+    notstd::span<const glm::vec3> positions) -> GRK_Result {
+  if (entities.size() != positions.size()) {
+    Build(0, nullptr);
+    return GRK_Result::SizeMismatch;
+  }
+
+  Build(
+      entities.size(),
+      [&entities, &positions](std::size_t begin, std::size_t end, GRK_Entity* outEntities, glm::vec3* outPositions) {
+        std::copy(entities.begin() + begin, entities.begin() + end, outEntities + begin);
+        std::copy(positions.begin() + begin, positions.begin() + end, outPositions + begin);
+      });
+  return GRK_Result::Ok;
+}
+
+auto GRK_SpatialHashGrid::Build(const std::size_t count, const Gather& gather) -> void {
+  const auto bucketCount = static_cast<std::size_t>(bucketMask_) + 1;
+  const auto chunkCount = count < c_parallel_spatial_hash_threshold
+                          ? std::size_t{1}
+                          : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+
+  entities_.resize(count);
+  positions_.resize(count);
+  buckets_.resize(count);
+  sortedEntities_.resize(count);
+  sortedPositions_.resize(count);
+  chunkCounts_.assign(chunkCount * bucketCount, 0);
+
+  //runs work(chunk, begin, end) for every chunk, all but the first on worker threads
+  auto forEachChunk = [chunkCount, chunkSize, count](const auto& work) {
+    std::vector<std::future<void>> tasks;
+    for (std::size_t chunk = 1; chunk < chunkCount; chunk++) {
+      const auto begin = std::min(chunk * chunkSize, count);
+      tasks.push_back(std::async(std::launch::async, work, chunk, begin, std::min(begin + chunkSize, count)));
+    }
+    work(0, 0, std::min(chunkSize, count));
+
+    for (auto& task : tasks) {
+      task.wait();
+    }
+  };
+
+  //histogram of each chunk's buckets
+  forEachChunk([this, bucketCount, &gather](std::size_t chunk, std::size_t begin, std::size_t end) {
+    if (begin < end) {
+      gather(begin, end, entities_.data(), positions_.data());
+    }
+
+    auto* counts = chunkCounts_.data() + chunk * bucketCount;
+    for (auto i = begin; i < end; i++) {
+      const auto bucket = BucketOf(CellOf(positions_[i]));
+      buckets_[i] = bucket;
+      counts[bucket]++;
+    }
+  });
+
+  //each chunk's counts become where its first point of each bucket goes, buckets in order and
+  //chunks in order within a bucket so the sort is stable
+  std::uint32_t offset = 0;
+  for (std::size_t bucket = 0; bucket < bucketCount; bucket++) {
+    bucketStarts_[bucket] = offset;
+    for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+      auto& slot = chunkCounts_[chunk * bucketCount + bucket];
+      const auto pointsInChunk = slot;
+      slot = offset;
+      offset += pointsInChunk;
+    }
+  }
+  bucketStarts_[bucketCount] = offset;
+
+  forEachChunk([this, bucketCount](std::size_t chunk, std::size_t begin, std::size_t end) {
+    auto* offsets = chunkCounts_.data() + chunk * bucketCount;
+    for (auto i = begin; i < end; i++) {
+      const auto slot = offsets[buckets_[i]]++;
+      sortedEntities_[slot] = entities_[i];
+      sortedPositions_[slot] = positions_[i];
+    }
+  });
+}
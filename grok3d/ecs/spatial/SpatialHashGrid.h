@@ -0,0 +1,166 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * A uniform grid of hashed cells rebuilt from scratch every tick*/
+
+#ifndef __SPATIALHASHGRID__H
+#define __SPATIALHASHGRID__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "glm/glm.hpp"
+
+#include "notstd/span.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief Entities bucketed by the grid cell their position is in, for neighbour queries
+ *
+ * @details
+ * Space is cut into cubes of one cell size and every cell is hashed into one of a fixed number
+ * of buckets, so the grid covers unbounded space in fixed memory.  @link
+ * GRK_SpatialHashGrid::Build Build @endlink counting sorts the entities by bucket into one
+ * compact array, with the histogram and the scatter split across worker threads past
+ * c_parallel_spatial_hash_threshold entities.
+ *
+ * Unlike @link GRK_AABBTree GRK_AABBTree @endlink nothing is kept between builds, which suits
+ * many small, fast moving things spread evenly, crowds or particles, where everything moves
+ * every tick anyway and rebuilding is cheaper than updating.  Pick a cell size around the usual
+ * query radius.
+ *
+ * @link GRK_EntityComponentManager__::BuildSpatialHashGrid BuildSpatialHashGrid @endlink
+ * rebuilds one from the positions in the manager's transform store.*/
+class GRK_SpatialHashGrid {
+ public:
+  /**
+   * @param[in] cellSize the edge length of a cell
+   * @param[in] bucketCount the number of buckets cells are hashed into, rounded up to a power of
+   * two*/
+  explicit GRK_SpatialHashGrid(float cellSize = 1.0f, std::size_t bucketCount = 4096) noexcept;
+
+  /**
+   * @brief Rebuilds from entities at positions
+   *
+   * @param[in] entities the entities to bucket
+   * @param[in] positions the position of each entity
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::SizeMismatch SizeMismatch @endlink if the spans differ in length, the grid
+   * is left empty*/
+  auto Build(notstd::span<const GRK_Entity> entities, notstd::span<const glm::vec3> positions) -> GRK_Result;
+
+  /// Writes the entities and positions [begin, end) of a build through the two pointers, which
+  /// point at the build's first entity and position.
+  using Gather = std::function<void(std::size_t begin, std::size_t end, GRK_Entity* entities, glm::vec3* positions)>;
+
+  /**
+   * @brief Rebuilds from count entities whose positions are read by gather
+   *
+   * @details
+   * gather is called once per chunk, on the worker that then buckets that chunk, so reading the
+   * positions is split across the workers like the sort.  Chunks do not overlap and may run at
+   * the same time.*/
+  auto Build(std::size_t count, const Gather& gather) -> void;
+
+  /**Number of entities in the last build*/
+  auto Size() const -> std::size_t { return sortedEntities_.size(); }
+
+  auto GetCellSize() const -> float { return cellSize_; }
+
+  /**Every entity, sorted by bucket so the entities of a cell are contiguous*/
+  auto GetSortedEntities() const -> const std::vector<GRK_Entity>& { return sortedEntities_; }
+
+  /**The position of each entity in @link GRK_SpatialHashGrid::GetSortedEntities
+   * GetSortedEntities @endlink*/
+  auto GetSortedPositions() const -> const std::vector<glm::vec3>& { return sortedPositions_; }
+
+  /**
+   * @brief Calls callback(entity, position) for every entity within radius of position
+   *
+   * @details
+   * Only the buckets of the cells the radius reaches are read, entities hashed there from
+   * other cells are skipped.  The order is by cell, not by distance.*/
+  template<class Callback>
+  auto ForEachNeighbour(const glm::vec3& position, float radius, Callback&& callback) const -> void {
+    if (sortedEntities_.empty()) {
+      return;
+    }
+
+    const auto low = CellOf(position - glm::vec3(radius));
+    const auto high = CellOf(position + glm::vec3(radius));
+    const auto radiusSquared = radius * radius;
+    for (auto z = low.z; z <= high.z; z++) {
+      for (auto y = low.y; y <= high.y; y++) {
+        for (auto x = low.x; x <= high.x; x++) {
+          const glm::ivec3 cell(x, y, z);
+          const auto bucket = BucketOf(cell);
+          for (auto i = bucketStarts_[bucket]; i < bucketStarts_[bucket + 1]; i++) {
+            const auto& point = sortedPositions_[i];
+            const auto offset = point - position;
+            if (glm::dot(offset, offset) <= radiusSquared && CellOf(point) == cell) {
+              callback(sortedEntities_[i], point);
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  auto CellOf(const glm::vec3& position) const -> glm::ivec3 {
+    return glm::ivec3(
+        static_cast<int>(std::floor(position.x * inverseCellSize_)),
+        static_cast<int>(std::floor(position.y * inverseCellSize_)),
+        static_cast<int>(std::floor(position.z * inverseCellSize_)));
+  }
+
+  auto BucketOf(const glm::ivec3& cell) const -> std::uint32_t {
+    const auto hash = (static_cast<std::uint32_t>(cell.x) * 73856093u) ^
+                      (static_cast<std::uint32_t>(cell.y) * 19349663u) ^
+                      (static_cast<std::uint32_t>(cell.z) * 83492791u);
+    return hash & bucketMask_;
+  }
+
+
+ private:
+  float cellSize_;
+
+  float inverseCellSize_;
+
+  /// Bucket count - 1.
+  std::uint32_t bucketMask_;
+
+  /// The entities of bucket b are [bucketStarts_[b], bucketStarts_[b + 1]) in the sorted arrays.
+  std::vector<std::uint32_t> bucketStarts_;
+
+  /// Entities sorted by bucket.
+  std::vector<GRK_Entity> sortedEntities_;
+
+  /// sortedPositions_[i] is the position of sortedEntities_[i].
+  std::vector<glm::vec3> sortedPositions_;
+
+  /// The entities of the build in the order they were gathered.
+  std::vector<GRK_Entity> entities_;
+
+  /// The position of each of entities_.
+  std::vector<glm::vec3> positions_;
+
+  /// Bucket of each entity by its index in the build, kept between builds to not reallocate.
+  std::vector<std::uint32_t> buckets_;
+
+  /// Per chunk histograms then write offsets, chunk c's count of bucket b at c * bucket count + b.
+  std::vector<std::uint32_t> chunkCounts_;
+};
+} /*Grok3d*/
+
+#endif
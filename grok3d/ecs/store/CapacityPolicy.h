@@ -0,0 +1,159 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * How component stores grow and shrink, and how much memory they use*/
+
+#ifndef __CAPACITYPOLICY__H
+#define __CAPACITYPOLICY__H
+
+#include "grok3d/grok3d_types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief Controls how a component store's capacity follows its size
+ *
+ * @details
+ * A full store grows to capacity * (1 + growthNumerator / growthDenominator), but by at least
+ * minimumGrowth components so small stores do not reallocate for every few adds, and always by
+ * at least one.  Both denominators must be non zero, see @link GRK_IsValidCapacityPolicy
+ * GRK_IsValidCapacityPolicy @endlink.
+ *
+ * A store that stays at or under shrinkUsageNumerator / shrinkUsageDenominator of its capacity
+ * for shrinkAfterCollections garbage collections in a row (the engine collects once per tick)
+ * is shrunk back to its size plus one growth step, never under minimumCapacity.  Requiring it to
+ * stay underused for a while keeps a store that is emptied and refilled every few frames from
+ * reallocating back and forth.*/
+struct GRK_CapacityPolicy {
+  /// Numerator of the fraction of the capacity added when growing.
+  std::size_t growthNumerator = 1;
+
+  /// Denominator of the fraction of the capacity added when growing.
+  std::size_t growthDenominator = 2;
+
+  /// The least number of components added to the capacity when growing.
+  std::size_t minimumGrowth = 64;
+
+  /// The capacity reserved up front and never shrunk under.
+  std::size_t minimumCapacity = c_initial_entity_array_size;
+
+  /// Numerator of the usage fraction at or below which the store counts as underused.
+  std::size_t shrinkUsageNumerator = 1;
+
+  /// Denominator of the usage fraction at or below which the store counts as underused.
+  std::size_t shrinkUsageDenominator = 4;
+
+  /// Consecutive underused garbage collections before shrinking.
+  std::size_t shrinkAfterCollections = 600;
+};
+
+/**
+ * @brief The capacity policy a component type starts with
+ *
+ * @details
+ * Specialize for component types that are known to come in huge numbers or to churn a lot, it
+ * can still be changed at runtime with @link GRK_EntityComponentManager__::SetCapacityPolicy
+ * SetCapacityPolicy @endlink*/
+template<class ComponentType>
+struct GRK_ComponentCapacityPolicy {
+  static constexpr GRK_CapacityPolicy value{};
+};
+
+/**false if policy has a zero denominator*/
+constexpr auto GRK_IsValidCapacityPolicy(const GRK_CapacityPolicy& policy) -> bool {
+  return policy.growthDenominator != 0 && policy.shrinkUsageDenominator != 0;
+}
+
+/**The capacity to grow a full store with capacity to, always more than capacity*/
+constexpr auto GRK_GrowCapacity(const GRK_CapacityPolicy& policy, std::size_t capacity) -> std::size_t {
+  return capacity + std::max<std::size_t>(
+      {capacity * policy.growthNumerator / policy.growthDenominator, policy.minimumGrowth, 1});
+}
+
+/**true if a store of size components is using little enough of capacity to count towards
+ * shrinking*/
+constexpr auto GRK_IsUnderused(const GRK_CapacityPolicy& policy, std::size_t size, std::size_t capacity) -> bool {
+  return capacity > policy.minimumCapacity &&
+      size * policy.shrinkUsageDenominator <= capacity * policy.shrinkUsageNumerator;
+}
+
+/**The capacity to shrink a store of size components to*/
+constexpr auto GRK_ShrunkCapacity(const GRK_CapacityPolicy& policy, std::size_t size) -> std::size_t {
+  return std::max(GRK_GrowCapacity(policy, size), policy.minimumCapacity);
+}
+
+/**
+ * @brief Lowers vector's capacity to capacity, or to its size if that is larger
+ *
+ * @details
+ * Unlike shrink_to_fit followed by reserve this allocates and moves the elements once.  Nothing
+ * happens if the capacity is already that low.*/
+template<class T, class Alloc>
+auto GRK_ShrinkVectorTo(std::vector<T, Alloc>& vector, std::size_t capacity) -> void {
+  capacity = std::max(capacity, vector.size());
+  if (capacity >= vector.capacity()) {
+    return;
+  }
+
+  std::vector<T, Alloc> shrunk(vector.get_allocator());
+  shrunk.reserve(capacity);
+  shrunk.insert(shrunk.end(), std::make_move_iterator(vector.begin()), std::make_move_iterator(vector.end()));
+  vector.swap(shrunk);
+}
+
+/**
+ * @brief Estimated bytes used by a hash map from entity to index
+ *
+ * @details
+ * Every element is a node holding the pair and a next pointer, and every bucket is a pointer.
+ *
+ * @param[in] size number of elements
+ * @param[in] bucketCount number of buckets
+ * @param[out] used bytes of the nodes
+ * @param[out] reserved used plus the bucket array*/
+constexpr auto GRK_EstimateHashIndexBytes(
+    std::size_t size,
+    std::size_t bucketCount,
+    std::size_t& used,
+    std::size_t& reserved) -> void {
+  used = size * (2 * sizeof(std::size_t) + sizeof(void*));
+  reserved = used + bucketCount * sizeof(void*);
+}
+
+/**Memory use of one component store and its entity to index lookup*/
+struct GRK_StoreMemoryReport {
+  /// The component's bit index in the GRK_ComponentBitMask.
+  std::size_t componentTypeIndex;
+
+  /// The registered name for runtime components, empty for compile time ones.
+  std::string name;
+
+  /// Number of components in the store.
+  std::size_t size;
+
+  /// Number of components the store has room for.
+  std::size_t capacity;
+
+  /// Bytes taken by the components.
+  std::size_t storeBytesUsed;
+
+  /// Bytes allocated for components.
+  std::size_t storeBytesReserved;
+
+  /// Estimated bytes taken by the entity to index lookup entries.
+  std::size_t indexBytesUsed;
+
+  /// Estimated bytes allocated by the entity to index lookup.
+  std::size_t indexBytesReserved;
+};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,144 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Compile time reflection of component fields, see @link GRK_FIELDS GRK_FIELDS @endlink*/
+
+#ifndef __COMPONENTFIELDS__H
+#define __COMPONENTFIELDS__H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+/**@cond INTERNAL*/
+#define GRK_FIELDS_EXPAND(x) x
+#define GRK_FIELDS_1(Type, a) &Type::a
+#define GRK_FIELDS_2(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_1(Type, __VA_ARGS__))
+#define GRK_FIELDS_3(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_2(Type, __VA_ARGS__))
+#define GRK_FIELDS_4(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_3(Type, __VA_ARGS__))
+#define GRK_FIELDS_5(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_4(Type, __VA_ARGS__))
+#define GRK_FIELDS_6(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_5(Type, __VA_ARGS__))
+#define GRK_FIELDS_7(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_6(Type, __VA_ARGS__))
+#define GRK_FIELDS_8(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_7(Type, __VA_ARGS__))
+#define GRK_FIELDS_9(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_8(Type, __VA_ARGS__))
+#define GRK_FIELDS_10(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_9(Type, __VA_ARGS__))
+#define GRK_FIELDS_11(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_10(Type, __VA_ARGS__))
+#define GRK_FIELDS_12(Type, a, ...) &Type::a, GRK_FIELDS_EXPAND(GRK_FIELDS_11(Type, __VA_ARGS__))
+#define GRK_FIELDS_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, NAME, ...) NAME
+/**@endcond*/
+
+/**
+ * @brief Describes the fields of a component at compile time
+ *
+ * @details
+ * Put this inside the component class <strong>after</strong> the listed members are declared,
+ * in any access section:
+ *
+ *     class GRK_MyComponent {
+ *      ...
+ *      private:
+ *       glm::dvec3 position_;
+ *       float health_;
+ *
+ *       GRK_FIELDS(GRK_MyComponent, position_, health_);
+ *     };
+ *
+ * It declares a GRK_Fields alias (a @link Grok3d::GRK_FieldList GRK_FieldList @endlink of
+ * member pointers) that @link Grok3d::GRK_ComponentFields GRK_ComponentFields @endlink and the
+ * component stores read.  Up to 12 fields are supported.*/
+#define GRK_FIELDS(Type, ...) \
+    friend struct ::Grok3d::GRK_ComponentFields<Type>; \
+    using GRK_Fields = ::Grok3d::GRK_FieldList<GRK_FIELDS_EXPAND(GRK_FIELDS_SELECT(__VA_ARGS__, \
+        GRK_FIELDS_12, GRK_FIELDS_11, GRK_FIELDS_10, GRK_FIELDS_9, GRK_FIELDS_8, GRK_FIELDS_7, \
+        GRK_FIELDS_6, GRK_FIELDS_5, GRK_FIELDS_4, GRK_FIELDS_3, GRK_FIELDS_2, GRK_FIELDS_1)(Type, __VA_ARGS__))>
+
+namespace Grok3d {
+/**Splits a pointer to data member into the class it belongs to and the member's type*/
+template<class MemberPointer>
+struct GRK_MemberPointerTraits;
+
+template<class ClassType, class MemberType>
+struct GRK_MemberPointerTraits<MemberType ClassType::*> {
+  using class_type = ClassType;
+  using member_type = MemberType;
+};
+
+/**
+ * @brief A compile time list of a component's fields as pointers to data members
+ *
+ * @tparam Members pointers to data members of the same class, in column order*/
+template<auto... Members>
+struct GRK_FieldList {
+  /// Number of described fields.
+  static constexpr std::size_t size = sizeof...(Members);
+
+  /// A tuple of each field's type in order.
+  using FieldTypes = std::tuple<typename GRK_MemberPointerTraits<decltype(Members)>::member_type...>;
+
+  /// The type of the field at index.
+  template<std::size_t index>
+  using FieldType = std::tuple_element_t<index, FieldTypes>;
+
+  /// The member pointers themselves, std::get<index>(members) is the index'th field.
+  static constexpr auto members = std::make_tuple(Members...);
+
+  /**The position of Member in this list*/
+  template<auto Member>
+  static constexpr auto IndexOf() -> std::size_t {
+    constexpr bool matches[] = {IsSameMember<Member, Members>()...};
+    for (std::size_t i = 0; i < size; i++) {
+      if (matches[i]) {
+        return i;
+      }
+    }
+    return size;
+  }
+
+ private:
+  template<auto Lhs, auto Rhs>
+  static constexpr auto IsSameMember() -> bool {
+    if constexpr (std::is_same<decltype(Lhs), decltype(Rhs)>::value) {
+      return Lhs == Rhs;
+    } else {
+      return false;
+    }
+  }
+};
+
+/**
+ * @brief Access to the field list a component declared with @link GRK_FIELDS GRK_FIELDS
+ * @endlink
+ *
+ * @details
+ * This is a friend of every class using GRK_FIELDS so private members can be described.
+ * Specialize it directly for types you cannot edit.*/
+template<class ComponentType>
+struct GRK_ComponentFields {
+  using type = typename ComponentType::GRK_Fields;
+};
+
+/**std::true_type if ComponentType has described its fields*/
+template<class ComponentType, class = void>
+struct GRK_HasComponentFields : std::false_type {};
+
+template<class ComponentType>
+struct GRK_HasComponentFields<ComponentType, std::void_t<typename GRK_ComponentFields<ComponentType>::type>>
+    : std::true_type {};
+
+/**
+ * @brief Opt in for a component type to be stored as struct-of-arrays columns
+ *
+ * @details
+ * Specialize to std::true_type for a component that declared @link GRK_FIELDS GRK_FIELDS
+ * @endlink and the @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink
+ * will keep it in a @link GRK_SoAComponentStore GRK_SoAComponentStore @endlink, one vector per
+ * field.  Only the described fields are stored, everything else is default constructed when the
+ * component is read back as a whole.*/
+template<class ComponentType>
+struct GRK_UseSoALayout : std::false_type {};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,111 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Selection of the container each component type is stored in*/
+
+#ifndef __COMPONENTSTORE__H
+#define __COMPONENTSTORE__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+#include "grok3d/ecs/store/ComponentFields.h"
+#include "grok3d/ecs/store/HotColdComponentStore.h"
+#include "grok3d/ecs/store/SoAComponentStore.h"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief Meta function that picks the store a ComponentType lives in
+ *
+ * @details
+ * By default this is a std::vector<ComponentType>, components that opt in with @link
+ * GRK_UseSoALayout GRK_UseSoALayout @endlink get a @link GRK_SoAComponentStore
+ * GRK_SoAComponentStore @endlink and components with a @link GRK_HotRecordOf GRK_HotRecordOf
+ * @endlink get a @link GRK_HotColdComponentStore GRK_HotColdComponentStore @endlink instead.
+ * Every store shares the vector interface the @link GRK_EntityComponentManager__
+ * GRK_EntityComponentManager__ @endlink uses.*/
+template<class ComponentType, class = void>
+struct GRK_ComponentStoreSelector {
+  using type = std::vector<ComponentType>;
+};
+
+template<class ComponentType>
+struct GRK_ComponentStoreSelector<ComponentType, std::enable_if_t<GRK_UseSoALayout<ComponentType>::value>> {
+  static_assert(GRK_HasComponentFields<ComponentType>::value,
+                "Components stored with GRK_UseSoALayout must describe their fields with GRK_FIELDS");
+  static_assert(std::is_void<typename GRK_HotRecordOf<ComponentType>::type>::value,
+                "A component can not be both struct of arrays and hot/cold split");
+
+  using type = GRK_SoAComponentStore<ComponentType>;
+};
+
+template<class ComponentType>
+struct GRK_ComponentStoreSelector<
+    ComponentType,
+    std::enable_if_t<!GRK_UseSoALayout<ComponentType>::value &&
+        !std::is_void<typename GRK_HotRecordOf<ComponentType>::type>::value>> {
+  using type = GRK_HotColdComponentStore<ComponentType, typename GRK_HotRecordOf<ComponentType>::type>;
+};
+
+/// The store type used for ComponentType.
+template<class ComponentType>
+using GRK_ComponentStore = typename GRK_ComponentStoreSelector<ComponentType>::type;
+
+/**Move the element at from into the slot at to, whatever kind of store it is*/
+template<class Store>
+auto GRK_MoveStoreElement(Store& store, std::size_t from, std::size_t to) -> void {
+  store.MoveElement(from, to);
+}
+
+/**@overload*/
+template<class ComponentType, class Alloc>
+auto GRK_MoveStoreElement(std::vector<ComponentType, Alloc>& store, std::size_t from, std::size_t to) -> void {
+  store[to] = std::move(store[from]);
+}
+
+/**Lower the capacity of any kind of store to capacity, or its size if that is larger*/
+template<class Store>
+auto GRK_ShrinkStoreTo(Store& store, std::size_t capacity) -> void {
+  store.ShrinkTo(capacity);
+}
+
+/**@overload*/
+template<class ComponentType, class Alloc>
+auto GRK_ShrinkStoreTo(std::vector<ComponentType, Alloc>& store, std::size_t capacity) -> void {
+  GRK_ShrinkVectorTo(store, capacity);
+}
+
+/**Bytes of storage one element of a store takes, whatever kind of store it is*/
+template<class Store>
+constexpr auto GRK_StoreElementSize(const Store&) -> std::size_t {
+  return Store::ElementSize();
+}
+
+/**@overload*/
+template<class ComponentType, class Alloc>
+constexpr auto GRK_StoreElementSize(const std::vector<ComponentType, Alloc>&) -> std::size_t {
+  return sizeof(ComponentType);
+}
+
+/**Swap the elements at lhs and rhs, whatever kind of store it is*/
+template<class Store>
+auto GRK_SwapStoreElements(Store& store, std::size_t lhs, std::size_t rhs) -> void {
+  store.SwapElements(lhs, rhs);
+}
+
+/**@overload*/
+template<class ComponentType, class Alloc>
+auto GRK_SwapStoreElements(std::vector<ComponentType, Alloc>& store, std::size_t lhs, std::size_t rhs) -> void {
+  using std::swap;
+  swap(store[lhs], store[rhs]);
+}
+} /*Grok3d*/
+
+#endif
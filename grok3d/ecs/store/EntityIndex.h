@@ -0,0 +1,281 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Lookups between entities and the index of their component in a component store*/
+
+#ifndef __ENTITYINDEX__H
+#define __ENTITYINDEX__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Grok3d {
+/// The component index of an entity that has no component.
+constexpr std::size_t kNoComponentInstance = std::numeric_limits<std::size_t>::max();
+
+/**Entity to component index as one array slot per entity id, see @link
+ * GRK_EntityIndexStrategy::Direct Direct @endlink*/
+class GRK_DirectEntitySlots {
+ public:
+  auto Get(GRK_Entity entity) const -> std::size_t {
+    return entity < slots_.size() ? slots_[entity] : kNoComponentInstance;
+  }
+
+  auto Set(GRK_Entity entity, std::size_t instance) -> void {
+    if (entity >= slots_.size()) {
+      slots_.resize(entity + 1, kNoComponentInstance);
+    }
+    slots_[entity] = instance;
+  }
+
+  auto Clear(GRK_Entity entity) -> void {
+    if (entity < slots_.size()) {
+      slots_[entity] = kNoComponentInstance;
+    }
+  }
+
+  auto Reserve(std::size_t entityCount) -> void { slots_.reserve(entityCount); }
+
+  /**Drops the empty slots after the highest entity with a component*/
+  auto ShrinkToFit() -> void {
+    while (!slots_.empty() && slots_.back() == kNoComponentInstance) {
+      slots_.pop_back();
+    }
+    slots_.shrink_to_fit();
+  }
+
+  auto EstimateBytes(std::size_t& used, std::size_t& reserved) const -> void {
+    used = slots_.size() * sizeof(std::size_t);
+    reserved = slots_.capacity() * sizeof(std::size_t);
+  }
+
+ private:
+  /// Component index by entity id, kNoComponentInstance where there is none.
+  std::vector<std::size_t> slots_;
+};
+
+/**Entity to component index as fixed size pages of slots that are only allocated for ranges of
+ * entity ids where some entity has the component, see @link GRK_EntityIndexStrategy::SparseSet
+ * SparseSet @endlink*/
+class GRK_PagedEntitySlots {
+ public:
+  /// Entity ids per page.
+  static constexpr std::size_t kPageSize = 256;
+
+  auto Get(GRK_Entity entity) const -> std::size_t {
+    const auto page = entity / kPageSize;
+    return page < pages_.size() && !pages_[page].empty()
+           ? pages_[page][entity % kPageSize]
+           : kNoComponentInstance;
+  }
+
+  auto Set(GRK_Entity entity, std::size_t instance) -> void {
+    const auto page = entity / kPageSize;
+    if (page >= pages_.size()) {
+      pages_.resize(page + 1);
+    }
+    if (pages_[page].empty()) {
+      pages_[page].assign(kPageSize, kNoComponentInstance);
+    }
+    pages_[page][entity % kPageSize] = instance;
+  }
+
+  auto Clear(GRK_Entity entity) -> void {
+    const auto page = entity / kPageSize;
+    if (page < pages_.size() && !pages_[page].empty()) {
+      pages_[page][entity % kPageSize] = kNoComponentInstance;
+    }
+  }
+
+  auto Reserve(std::size_t entityCount) -> void { pages_.reserve(entityCount / kPageSize + 1); }
+
+  /**Frees the pages with no entity in them*/
+  auto ShrinkToFit() -> void {
+    for (auto& page : pages_) {
+      const auto isEmpty = std::all_of(page.begin(), page.end(), [](std::size_t instance) {
+        return instance == kNoComponentInstance;
+      });
+      if (isEmpty) {
+        std::vector<std::size_t>().swap(page);
+      }
+    }
+
+    while (!pages_.empty() && pages_.back().empty()) {
+      pages_.pop_back();
+    }
+    pages_.shrink_to_fit();
+  }
+
+  auto EstimateBytes(std::size_t& used, std::size_t& reserved) const -> void {
+    const auto allocatedPages = static_cast<std::size_t>(std::count_if(
+        pages_.begin(), pages_.end(), [](const std::vector<std::size_t>& page) { return !page.empty(); }));
+    used = allocatedPages * kPageSize * sizeof(std::size_t) + pages_.size() * sizeof(pages_[0]);
+    reserved = used + (pages_.capacity() - pages_.size()) * sizeof(pages_[0]);
+  }
+
+ private:
+  /// Page i holds the slots of entities [i * kPageSize, (i + 1) * kPageSize), empty if none are used.
+  std::vector<std::vector<std::size_t>> pages_;
+};
+
+/**Entity to component index as a hash map, see @link GRK_EntityIndexStrategy::Hashed Hashed
+ * @endlink*/
+class GRK_HashedEntitySlots {
+ public:
+  auto Get(GRK_Entity entity) const -> std::size_t {
+    const auto slotIt = slots_.find(entity);
+    return slotIt == slots_.end() ? kNoComponentInstance : slotIt->second;
+  }
+
+  auto Set(GRK_Entity entity, std::size_t instance) -> void { slots_[entity] = instance; }
+
+  auto Clear(GRK_Entity entity) -> void { slots_.erase(entity); }
+
+  auto Reserve(std::size_t entityCount) -> void { slots_.reserve(entityCount); }
+
+  auto ShrinkToFit() -> void { slots_.rehash(0); }
+
+  auto EstimateBytes(std::size_t& used, std::size_t& reserved) const -> void {
+    GRK_EstimateHashIndexBytes(slots_.size(), slots_.bucket_count(), used, reserved);
+  }
+
+ private:
+  /// Component index by entity.
+  std::unordered_map<GRK_Entity, std::size_t> slots_;
+};
+
+/**Meta function from a @link GRK_EntityIndexStrategy GRK_EntityIndexStrategy @endlink to the
+ * slot table implementing it*/
+template<GRK_EntityIndexStrategy Strategy>
+struct GRK_EntitySlotsSelector;
+
+template<>
+struct GRK_EntitySlotsSelector<GRK_EntityIndexStrategy::Direct> {
+  using type = GRK_DirectEntitySlots;
+};
+
+template<>
+struct GRK_EntitySlotsSelector<GRK_EntityIndexStrategy::SparseSet> {
+  using type = GRK_PagedEntitySlots;
+};
+
+template<>
+struct GRK_EntitySlotsSelector<GRK_EntityIndexStrategy::Hashed> {
+  using type = GRK_HashedEntitySlots;
+};
+
+/**
+ * @brief The two way lookup between entities and the index of their ComponentType in its store
+ *
+ * @details
+ * The component index to entity direction is always a dense array parallel to the store.  The
+ * entity to component index direction is picked by @link GRK_EntityIndexStrategyOf
+ * GRK_EntityIndexStrategyOf @endlink.
+ *
+ * The functions follow notstd::bidir_map, put overwrites without clearing the entity's old
+ * index or the index's old entity, so swapping two entities is two puts.
+ *
+ * @tparam ComponentType the component type whose store this indexes*/
+template<class ComponentType>
+class GRK_EntityIndex {
+ public:
+  using Slots = typename GRK_EntitySlotsSelector<GRK_EntityIndexStrategyOf<ComponentType>::value>::type;
+
+  /**Number of entities with a component*/
+  auto size() const -> std::size_t { return size_; }
+
+  auto contains(GRK_Entity entity) const -> bool { return slots_.Get(entity) != kNoComponentInstance; }
+
+  /**The index of entity's component, kNoComponentInstance if it has none*/
+  auto at(GRK_Entity entity) const -> std::size_t { return slots_.Get(entity); }
+
+  /**The entity owning the component at instance*/
+  auto reverse_at(std::size_t instance) const -> GRK_Entity { return entities_[instance]; }
+
+  auto put(GRK_Entity entity, std::size_t instance) -> void {
+    if (!contains(entity)) {
+      size_++;
+    }
+    slots_.Set(entity, instance);
+
+    if (instance >= entities_.size()) {
+      entities_.resize(instance + 1, 0);
+    }
+    entities_[instance] = entity;
+  }
+
+  /**Removes entity and the index it maps to*/
+  auto erase(GRK_Entity entity) -> void {
+    const auto instance = slots_.Get(entity);
+    if (instance == kNoComponentInstance) {
+      return;
+    }
+
+    slots_.Clear(entity);
+    size_--;
+    ClearEntityAt(instance);
+  }
+
+  /**Removes instance and the entity mapping to it*/
+  auto reverse_erase(std::size_t instance) -> void {
+    if (instance >= entities_.size() || entities_[instance] == 0) {
+      return;
+    }
+
+    const auto entity = entities_[instance];
+    if (slots_.Get(entity) == instance) {
+      slots_.Clear(entity);
+      size_--;
+    }
+    ClearEntityAt(instance);
+  }
+
+  auto reserve(std::size_t count) -> void {
+    slots_.Reserve(count);
+    entities_.reserve(count);
+  }
+
+  auto shrink_to_fit() -> void {
+    slots_.ShrinkToFit();
+    entities_.shrink_to_fit();
+  }
+
+  /**Estimated bytes used and allocated by both directions*/
+  auto EstimateBytes(std::size_t& used, std::size_t& reserved) const -> void {
+    slots_.EstimateBytes(used, reserved);
+    used += entities_.size() * sizeof(GRK_Entity);
+    reserved += entities_.capacity() * sizeof(GRK_Entity);
+  }
+
+ private:
+  /**Clears the owner of instance, trimming unowned indices off the end*/
+  auto ClearEntityAt(std::size_t instance) -> void {
+    entities_[instance] = 0;
+    while (!entities_.empty() && entities_.back() == 0) {
+      entities_.pop_back();
+    }
+  }
+
+ private:
+  /// Entity to component index.
+  Slots slots_;
+
+  /// entities_[i] owns the component at index i, 0 for none.
+  std::vector<GRK_Entity> entities_;
+
+  /// Number of entities in slots_.
+  std::size_t size_ = 0;
+};
+} /*Grok3d*/
+
+#endif
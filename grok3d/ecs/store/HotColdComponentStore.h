@@ -0,0 +1,147 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Component storage that keeps a compact per frame record next to the full components*/
+
+#ifndef __HOTCOLDCOMPONENTSTORE__H
+#define __HOTCOLDCOMPONENTSTORE__H
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+
+#include <utility>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief A component store split into a contiguous array of small "hot" records and a side
+ * table of the full ("cold") components
+ *
+ * @details
+ * Some components are big (handles with reference counts, buffers, configuration...) but the
+ * loop that runs every frame over them only needs a handful of fields.  Those fields are
+ * copied into a HotRecord (see @link GRK_HotRecordOf GRK_HotRecordOf @endlink) when the
+ * component is added, and the hot array is kept index aligned with the cold components through
+ * every add, swap removal and move, so the per frame loop iterates @link
+ * GRK_HotColdComponentStore::HotRecords HotRecords @endlink and nothing else.
+ *
+ * Indexing and @link GRK_ComponentHandle GRK_ComponentHandle @endlink still refer to the full
+ * component.  If something modifies a component in a way that changes its hot record call
+ * @link GRK_HotColdComponentStore::RefreshHotRecord RefreshHotRecord @endlink (or
+ * GRK_EntityComponentManager__::RefreshHotRecord) afterwards.
+ *
+ * @tparam ComponentType the full component, it must have a
+ * <code>auto MakeHotRecord() const -> HotRecord</code> member
+ * @tparam HotRecord the compact per frame record*/
+template<class ComponentType, class HotRecord>
+class GRK_HotColdComponentStore {
+ public:
+  using value_type = ComponentType;
+  using reference = ComponentType&;
+  using const_reference = const ComponentType&;
+  using size_type = std::size_t;
+  using iterator = typename std::vector<ComponentType>::iterator;
+  using const_iterator = typename std::vector<ComponentType>::const_iterator;
+
+  GRK_HotColdComponentStore() = default;
+
+  // Capacity
+  auto size() const noexcept -> size_type { return cold_.size(); }
+
+  auto empty() const noexcept -> bool { return cold_.empty(); }
+
+  auto capacity() const noexcept -> size_type { return cold_.capacity(); }
+
+  auto max_size() const noexcept -> size_type { return cold_.max_size(); }
+
+  auto reserve(size_type n) -> void {
+    cold_.reserve(n);
+    hot_.reserve(n);
+  }
+
+  auto shrink_to_fit() -> void {
+    cold_.shrink_to_fit();
+    hot_.shrink_to_fit();
+  }
+
+  /**Lowers the capacity to capacity (but not under size) in one reallocation of each array*/
+  auto ShrinkTo(size_type capacity) -> void {
+    GRK_ShrinkVectorTo(cold_, capacity);
+    GRK_ShrinkVectorTo(hot_, capacity);
+  }
+
+  /**Bytes of storage used by one component (the full component and its hot record)*/
+  static constexpr auto ElementSize() -> size_type {
+    return sizeof(ComponentType) + sizeof(HotRecord);
+  }
+
+  // Modification
+  auto push_back(ComponentType&& component) -> void {
+    hot_.push_back(component.MakeHotRecord());
+    cold_.push_back(std::move(component));
+  }
+
+  auto pop_back() -> void {
+    cold_.pop_back();
+    hot_.pop_back();
+  }
+
+  auto clear() -> void {
+    cold_.clear();
+    hot_.clear();
+  }
+
+  // Access, these all refer to the full (cold) components
+  auto operator[](size_type index) -> reference { return cold_[index]; }
+
+  auto operator[](size_type index) const -> const_reference { return cold_[index]; }
+
+  auto at(size_type index) -> reference { return cold_.at(index); }
+
+  auto at(size_type index) const -> const_reference { return cold_.at(index); }
+
+  auto back() -> reference { return cold_.back(); }
+
+  auto back() const -> const_reference { return cold_.back(); }
+
+  auto begin() noexcept -> iterator { return cold_.begin(); }
+
+  auto begin() const noexcept -> const_iterator { return cold_.begin(); }
+
+  auto end() noexcept -> iterator { return cold_.end(); }
+
+  auto end() const noexcept -> const_iterator { return cold_.end(); }
+
+  /**The hot records, index aligned with the components*/
+  auto HotRecords() const -> const std::vector<HotRecord>& { return hot_; }
+
+  /**Rebuild the hot record of the component at index after it was modified*/
+  auto RefreshHotRecord(size_type index) -> void {
+    hot_[index] = cold_[index].MakeHotRecord();
+  }
+
+  /**Move the component (and hot record) at from into the slot at to*/
+  auto MoveElement(size_type from, size_type to) -> void {
+    cold_[to] = std::move(cold_[from]);
+    hot_[to] = hot_[from];
+  }
+
+  /**Swap the components (and hot records) at lhs and rhs*/
+  auto SwapElements(size_type lhs, size_type rhs) -> void {
+    using std::swap;
+    swap(cold_[lhs], cold_[rhs]);
+    swap(hot_[lhs], hot_[rhs]);
+  }
+
+ private:
+  /// The full components.
+  std::vector<ComponentType> cold_;
+
+  /// The compact records the per frame loop reads, hot_[i] is made from cold_[i].
+  std::vector<HotRecord> hot_;
+};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,56 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Runs of component store indices, for uploading the changed parts of a store*/
+
+#ifndef __INDEXRANGES__H
+#define __INDEXRANGES__H
+
+#include "notstd/span.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Grok3d {
+/**The count indices starting at first*/
+struct GRK_IndexRange {
+  std::size_t first;
+  std::size_t count;
+};
+
+/**
+ * @brief Turns a sorted list of indices into the fewest ranges covering them
+ *
+ * @details
+ * Ranges whose gap is at most maxGap indices are joined, so they cover some indices that are not
+ * in the list.  For buffer uploads a few extra elements are cheaper than another call.
+ *
+ * @param[in] sortedIndices ascending, repeats are allowed
+ * @param[in] maxGap the most missing indices allowed between two joined runs
+ * @param[out] ranges cleared and filled with the ranges in ascending order*/
+inline auto GRK_CoalesceIndexRanges(
+    notstd::span<const std::size_t> sortedIndices,
+    std::size_t maxGap,
+    std::vector<GRK_IndexRange>& ranges) -> void {
+  ranges.clear();
+  for (const auto index : sortedIndices) {
+    if (!ranges.empty()) {
+      auto& last = ranges.back();
+      const auto end = last.first + last.count;
+      if (index < end) {
+        continue;
+      }
+      if (index - end <= maxGap) {
+        last.count = index + 1 - last.first;
+        continue;
+      }
+    }
+    ranges.push_back(GRK_IndexRange{index, 1});
+  }
+}
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,157 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+#include "grok3d/ecs/store/RuntimeComponentStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Grok3d;
+
+GRK_RuntimeComponentStore::GRK_RuntimeComponentStore(GRK_RuntimeComponentInfo info) noexcept :
+    info_(std::move(info)),
+    stride_(((info_.size + info_.alignment - 1) / info_.alignment) * info_.alignment),
+    data_(nullptr),
+    size_(0),
+    capacity_(0) {
+}
+
+GRK_RuntimeComponentStore::~GRK_RuntimeComponentStore() {
+  for (std::size_t i = 0; i < size_; i++) {
+    Destroy(SlotAddress(i));
+  }
+
+  ::operator delete(data_, std::align_val_t(info_.alignment));
+}
+
+auto GRK_RuntimeComponentStore::Add(const GRK_Entity entity, void* component) -> GRK_Result {
+  if (entityIndexMap_.find(entity) != entityIndexMap_.end()) {
+    return GRK_Result::ComponentAlreadyAdded;
+  }
+
+  if (size_ == capacity_) {
+    Reserve(GRK_GrowCapacity(info_.capacityPolicy, capacity_));
+  }
+
+  info_.moveConstruct(SlotAddress(size_), component);
+  entities_.push_back(entity);
+  entityIndexMap_[entity] = size_;
+  size_++;
+
+  return GRK_Result::Ok;
+}
+
+auto GRK_RuntimeComponentStore::Remove(const GRK_Entity entity) -> GRK_Result {
+  auto indexIt = entityIndexMap_.find(entity);
+  if (indexIt == entityIndexMap_.end()) {
+    return GRK_Result::NoSuchElement;
+  }
+
+  const auto removeIndex = indexIt->second;
+  const auto lastIndex = size_ - 1;
+
+  Destroy(SlotAddress(removeIndex));
+
+  // Fill the hole with the last component so the store stays dense.
+  if (removeIndex != lastIndex) {
+    Relocate(SlotAddress(removeIndex), SlotAddress(lastIndex));
+    entities_[removeIndex] = entities_[lastIndex];
+    entityIndexMap_[entities_[removeIndex]] = removeIndex;
+  }
+
+  entityIndexMap_.erase(indexIt);
+  entities_.pop_back();
+  size_--;
+
+  return GRK_Result::Ok;
+}
+
+auto GRK_RuntimeComponentStore::Get(const GRK_Entity entity) -> void* {
+  auto indexIt = entityIndexMap_.find(entity);
+  return indexIt == entityIndexMap_.end() ? nullptr : SlotAddress(indexIt->second);
+}
+
+auto GRK_RuntimeComponentStore::Get(const GRK_Entity entity) const -> const void* {
+  auto indexIt = entityIndexMap_.find(entity);
+  return indexIt == entityIndexMap_.end() ? nullptr : SlotAddress(indexIt->second);
+}
+
+auto GRK_RuntimeComponentStore::Has(const GRK_Entity entity) const -> bool {
+  return entityIndexMap_.find(entity) != entityIndexMap_.end();
+}
+
+auto GRK_RuntimeComponentStore::ElementAt(const std::size_t index) -> void* {
+  return SlotAddress(index);
+}
+
+auto GRK_RuntimeComponentStore::ElementAt(const std::size_t index) const -> const void* {
+  return SlotAddress(index);
+}
+
+auto GRK_RuntimeComponentStore::Reserve(const std::size_t capacity) -> void {
+  if (capacity > capacity_) {
+    Reallocate(capacity);
+  }
+}
+
+auto GRK_RuntimeComponentStore::ShrinkTo(const std::size_t capacity) -> void {
+  const auto newCapacity = std::max(capacity, size_);
+  if (newCapacity < capacity_) {
+    Reallocate(newCapacity);
+  }
+
+  entityIndexMap_.rehash(0);
+  GRK_ShrinkVectorTo(entities_, capacity_);
+}
+
+auto GRK_RuntimeComponentStore::ReportMemory(GRK_StoreMemoryReport& report) const -> void {
+  report.size = size_;
+  report.capacity = capacity_;
+  report.storeBytesUsed = size_ * stride_;
+  report.storeBytesReserved = capacity_ * stride_;
+
+  GRK_EstimateHashIndexBytes(
+      entityIndexMap_.size(),
+      entityIndexMap_.bucket_count(),
+      report.indexBytesUsed,
+      report.indexBytesReserved);
+  report.indexBytesUsed += entities_.size() * sizeof(GRK_Entity);
+  report.indexBytesReserved += entities_.capacity() * sizeof(GRK_Entity);
+}
+
+auto GRK_RuntimeComponentStore::Reallocate(const std::size_t capacity) -> void {
+  auto* newData = static_cast<std::byte*>(
+      ::operator new(capacity * stride_, std::align_val_t(info_.alignment)));
+
+  if (info_.relocate == nullptr) {
+    // Trivially copyable, move everything at once.
+    if (size_ > 0) {
+      std::memcpy(newData, data_, size_ * stride_);
+    }
+  } else {
+    for (std::size_t i = 0; i < size_; i++) {
+      info_.relocate(newData + i * stride_, SlotAddress(i));
+    }
+  }
+
+  ::operator delete(data_, std::align_val_t(info_.alignment));
+
+  data_ = newData;
+  capacity_ = capacity;
+  entities_.reserve(capacity);
+}
+
+auto GRK_RuntimeComponentStore::Relocate(std::byte* destination, std::byte* source) -> void {
+  if (info_.relocate == nullptr) {
+    std::memcpy(destination, source, info_.size);
+  } else {
+    info_.relocate(destination, source);
+  }
+}
+
+auto GRK_RuntimeComponentStore::Destroy(std::byte* component) -> void {
+  if (info_.destroy != nullptr) {
+    info_.destroy(component);
+  }
+}
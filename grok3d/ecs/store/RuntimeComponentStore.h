@@ -0,0 +1,215 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Type erased storage for component types registered at runtime*/
+
+#ifndef __RUNTIMECOMPONENTSTORE__H
+#define __RUNTIMECOMPONENTSTORE__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Grok3d {
+/**Identifies a component type registered with @link
+ * GRK_EntityComponentManager__::RegisterRuntimeComponent RegisterRuntimeComponent @endlink*/
+using GRK_RuntimeComponentID = std::size_t;
+
+/**
+ * @brief Everything a @link GRK_RuntimeComponentStore GRK_RuntimeComponentStore @endlink needs
+ * to know about a component type it has never seen at compile time
+ *
+ * @details
+ * Use @link GRK_MakeRuntimeComponentInfo GRK_MakeRuntimeComponentInfo @endlink to fill this in
+ * for a C++ type, or fill it in by hand for components defined elsewhere (scripts etc).*/
+struct GRK_RuntimeComponentInfo {
+  /// Human readable name, used for debugging and memory reports.
+  std::string name;
+
+  /// sizeof the component.
+  std::size_t size;
+
+  /// alignof the component, a power of two.
+  std::size_t alignment;
+
+  /// Move construct the component at source into the uninitialized memory at destination.
+  void (* moveConstruct)(void* destination, void* source);
+
+  /// Move construct into destination then destroy source, nullptr if a memcpy does the job.
+  void (* relocate)(void* destination, void* source);
+
+  /// Destroy the component at component, nullptr if it is trivially destructible.
+  void (* destroy)(void* component);
+
+  /// Remove these components on the main thread during garbage collection, see GRK_IsMainThreadComponent.
+  bool destroyOnMainThread;
+
+  /// How the store grows and shrinks.
+  GRK_CapacityPolicy capacityPolicy;
+};
+
+/**
+ * @brief Builds the @link GRK_RuntimeComponentInfo GRK_RuntimeComponentInfo @endlink function
+ * table for ComponentType
+ *
+ * @param[in] name the name to register the component under
+ *
+ * @tparam ComponentType a move constructible type*/
+template<class ComponentType>
+auto GRK_MakeRuntimeComponentInfo(std::string name) -> GRK_RuntimeComponentInfo {
+  static_assert(std::is_move_constructible<ComponentType>::value,
+                "Runtime components must be move constructible");
+
+  GRK_RuntimeComponentInfo info;
+  info.name = std::move(name);
+  info.size = sizeof(ComponentType);
+  info.alignment = alignof(ComponentType);
+  info.moveConstruct = [](void* destination, void* source) {
+    new(destination) ComponentType(std::move(*static_cast<ComponentType*>(source)));
+  };
+
+  if (std::is_trivially_copyable<ComponentType>::value) {
+    info.relocate = nullptr;
+  } else {
+    info.relocate = [](void* destination, void* source) {
+      auto* sourceComponent = static_cast<ComponentType*>(source);
+      new(destination) ComponentType(std::move(*sourceComponent));
+      sourceComponent->~ComponentType();
+    };
+  }
+
+  if (std::is_trivially_destructible<ComponentType>::value) {
+    info.destroy = nullptr;
+  } else {
+    info.destroy = [](void* component) { static_cast<ComponentType*>(component)->~ComponentType(); };
+  }
+
+  info.destroyOnMainThread = GRK_IsMainThreadComponent<ComponentType>::value;
+  info.capacityPolicy = GRK_ComponentCapacityPolicy<ComponentType>::value;
+  return info;
+}
+
+/**
+ * @brief A densely packed, type erased column of components of one runtime registered type
+ *
+ * @details
+ * Components live back to back in one aligned byte buffer and are moved around (growth, swap
+ * removal) only through the @link GRK_RuntimeComponentInfo GRK_RuntimeComponentInfo @endlink
+ * function table.  Since none of this is a template it is compiled once no matter how many
+ * component types a game registers.
+ *
+ * Like the compile time stores removal moves the last component into the hole, so pointers are
+ * invalidated by adding or removing components of this type.*/
+class GRK_RuntimeComponentStore {
+ public:
+  explicit GRK_RuntimeComponentStore(GRK_RuntimeComponentInfo info) noexcept;
+
+  ~GRK_RuntimeComponentStore();
+
+  GRK_RuntimeComponentStore(const GRK_RuntimeComponentStore&) = delete;
+  GRK_RuntimeComponentStore& operator=(const GRK_RuntimeComponentStore&) = delete;
+
+  /**
+   * @brief Moves the component at component into the store for entity
+   *
+   * @details
+   * The object at component is left in a moved from state, the caller still owns (and
+   * destroys) it.
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::ComponentAlreadyAdded ComponentAlreadyAdded @endlink*/
+  auto Add(GRK_Entity entity, void* component) -> GRK_Result;
+
+  /**
+   * @brief Destroys entity's component, moving the last one into its place
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink*/
+  auto Remove(GRK_Entity entity) -> GRK_Result;
+
+  /**entity's component or nullptr*/
+  auto Get(GRK_Entity entity) -> void*;
+
+  /**@overload*/
+  auto Get(GRK_Entity entity) const -> const void*;
+
+  auto Has(GRK_Entity entity) const -> bool;
+
+  /**The component at index, in the range [0, Size())*/
+  auto ElementAt(std::size_t index) -> void*;
+
+  /**@overload*/
+  auto ElementAt(std::size_t index) const -> const void*;
+
+  /**The entity owning the component at index*/
+  auto EntityAt(std::size_t index) const -> GRK_Entity { return entities_[index]; }
+
+  auto Size() const -> std::size_t { return size_; }
+
+  auto Capacity() const -> std::size_t { return capacity_; }
+
+  /**Distance in bytes between consecutive components*/
+  auto Stride() const -> std::size_t { return stride_; }
+
+  auto GetInfo() const -> const GRK_RuntimeComponentInfo& { return info_; }
+
+  /**Make room for at least capacity components*/
+  auto Reserve(std::size_t capacity) -> void;
+
+  /**Reallocate to room for exactly max(capacity, Size()) components, releasing the rest*/
+  auto ShrinkTo(std::size_t capacity) -> void;
+
+  /**Replace the capacity policy from the info the store was made with*/
+  auto SetCapacityPolicy(const GRK_CapacityPolicy& policy) -> void { info_.capacityPolicy = policy; }
+
+  /**Fill in the sizes of report (not the type index or name)*/
+  auto ReportMemory(GRK_StoreMemoryReport& report) const -> void;
+
+ private:
+  auto SlotAddress(std::size_t index) const -> std::byte* { return data_ + index * stride_; }
+
+  auto Relocate(std::byte* destination, std::byte* source) -> void;
+
+  auto Destroy(std::byte* component) -> void;
+
+  /**Move every component to a new buffer of capacity components*/
+  auto Reallocate(std::size_t capacity) -> void;
+
+ private:
+  /// The function table and layout of the component type.
+  GRK_RuntimeComponentInfo info_;
+
+  /// size rounded up to alignment.
+  std::size_t stride_;
+
+  /// The aligned component buffer.
+  std::byte* data_;
+
+  /// Number of live components.
+  std::size_t size_;
+
+  /// Number of components data_ has room for.
+  std::size_t capacity_;
+
+  /// entities_[i] owns the component at index i.
+  std::vector<GRK_Entity> entities_;
+
+  /// Entity to index of its component.
+  std::unordered_map<GRK_Entity, std::size_t> entityIndexMap_;
+};
+} /*Grok3d*/
+
+#endif
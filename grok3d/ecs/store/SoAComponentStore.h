@@ -0,0 +1,324 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Struct-of-arrays component storage for components described with GRK_FIELDS*/
+
+#ifndef __SOACOMPONENTSTORE__H
+#define __SOACOMPONENTSTORE__H
+
+#include "grok3d/ecs/store/CapacityPolicy.h"
+#include "grok3d/ecs/store/ComponentFields.h"
+
+#include "notstd/span.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Grok3d {
+template<class ComponentType, bool IsConst>
+class GRK_SoAReference__;
+
+/**
+ * @brief A component store that keeps every described field of ComponentType in its own vector
+ *
+ * @details
+ * This has the same interface as the std::vector the @link GRK_EntityComponentManager__
+ * GRK_EntityComponentManager__ @endlink uses for other components (push_back, pop_back, back,
+ * operator[], reserve...) so the manager's bookkeeping does not care which one it holds.
+ * Indexing hands out a @link GRK_SoAReference__ GRK_SoAReference__ @endlink proxy instead of a
+ * ComponentType&, since there is no ComponentType object in memory to refer to.
+ *
+ * The point is that a pass that only reads one field (positions for instance) streams through
+ * exactly that field's vector with @link GRK_SoAComponentStore::Column Column @endlink and
+ * never pulls the other fields through the cache, and that column is a plain array a vector
+ * kernel can run over.
+ *
+ * @tparam ComponentType a default constructible component that declared its fields with
+ * @link GRK_FIELDS GRK_FIELDS @endlink*/
+template<class ComponentType>
+class GRK_SoAComponentStore {
+ private:
+  using Fields = typename GRK_ComponentFields<ComponentType>::type;
+  using ColumnIndices = std::make_index_sequence<Fields::size>;
+
+  template<class>
+  struct ColumnTuple;
+
+  template<class... FieldTypes>
+  struct ColumnTuple<std::tuple<FieldTypes...>> {
+    using type = std::tuple<std::vector<FieldTypes>...>;
+  };
+
+ public:
+  using value_type = ComponentType;
+  using reference = GRK_SoAReference__<ComponentType, false>;
+  using const_reference = GRK_SoAReference__<ComponentType, true>;
+  using size_type = std::size_t;
+
+  /// The type of the field Member points to.
+  template<auto Member>
+  using FieldType = typename GRK_MemberPointerTraits<decltype(Member)>::member_type;
+
+  GRK_SoAComponentStore() = default;
+
+  // Capacity
+  auto size() const noexcept -> size_type { return std::get<0>(columns_).size(); }
+
+  auto empty() const noexcept -> bool { return size() == 0; }
+
+  /**The smallest capacity of any column, every column is always reserved together*/
+  auto capacity() const noexcept -> size_type {
+    return MinimumOverColumns([](const auto& column) { return column.capacity(); }, ColumnIndices{});
+  }
+
+  auto max_size() const noexcept -> size_type {
+    return MinimumOverColumns([](const auto& column) { return column.max_size(); }, ColumnIndices{});
+  }
+
+  auto reserve(size_type n) -> void {
+    ForEachColumn([n](auto& column) { column.reserve(n); }, ColumnIndices{});
+  }
+
+  auto shrink_to_fit() -> void {
+    ForEachColumn([](auto& column) { column.shrink_to_fit(); }, ColumnIndices{});
+  }
+
+  /**Lowers every column's capacity to capacity (but not under size) in one reallocation each*/
+  auto ShrinkTo(size_type capacity) -> void {
+    ForEachColumn([capacity](auto& column) { GRK_ShrinkVectorTo(column, capacity); }, ColumnIndices{});
+  }
+
+  /**Bytes of storage used by one component (the sum of the field sizes)*/
+  static constexpr auto ElementSize() -> size_type {
+    return ElementSizeImpl(ColumnIndices{});
+  }
+
+  // Modification
+  /**Scatters each described field of component to the back of its column*/
+  auto push_back(ComponentType&& component) -> void {
+    PushBackImpl(std::move(component), ColumnIndices{});
+  }
+
+  auto pop_back() -> void {
+    ForEachColumn([](auto& column) { column.pop_back(); }, ColumnIndices{});
+  }
+
+  auto clear() -> void {
+    ForEachColumn([](auto& column) { column.clear(); }, ColumnIndices{});
+  }
+
+  // Access
+  auto operator[](size_type index) -> reference { return reference(this, index); }
+
+  auto operator[](size_type index) const -> const_reference { return const_reference(this, index); }
+
+  auto back() -> reference { return (*this)[size() - 1]; }
+
+  auto back() const -> const_reference { return (*this)[size() - 1]; }
+
+  /**Gathers every described field at index into a whole component*/
+  auto Gather(size_type index) const -> ComponentType {
+    ComponentType component{};
+    GatherImpl(component, index, ColumnIndices{});
+    return component;
+  }
+
+  /**The Member field of the component at index*/
+  template<auto Member>
+  auto Get(size_type index) -> FieldType<Member>& {
+    return ColumnVector<Member>()[index];
+  }
+
+  /**@overload*/
+  template<auto Member>
+  auto Get(size_type index) const -> const FieldType<Member>& {
+    return ColumnVector<Member>()[index];
+  }
+
+  /**
+   * @brief The contiguous column of one field, for passes that only need that field
+   *
+   * @details
+   * The span is invalidated by anything that adds or removes components of this type.
+   *
+   * @tparam Member pointer to the data member, eg &GRK_MyComponent::position_*/
+  template<auto Member>
+  auto Column() -> notstd::span<FieldType<Member>> {
+    auto& column = ColumnVector<Member>();
+    return notstd::span<FieldType<Member>>(column.data(), column.size());
+  }
+
+  /**@overload*/
+  template<auto Member>
+  auto Column() const -> notstd::span<const FieldType<Member>> {
+    const auto& column = ColumnVector<Member>();
+    return notstd::span<const FieldType<Member>>(column.data(), column.size());
+  }
+
+  /**Move every field of the component at from into the slot at to*/
+  auto MoveElement(size_type from, size_type to) -> void {
+    ForEachColumn([from, to](auto& column) { column[to] = std::move(column[from]); }, ColumnIndices{});
+  }
+
+  /**Swap every field of the components at lhs and rhs*/
+  auto SwapElements(size_type lhs, size_type rhs) -> void {
+    ForEachColumn(
+        [lhs, rhs](auto& column) {
+          using std::swap;
+          swap(column[lhs], column[rhs]);
+        }, ColumnIndices{});
+  }
+
+ private:
+  template<class, bool>
+  friend class GRK_SoAReference__;
+
+  template<auto Member>
+  auto ColumnVector() -> std::vector<FieldType<Member>>& {
+    constexpr auto index = Fields::template IndexOf<Member>();
+    static_assert(index < Fields::size, "Member is not one of the fields listed in GRK_FIELDS");
+    return std::get<index>(columns_);
+  }
+
+  template<auto Member>
+  auto ColumnVector() const -> const std::vector<FieldType<Member>>& {
+    constexpr auto index = Fields::template IndexOf<Member>();
+    static_assert(index < Fields::size, "Member is not one of the fields listed in GRK_FIELDS");
+    return std::get<index>(columns_);
+  }
+
+  template<class Function, std::size_t... Indices>
+  auto ForEachColumn(Function&& f, std::index_sequence<Indices...>) -> void {
+    (f(std::get<Indices>(columns_)), ...);
+  }
+
+  template<class Function, std::size_t... Indices>
+  auto MinimumOverColumns(Function&& f, std::index_sequence<Indices...>) const -> size_type {
+    return std::min({std::numeric_limits<size_type>::max(), f(std::get<Indices>(columns_))...});
+  }
+
+  template<std::size_t... Indices>
+  static constexpr auto ElementSizeImpl(std::index_sequence<Indices...>) -> size_type {
+    return (sizeof(typename Fields::template FieldType<Indices>) + ... + 0);
+  }
+
+  template<std::size_t... Indices>
+  auto PushBackImpl(ComponentType&& component, std::index_sequence<Indices...>) -> void {
+    (std::get<Indices>(columns_).push_back(std::move(component.*std::get<Indices>(Fields::members))), ...);
+  }
+
+  template<std::size_t... Indices>
+  auto GatherImpl(ComponentType& component, size_type index, std::index_sequence<Indices...>) const -> void {
+    ((component.*std::get<Indices>(Fields::members) = std::get<Indices>(columns_)[index]), ...);
+  }
+
+  template<std::size_t... Indices>
+  auto ScatterImpl(const ComponentType& component, size_type index, std::index_sequence<Indices...>) -> void {
+    ((std::get<Indices>(columns_)[index] = component.*std::get<Indices>(Fields::members)), ...);
+  }
+
+ private:
+  /// One vector per described field, all always the same size.
+  typename ColumnTuple<typename Fields::FieldTypes>::type columns_;
+};
+
+/**
+ * @brief Proxy reference to one component inside a @link GRK_SoAComponentStore
+ * GRK_SoAComponentStore @endlink
+ *
+ * @details
+ * Behaves like a reference to the component at one index: fields are read and written with
+ * Get<&ComponentType::field>(), it converts to a gathered ComponentType copy, and assigning
+ * another reference (or a ComponentType) writes every field into this slot, which is what swap
+ * removal relies on.
+ *
+ * @tparam ComponentType the component type of the store
+ * @tparam IsConst true for a read only reference*/
+template<class ComponentType, bool IsConst>
+class GRK_SoAReference__ {
+ public:
+  using Store = std::conditional_t<
+      IsConst,
+      const GRK_SoAComponentStore<ComponentType>,
+      GRK_SoAComponentStore<ComponentType>>;
+
+  template<auto Member>
+  using FieldType = typename GRK_SoAComponentStore<ComponentType>::template FieldType<Member>;
+
+  GRK_SoAReference__(Store* store, std::size_t index) noexcept : store_(store), index_(index) {}
+
+  /**A const reference can be made from a mutable one*/
+  template<bool OtherIsConst, class = std::enable_if_t<IsConst && !OtherIsConst>>
+  GRK_SoAReference__(const GRK_SoAReference__<ComponentType, OtherIsConst>& other) noexcept :
+      store_(other.store_), index_(other.index_) {}
+
+  GRK_SoAReference__(const GRK_SoAReference__&) = default;
+
+  /**References that point nowhere are returned when an entity has no such component*/
+  auto IsValid() const -> bool { return store_ != nullptr; }
+
+  auto GetIndex() const -> std::size_t { return index_; }
+
+  /**The Member field of the referred to component*/
+  template<auto Member>
+  auto Get() const -> std::conditional_t<IsConst, const FieldType<Member>&, FieldType<Member>&> {
+    return store_->template Get<Member>(index_);
+  }
+
+  /**Gather a copy of the whole component*/
+  operator ComponentType() const {
+    return store_->Gather(index_);
+  }
+
+  /**Moves every field of other's component into this one's slot*/
+  auto operator=(GRK_SoAReference__&& other) -> GRK_SoAReference__& {
+    static_assert(!IsConst, "Can not assign through a const GRK_SoAReference__");
+    if (store_ == other.store_) {
+      store_->MoveElement(other.index_, index_);
+    } else {
+      store_->ScatterImpl(static_cast<ComponentType>(other), index_, std::make_index_sequence<FieldCount>{});
+    }
+    return *this;
+  }
+
+  /**Writes every described field of component into this slot*/
+  auto operator=(const ComponentType& component) -> GRK_SoAReference__& {
+    static_assert(!IsConst, "Can not assign through a const GRK_SoAReference__");
+    store_->ScatterImpl(component, index_, std::make_index_sequence<FieldCount>{});
+    return *this;
+  }
+
+  /**Swaps the fields of two referred to components in the same store*/
+  friend auto swap(GRK_SoAReference__ lhs, GRK_SoAReference__ rhs) -> void {
+    lhs.store_->SwapElements(lhs.index_, rhs.index_);
+  }
+
+ private:
+  template<class, bool>
+  friend class GRK_SoAReference__;
+
+  static constexpr auto FieldCount = GRK_ComponentFields<ComponentType>::type::size;
+
+  /// The store that holds the columns.
+  Store* store_;
+
+  /// Index of the component in every column.
+  std::size_t index_;
+};
+
+/// Mutable proxy reference into a GRK_SoAComponentStore.
+template<class ComponentType>
+using GRK_SoAReference = GRK_SoAReference__<ComponentType, false>;
+
+/// Read only proxy reference into a GRK_SoAComponentStore.
+template<class ComponentType>
+using GRK_SoAConstReference = GRK_SoAReference__<ComponentType, true>;
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,56 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Sort keys for reordering component stores, see @link
+ * GRK_EntityComponentManager__::SortComponentStore SortComponentStore @endlink*/
+
+#ifndef __STOREORDERING__H
+#define __STOREORDERING__H
+
+#include "glm/glm.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+namespace Grok3d {
+/**Spreads the low 21 bits of value out so there are two zero bits between each of them*/
+constexpr auto GRK_SpreadBits3(std::uint64_t value) -> std::uint64_t {
+  value &= 0x1fffffu;
+  value = (value | value << 32u) & 0x1f00000000ffffu;
+  value = (value | value << 16u) & 0x1f0000ff0000ffu;
+  value = (value | value << 8u) & 0x100f00f00f00f00fu;
+  value = (value | value << 4u) & 0x10c30c30c30c30c3u;
+  value = (value | value << 2u) & 0x1249249249249249u;
+  return value;
+}
+
+/**
+ * @brief A Z-order (Morton) curve key of a position, for sorting by spatial locality
+ *
+ * @details
+ * The position is snapped to a grid of cellSize cubes and the cell coordinates' bits are
+ * interleaved, so positions close to each other mostly get keys close to each other.  Each axis
+ * is given 21 bits, centered on the origin, so the grid covers 2^21 cells per axis and anything
+ * outside is clamped to the border cells.
+ *
+ * @param[in] position the position to make the key for
+ * @param[in] cellSize the size of one grid cell, roughly the size of the things being sorted*/
+inline auto GRK_MortonKey(const glm::dvec3& position, double cellSize) -> std::uint64_t {
+  constexpr auto kHalfRange = static_cast<double>(1u << 20u);
+  constexpr auto kMaxCell = static_cast<double>((1u << 21u) - 1u);
+
+  auto cell = [cellSize](double coordinate) -> std::uint64_t {
+    const auto shifted = std::floor(coordinate / cellSize) + kHalfRange;
+    return static_cast<std::uint64_t>(shifted < 0.0 ? 0.0 : (shifted > kMaxCell ? kMaxCell : shifted));
+  };
+
+  return GRK_SpreadBits3(cell(position.x)) |
+      GRK_SpreadBits3(cell(position.y)) << 1u |
+      GRK_SpreadBits3(cell(position.z)) << 2u;
+}
+} /*Grok3d*/
+
+#endif
@@ -5,6 +5,7 @@
 
 /** @file*/
 
+#include <cstdint>
 #include <iostream>
 
 #include "grok3d/grok3d_types.h"
@@ -22,11 +23,14 @@ constexpr int kWindowHeight = 600;
 constexpr int kWindowWidth = 800;
 
 GRK_RenderSystem::GRK_RenderSystem() noexcept :
-    isInitialized_(false) {
+    isInitialized_(false),
+    drawRecords_(nullptr),
+    ecm_(nullptr) {
 }
 
 auto GRK_RenderSystem::Initialize(GRK_EntityComponentManager* ecm) -> GRK_Result {
-  renderComponents_ = ecm->GetComponentStore<GRK_RenderComponent>();
+  ecm_ = ecm;
+  drawRecords_ = &ecm->GetComponentStore<GRK_RenderComponent>()->HotRecords();
 
   InitializeGLWindow();
 
@@ -130,41 +134,43 @@ auto GRK_RenderSystem::ClearBuffer() const -> void {
 auto GRK_RenderSystem::RenderComponents() const -> void {
   // TODO for each rendercomponent it has a transform component...need to find MVP and set uniform.
   // I put a corresponding TODO in RenderComponent.h which caches the transform component, so I can get it easily here.
-  for (auto& renderComponent : *renderComponents_) {
-    PrepareOGLDraw(renderComponent);
+  // Disabled entities' components are kept after the active ones, so they are never touched.
+  const auto activeCount = ecm_->GetActiveComponentCount<GRK_RenderComponent>();
+  for (std::size_t i = 0; i < activeCount; i++) {
+    const auto& drawRecord = (*drawRecords_)[i];
+    PrepareOGLDraw(drawRecord);
 
-    switch (renderComponent.GetDrawFunction()) {
+    switch (drawRecord.drawFunction) {
       case GRK_DrawFunction::DrawArrays:
         glDrawArrays(
-            renderComponent.GetPrimitive(),
-            renderComponent.GetVBOOffset(),
-            renderComponent.GetVertexCount());
+            drawRecord.primitive,
+            drawRecord.offset,
+            drawRecord.count);
         break;
       case GRK_DrawFunction::DrawElements:
         glDrawElements(
-            renderComponent.GetPrimitive(),
-            renderComponent.GetIndexCount(),
-            static_cast<GLenum>(renderComponent.GetVertexPrimitiveType()),
-            renderComponent.GetEBOOffset());
+            drawRecord.primitive,
+            drawRecord.count,
+            drawRecord.indexType,
+            reinterpret_cast<void*>(static_cast<std::uintptr_t>(drawRecord.offset)));
         break;
       default:break;
     }
   }
 }
 
-auto GRK_RenderSystem::PrepareOGLDraw(const GRK_RenderComponent& renderComponent) const -> void {
-  glUseProgram(renderComponent.GetShaderProgramID());
+auto GRK_RenderSystem::PrepareOGLDraw(const GRK_DrawRecord& drawRecord) const -> void {
+  glUseProgram(drawRecord.shaderProgramID);
 
-  BindTexture(renderComponent);
+  BindTexture(drawRecord);
 
   // Bind VAO (rules for how this vertex shader data is formatted).
-  glBindVertexArray(renderComponent.GetVAO());
+  glBindVertexArray(drawRecord.vertexArrayObject);
 }
 
 // TODO support other texture types.
-void GRK_RenderSystem::BindTexture(const GRK_RenderComponent& renderComponent) const {
-  auto& textureHandle = renderComponent.GetTextureHandle();
-  glBindTexture(GL_TEXTURE_2D, textureHandle.GetId());
+void GRK_RenderSystem::BindTexture(const GRK_DrawRecord& drawRecord) const {
+  glBindTexture(GL_TEXTURE_2D, drawRecord.textureID);
 }
 
 /**
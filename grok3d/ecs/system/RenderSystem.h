@@ -31,8 +31,10 @@ class GRK_RenderSystem {
   /**Have do all rendering work and have GLFW swap buffers*/
   auto Render() const -> GRK_Result;
 
-  /**initialize renderComponents_ with the store of all render components from the @link
-   * GRK_EntityComponentManager GRK_EntityComponentManager @endlink*/
+  /**initialize drawRecords_ with the hot records of all render components from the @link
+   * GRK_EntityComponentManager GRK_EntityComponentManager @endlink, only the first @link
+   * GRK_EntityComponentManager__::GetActiveComponentCount GetActiveComponentCount @endlink
+   * of them (the enabled entities) are drawn*/
   auto Initialize(GRK_EntityComponentManager* ecm) -> GRK_Result;
 
  private:
@@ -53,9 +55,9 @@ class GRK_RenderSystem {
 
   auto RenderComponents() const -> void;
 
-  auto PrepareOGLDraw(const GRK_RenderComponent& renderComponent) const -> void;
+  auto PrepareOGLDraw(const GRK_DrawRecord& drawRecord) const -> void;
 
-  auto BindTexture(const GRK_RenderComponent& renderComponent) const -> void;
+  auto BindTexture(const GRK_DrawRecord& drawRecord) const -> void;
 
   auto Swap() const -> void;
 
@@ -68,8 +70,11 @@ class GRK_RenderSystem {
  private:
   bool isInitialized_;
 
-  /// The store of all GRK_RenderComponents for quick iterating.
-  const std::vector<GRK_RenderComponent>* renderComponents_;
+  /// The draw records of all GRK_RenderComponents, kept contiguous by the ECM for quick iterating.
+  const std::vector<GRK_DrawRecord>* drawRecords_;
+
+  /// The ECM the render components are stored in.
+  GRK_EntityComponentManager* ecm_;
 
   /// GLFW window context.
   GLFWwindow* window_;
@@ -20,8 +20,8 @@ auto GRK_System::Update(double dt) -> GRK_Result {
 auto GRK_System::UpdateSystemEntities(const GRK_EntityHandle& entity) -> GRK_Result {
   GRK_ComponentBitMask myMask = GetComponentsBitMask();
 
-  //if mask has all components I need
-  if (entity.HasComponents(myMask)) {
+  //if mask has all components I need and the entity is not disabled
+  if (entity.HasComponents(myMask) && entity.IsEnabled()) {
     trackedEntities_.insert(entity);
   } else {
     auto itRemove = trackedEntities_.find(entity);
@@ -33,12 +33,29 @@ auto GRK_System::UpdateSystemEntities(const GRK_EntityHandle& entity) -> GRK_Res
   return GRK_Result::Ok;
 }
 
+auto GRK_System::UpdateSystemEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result {
+  for (const auto& entity : entities) {
+    UpdateSystemEntities(entity);
+  }
+
+  return GRK_Result::Ok;
+}
+
 auto GRK_System::UnregisterEntity(const GRK_EntityHandle& entity) -> GRK_Result {
   entitiesToUnregister_.push_back(entity);
 
   return GRK_Result::Ok;
 }
 
+auto GRK_System::UnregisterEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result {
+  entitiesToUnregister_.reserve(entitiesToUnregister_.size() + entities.size());
+  for (const auto& entity : entities) {
+    entitiesToUnregister_.push_back(entity);
+  }
+
+  return GRK_Result::Ok;
+}
+
 auto GRK_System::CompleteUnregisterEntities() -> GRK_Result {
   //TODO move from end to make more efficent
   GRK_Result result = GRK_Result::Ok;
@@ -12,6 +12,7 @@
 #include "grok3d/ecs/entity/EntityHandle.h"
 
 #include <unordered_set>
+#include <vector>
 
 namespace Grok3d {
 /**
@@ -49,9 +50,15 @@ class GRK_System {
    * GetComponentsBitMask @endlink*/
   auto UpdateSystemEntities(const GRK_EntityHandle& entity) -> GRK_Result;
 
+  /**@overload for many entities at once, such as a whole loaded cell*/
+  auto UpdateSystemEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result;
+
   /**Queue an entity to be removed from the system's update queue*/
   auto UnregisterEntity(const GRK_EntityHandle& entity) -> GRK_Result;
 
+  /**@overload for many entities at once, such as a whole unloaded cell*/
+  auto UnregisterEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result;
+
  protected:
   /**Virtual function to override for each system that returns a mask of all the ComponetTypes
    * they are concerned with*/
@@ -37,6 +37,16 @@ auto GRK_SystemManager::UpdateSystemEntities(const GRK_EntityHandle& entity) ->
   return result;
 }
 
+auto GRK_SystemManager::UpdateSystemEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result {
+  auto result = GRK_Result::Ok;
+
+  for (const auto& system : systems_) {
+    result |= system->UpdateSystemEntities(entities);
+  }
+
+  return result;
+}
+
 auto GRK_SystemManager::UnregisterEntity(const GRK_EntityHandle& entity) -> GRK_Result {
   auto result = GRK_Result::Ok;
 
@@ -47,6 +57,16 @@ auto GRK_SystemManager::UnregisterEntity(const GRK_EntityHandle& entity) -> GRK_
   return result;
 }
 
+auto GRK_SystemManager::UnregisterEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result {
+  auto result = GRK_Result::Ok;
+
+  for (auto system : systems_) {
+    result |= system->UnregisterEntities(entities);
+  }
+
+  return result;
+}
+
 auto GRK_SystemManager::UpdateSystems(const double dt) -> GRK_Result {
   auto result = GRK_Result::Ok;
   for (const auto& system : systems_) {
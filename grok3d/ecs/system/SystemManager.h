@@ -14,6 +14,7 @@
 #include "grok3d/ecs/system/GameLogicSystem.h"
 
 #include <array>
+#include <vector>
 
 namespace Grok3d {
 /**
@@ -31,9 +32,15 @@ class GRK_SystemManager {
    * the system's requirments, if so they are added to the queue to be updated every frame*/
   auto UpdateSystemEntities(const GRK_EntityHandle& entity) -> GRK_Result;
 
+  /**@overload that forwards all the entities to each system in one call*/
+  auto UpdateSystemEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result;
+
   /**Unregisters the entity from all systems, if it is registered*/
   auto UnregisterEntity(const GRK_EntityHandle& entity) -> GRK_Result;
 
+  /**@overload that forwards all the entities to each system in one call*/
+  auto UnregisterEntities(const std::vector<GRK_EntityHandle>& entities) -> GRK_Result;
+
   /**Iterate through all systems and run their update functions*/
   auto UpdateSystems(double dt) -> GRK_Result;
 
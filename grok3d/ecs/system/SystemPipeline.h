@@ -0,0 +1,174 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * A fixed, compile time list of systems updated without virtual calls*/
+
+#ifndef __SYSTEMPIPELINE__H
+#define __SYSTEMPIPELINE__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "grok3d/ecs/query/EntityQuery.h"
+
+#include "notstd/tupleextensions.h"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Grok3d {
+/**A list of component types, used by pipeline systems to declare what they read and skip*/
+template<class... ComponentTypes>
+struct GRK_ComponentList {
+  /**The bits of the listed components in ECM's GRK_ComponentBitMask*/
+  template<class ECM>
+  static constexpr auto Mask() -> GRK_ComponentBitMask {
+    return (IndexToMask(ECM::template GetComponentTypeAccessIndex<ComponentTypes>()) | ... | 0u);
+  }
+};
+
+/**The components a pipeline system skips entities for, GRK_ComponentList<> unless it declares
+ * an Exclude list*/
+template<class System, class = void>
+struct GRK_SystemExcludedComponents {
+  using type = GRK_ComponentList<>;
+};
+
+template<class System>
+struct GRK_SystemExcludedComponents<System, std::void_t<typename System::Exclude>> {
+  using type = typename System::Exclude;
+};
+
+/**true if a pipeline System has an Initialize(ECM*) to call*/
+template<class System, class ECM, class = void>
+struct GRK_SystemHasInitialize : std::false_type {
+};
+
+template<class System, class ECM>
+struct GRK_SystemHasInitialize<System, ECM,
+    std::void_t<decltype(std::declval<System&>().Initialize(std::declval<ECM*>()))>> : std::true_type {
+};
+
+/**
+ * @brief Updates a fixed list of systems, each over the cached query of its component signature
+ *
+ * @details
+ * The virtual @link GRK_System GRK_System @endlink path suits systems added at runtime, this
+ * one is for builds whose systems are all known up front.  A pipeline system is any class with
+ *     - <code>using Include = GRK_ComponentList<A, B></code>, the components it updates
+ *     - optionally <code>using Exclude = GRK_ComponentList<C></code>, components it skips
+ *     entities for
+ *     - a non virtual <code>Update(double dt, GRK_Entity entity, A& a, B& b)</code> taking the
+ *     Include components in order (struct of arrays components are passed as a
+ *     @link GRK_SoAReference__ GRK_SoAReference @endlink instead)
+ *     - optionally <code>Initialize(ECM* ecm) -> GRK_Result</code>, called once by
+ *     @link GRK_SystemPipeline__::Initialize Initialize @endlink
+ *
+ * The masks are computed at compile time, each system's query is fetched once in Initialize,
+ * and @link GRK_SystemPipeline__::Update Update @endlink is a sequence of plain loops over the
+ * query entities calling each system directly, so the compiler can inline the whole pipeline.
+ * The query already guarantees the components are there so the loops do no mask checks.
+ *
+ * Like any query iteration, a system must not add or remove components that its own or a later
+ * system's signature depends on from inside Update, defer those changes until after the pipeline
+ * ran.
+ *
+ * @tparam ECM the @link GRK_EntityComponentManager__ GRK_EntityComponentManager__ @endlink type
+ * @tparam Systems the systems, updated in this order*/
+template<class ECM, class... Systems>
+class GRK_SystemPipeline__ {
+ public:
+  GRK_SystemPipeline__() = default;
+
+  explicit GRK_SystemPipeline__(Systems... systems) : systems_(std::move(systems)...) {
+  }
+
+  /**The query signature System's loop runs over*/
+  template<class System>
+  static constexpr auto GetSignature() -> GRK_QuerySignature {
+    return GRK_QuerySignature{
+        System::Include::template Mask<ECM>(),
+        GRK_SystemExcludedComponents<System>::type::template Mask<ECM>()};
+  }
+
+  /**
+   * @brief Binds the pipeline to ecm and initializes every system that has an Initialize
+   *
+   * @returns the first error returned by a system, @link GRK_Result::Ok Ok @endlink otherwise*/
+  auto Initialize(ECM* ecm) -> GRK_Result {
+    ecm_ = ecm;
+    queries_ = {ecm->GetQuery(GetSignature<Systems>().include, GetSignature<Systems>().exclude)...};
+
+    auto result = GRK_Result::Ok;
+    ((result = result == GRK_Result::Ok ? InitializeSystem(std::get<Systems>(systems_)) : result), ...);
+    return result;
+  }
+
+  /**Runs every system over its entities, in the order they are listed
+   * @param[in] dt the amount of time to simulate*/
+  auto Update(double dt) -> GRK_Result {
+    UpdateSystems(dt, std::index_sequence_for<Systems...>{});
+    return GRK_Result::Ok;
+  }
+
+  template<class System>
+  auto GetSystem() -> System& {
+    return std::get<System>(systems_);
+  }
+
+  /**The entities System is updating*/
+  template<class System>
+  auto GetSystemQuery() const -> const GRK_EntityQuery* {
+    return std::get<notstd::type_to_index<System, std::tuple<Systems...>>::value>(queries_);
+  }
+
+ private:
+  template<class System>
+  auto InitializeSystem(System& system) -> GRK_Result {
+    if constexpr (GRK_SystemHasInitialize<System, ECM>::value) {
+      return system.Initialize(ecm_);
+    } else {
+      return GRK_Result::Ok;
+    }
+  }
+
+  template<std::size_t... SystemIndices>
+  auto UpdateSystems(double dt, std::index_sequence<SystemIndices...>) -> void {
+    (UpdateSystem(dt, std::get<SystemIndices>(systems_), *std::get<SystemIndices>(queries_),
+                  static_cast<typename Systems::Include*>(nullptr)), ...);
+  }
+
+  template<class System, class... IncludedComponentTypes>
+  auto UpdateSystem(
+      double dt,
+      System& system,
+      const GRK_EntityQuery& query,
+      GRK_ComponentList<IncludedComponentTypes...>*) -> void {
+    for (const auto entity : query) {
+      system.Update(dt, entity, ecm_->template GetQueriedComponent<IncludedComponentTypes>(entity)...);
+    }
+  }
+
+ private:
+  /// The manager the queries came from.
+  ECM* ecm_ = nullptr;
+
+  /// The systems, in update order.
+  std::tuple<Systems...> systems_;
+
+  /// Each system's query, in the same order as systems_.
+  std::array<const GRK_EntityQuery*, sizeof...(Systems)> queries_{};
+};
+
+/**@link GRK_SystemPipeline__ GRK_SystemPipeline__ @endlink over the engine's
+ * @link GRK_EntityComponentManager GRK_EntityComponentManager @endlink*/
+template<class... Systems>
+using GRK_SystemPipeline = GRK_SystemPipeline__<GRK_EntityComponentManager, Systems...>;
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,98 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * The baked world matrices of the transforms that do not move*/
+
+#ifndef __STATICTRANSFORMPARTITION__H
+#define __STATICTRANSFORMPARTITION__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Grok3d {
+/**
+ * @brief The single precision world matrices of every static transform, packed for upload
+ *
+ * @details
+ * Static transforms (see @link GRK_TransformMobility GRK_TransformMobility @endlink) are left
+ * out of the per tick sweep and their world matrices are written here when they are baked, so
+ * a renderer can batch all of them into one buffer and only upload it again when @link
+ * GRK_StaticTransformPartition::GetVersion GetVersion @endlink changes.  The matrices are
+ * relative to each entity's cell origin like @link GRK_EntityComponentManager__::GetWorldMatrices
+ * GetWorldMatrices @endlink.
+ *
+ * Removing an entity moves the last one into its place, so the order is not stable.*/
+class GRK_StaticTransformPartition {
+ public:
+  /**Number of baked transforms*/
+  auto Size() const -> std::size_t { return entities_.size(); }
+
+  auto Contains(GRK_Entity entity) const -> bool { return slots_.find(entity) != slots_.end(); }
+
+  /**The entity of each matrix*/
+  auto GetEntities() const -> const std::vector<GRK_Entity>& { return entities_; }
+
+  /**The baked world matrices, parallel to @link GRK_StaticTransformPartition::GetEntities
+   * GetEntities @endlink*/
+  auto GetWorldMatrices() const -> const std::vector<glm::mat4>& { return worldMatrices_; }
+
+  /**Changes whenever a matrix is added, rebaked or removed*/
+  auto GetVersion() const -> std::uint64_t { return version_; }
+
+  /**Adds entity's baked matrix, or replaces it if it was already baked*/
+  auto Put(GRK_Entity entity, const glm::mat4& worldMatrix) -> void {
+    const auto slotIt = slots_.find(entity);
+    if (slotIt == slots_.end()) {
+      slots_[entity] = entities_.size();
+      entities_.push_back(entity);
+      worldMatrices_.push_back(worldMatrix);
+    } else {
+      worldMatrices_[slotIt->second] = worldMatrix;
+    }
+    version_++;
+  }
+
+  /**Removes entity's matrix, if it has one*/
+  auto Erase(GRK_Entity entity) -> void {
+    const auto slotIt = slots_.find(entity);
+    if (slotIt == slots_.end()) {
+      return;
+    }
+
+    const auto slot = slotIt->second;
+    slots_.erase(slotIt);
+    if (slot + 1 < entities_.size()) {
+      entities_[slot] = entities_.back();
+      worldMatrices_[slot] = worldMatrices_.back();
+      slots_[entities_[slot]] = slot;
+    }
+    entities_.pop_back();
+    worldMatrices_.pop_back();
+    version_++;
+  }
+
+ private:
+  /// The entity of each baked matrix.
+  std::vector<GRK_Entity> entities_;
+
+  /// worldMatrices_[i] is the baked world matrix of entities_[i].
+  std::vector<glm::mat4> worldMatrices_;
+
+  /// Index of each entity in entities_.
+  std::unordered_map<GRK_Entity, std::size_t> slots_;
+
+  /// Bumped by every change.
+  std::uint64_t version_ = 0;
+};
+} /*Grok3d*/
+
+#endif
@@ -0,0 +1,191 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "grok3d/ecs/transform/TransformColumns.h"
+
+#if GRK_TRANSFORM_SIMD
+#include <xmmintrin.h>
+#endif
+
+using namespace Grok3d;
+
+auto GRK_TransformColumns::Add(
+    glm::vec3 position,
+    glm::quat rotation,
+    glm::vec3 scale,
+    std::uint32_t parent) -> GRK_Result {
+  if (parent != kNoParent && parent >= Size()) {
+    return GRK_Result::NoSuchElement;
+  }
+
+  positionX_.push_back(position.x);
+  positionY_.push_back(position.y);
+  positionZ_.push_back(position.z);
+  rotationX_.push_back(rotation.x);
+  rotationY_.push_back(rotation.y);
+  rotationZ_.push_back(rotation.z);
+  rotationW_.push_back(rotation.w);
+  scaleX_.push_back(scale.x);
+  scaleY_.push_back(scale.y);
+  scaleZ_.push_back(scale.z);
+  parents_.push_back(parent);
+  localMatrices_.emplace_back(1.0f);
+  worldMatrices_.emplace_back(1.0f);
+
+  return GRK_Result::Ok;
+}
+
+auto GRK_TransformColumns::Reserve(std::size_t count) -> void {
+  for (auto* column : {&positionX_, &positionY_, &positionZ_,
+                       &rotationX_, &rotationY_, &rotationZ_, &rotationW_,
+                       &scaleX_, &scaleY_, &scaleZ_}) {
+    column->reserve(count);
+  }
+  parents_.reserve(count);
+  localMatrices_.reserve(count);
+  worldMatrices_.reserve(count);
+}
+
+auto GRK_TransformColumns::GetLocalPosition(std::size_t index) const -> glm::vec3 {
+  return glm::vec3(positionX_[index], positionY_[index], positionZ_[index]);
+}
+
+auto GRK_TransformColumns::SetLocalPosition(std::size_t index, glm::vec3 position) -> void {
+  positionX_[index] = position.x;
+  positionY_[index] = position.y;
+  positionZ_[index] = position.z;
+}
+
+auto GRK_TransformColumns::GetLocalRotation(std::size_t index) const -> glm::quat {
+  return glm::quat(rotationW_[index], rotationX_[index], rotationY_[index], rotationZ_[index]);
+}
+
+auto GRK_TransformColumns::SetLocalRotation(std::size_t index, glm::quat rotation) -> void {
+  rotationX_[index] = rotation.x;
+  rotationY_[index] = rotation.y;
+  rotationZ_[index] = rotation.z;
+  rotationW_[index] = rotation.w;
+}
+
+auto GRK_TransformColumns::GetLocalScale(std::size_t index) const -> glm::vec3 {
+  return glm::vec3(scaleX_[index], scaleY_[index], scaleZ_[index]);
+}
+
+auto GRK_TransformColumns::SetLocalScale(std::size_t index, glm::vec3 scale) -> void {
+  scaleX_[index] = scale.x;
+  scaleY_[index] = scale.y;
+  scaleZ_[index] = scale.z;
+}
+
+auto GRK_TransformColumns::UpdateWorldMatrices() -> void {
+#if GRK_TRANSFORM_SIMD
+  //the tail that does not fill a register is done one at a time
+  ComputeLocalMatricesScalar(ComputeLocalMatricesSIMD(), Size());
+  PropagateWorldMatricesSIMD();
+#else
+  UpdateWorldMatricesScalar();
+#endif
+}
+
+auto GRK_TransformColumns::UpdateWorldMatricesScalar() -> void {
+  ComputeLocalMatricesScalar(0, Size());
+  PropagateWorldMatricesScalar();
+}
+
+auto GRK_TransformColumns::ComputeLocalMatricesScalar(std::size_t begin, std::size_t end) -> void {
+  for (auto i = begin; i < end; i++) {
+    const auto x = rotationX_[i], y = rotationY_[i], z = rotationZ_[i], w = rotationW_[i];
+    auto& m = localMatrices_[i];
+
+    //rotation matrix of the quaternion with each column scaled, then the translation
+    m[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y), 0) * scaleX_[i];
+    m[1] = glm::vec4(2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x), 0) * scaleY_[i];
+    m[2] = glm::vec4(2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y), 0) * scaleZ_[i];
+    m[3] = glm::vec4(positionX_[i], positionY_[i], positionZ_[i], 1);
+  }
+}
+
+auto GRK_TransformColumns::PropagateWorldMatricesScalar() -> void {
+  for (std::size_t i = 0; i < Size(); i++) {
+    worldMatrices_[i] = parents_[i] == kNoParent
+                        ? localMatrices_[i]
+                        : worldMatrices_[parents_[i]] * localMatrices_[i];
+  }
+}
+
+#if GRK_TRANSFORM_SIMD
+auto GRK_TransformColumns::ComputeLocalMatricesSIMD() -> std::size_t {
+  const auto batchEnd = Size() - Size() % 4;
+  const auto one = _mm_set1_ps(1.0f);
+  const auto two = _mm_set1_ps(2.0f);
+  const auto zero = _mm_setzero_ps();
+
+  for (std::size_t i = 0; i < batchEnd; i += 4) {
+    //lane k of every register belongs to transform i + k
+    const auto x = _mm_loadu_ps(&rotationX_[i]);
+    const auto y = _mm_loadu_ps(&rotationY_[i]);
+    const auto z = _mm_loadu_ps(&rotationZ_[i]);
+    const auto w = _mm_loadu_ps(&rotationW_[i]);
+    const auto sx = _mm_loadu_ps(&scaleX_[i]);
+    const auto sy = _mm_loadu_ps(&scaleY_[i]);
+    const auto sz = _mm_loadu_ps(&scaleZ_[i]);
+
+    const auto xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+    const auto xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+    const auto wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+    auto twice = [two](__m128 v) { return _mm_mul_ps(two, v); };
+    auto oneMinusTwice = [one, two](__m128 a, __m128 b) {
+      return _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(a, b)));
+    };
+
+    //column c, row r of the four matrices is columns[c][r]
+    __m128 columns[4][4] = {
+        {_mm_mul_ps(oneMinusTwice(yy, zz), sx), _mm_mul_ps(twice(_mm_add_ps(xy, wz)), sx),
+         _mm_mul_ps(twice(_mm_sub_ps(xz, wy)), sx), zero},
+        {_mm_mul_ps(twice(_mm_sub_ps(xy, wz)), sy), _mm_mul_ps(oneMinusTwice(xx, zz), sy),
+         _mm_mul_ps(twice(_mm_add_ps(yz, wx)), sy), zero},
+        {_mm_mul_ps(twice(_mm_add_ps(xz, wy)), sz), _mm_mul_ps(twice(_mm_sub_ps(yz, wx)), sz),
+         _mm_mul_ps(oneMinusTwice(xx, yy), sz), zero},
+        {_mm_loadu_ps(&positionX_[i]), _mm_loadu_ps(&positionY_[i]), _mm_loadu_ps(&positionZ_[i]), one}};
+
+    //transposing a column's rows gives that column of each of the four matrices
+    for (int c = 0; c < 4; c++) {
+      auto& rows = columns[c];
+      _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+      for (int k = 0; k < 4; k++) {
+        _mm_storeu_ps(&localMatrices_[i + k][c][0], rows[k]);
+      }
+    }
+  }
+
+  return batchEnd;
+}
+
+auto GRK_TransformColumns::PropagateWorldMatricesSIMD() -> void {
+  for (std::size_t i = 0; i < Size(); i++) {
+    if (parents_[i] == kNoParent) {
+      worldMatrices_[i] = localMatrices_[i];
+      continue;
+    }
+
+    //each result column is the parent's columns weighted by the local column's entries
+    const auto& parent = worldMatrices_[parents_[i]];
+    const __m128 parentColumns[4] = {
+        _mm_loadu_ps(&parent[0][0]), _mm_loadu_ps(&parent[1][0]),
+        _mm_loadu_ps(&parent[2][0]), _mm_loadu_ps(&parent[3][0])};
+
+    const auto& local = localMatrices_[i];
+    auto& world = worldMatrices_[i];
+    for (int c = 0; c < 4; c++) {
+      auto column = _mm_mul_ps(parentColumns[0], _mm_set1_ps(local[c][0]));
+      column = _mm_add_ps(column, _mm_mul_ps(parentColumns[1], _mm_set1_ps(local[c][1])));
+      column = _mm_add_ps(column, _mm_mul_ps(parentColumns[2], _mm_set1_ps(local[c][2])));
+      column = _mm_add_ps(column, _mm_mul_ps(parentColumns[3], _mm_set1_ps(local[c][3])));
+      _mm_storeu_ps(&world[c][0], column);
+    }
+  }
+}
+#endif
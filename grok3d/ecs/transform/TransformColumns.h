@@ -0,0 +1,138 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * Local transforms stored as struct of arrays columns, propagated to world matrices in SIMD
+ * batches*/
+
+#ifndef __TRANSFORMCOLUMNS__H
+#define __TRANSFORMCOLUMNS__H
+
+#include "grok3d/grok3d_types.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// 1 if the transform columns use SSE, define GRK_DISABLE_SIMD to always use the scalar code.
+#if defined(__SSE2__) && !defined(GRK_DISABLE_SIMD)
+#define GRK_TRANSFORM_SIMD 1
+#else
+#define GRK_TRANSFORM_SIMD 0
+#endif
+
+namespace Grok3d {
+/**
+ * @brief A transform hierarchy whose local translation, rotation and scale are kept in one
+ * column per field
+ *
+ * @details
+ * @link GRK_TransformComponent GRK_TransformComponent @endlink stores each transform as a
+ * record of double precision vectors, which is convenient for gameplay code but leaves nothing
+ * for the compiler to vectorize.  Here every field is its own float column so the local matrices
+ * of four transforms are built at once from four lane SSE registers, one transform per lane.  The
+ * world matrices are then propagated in a single linear pass, which requires every transform's
+ * parent to be added before it.
+ *
+ * Both passes also exist as plain scalar code, @link GRK_TransformColumns::UpdateWorldMatrices
+ * UpdateWorldMatrices @endlink picks the SIMD one when the build has SSE (see
+ * GRK_TRANSFORM_SIMD) and @link GRK_TransformColumns::UpdateWorldMatricesScalar
+ * UpdateWorldMatricesScalar @endlink is always scalar.
+ *
+ * The columns are a standalone hierarchy, for systems that own many transforms outside the
+ * manager such as particles and instanced props.  The manager's transforms are not stored here,
+ * they are updated by @link GRK_EntityComponentManager__::UpdateWorldTransforms
+ * UpdateWorldTransforms @endlink one at a time at their own precision.*/
+class GRK_TransformColumns {
+ public:
+  /// The parent of a transform with no parent.
+  static constexpr std::uint32_t kNoParent = std::numeric_limits<std::uint32_t>::max();
+
+  /**Number of transforms*/
+  auto Size() const -> std::size_t { return parents_.size(); }
+
+  /**
+   * @brief Appends a transform, its index is the Size() before the call
+   *
+   * @param[in] position translation relative to the parent
+   * @param[in] rotation normalized rotation relative to the parent
+   * @param[in] scale scale relative to the parent
+   * @param[in] parent index of the parent, which must already have been added, or kNoParent
+   *
+   * @returns
+   * @link GRK_Result::Ok Ok @endlink
+   * @link GRK_Result::NoSuchElement NoSuchElement @endlink if parent is not an earlier transform*/
+  auto Add(glm::vec3 position, glm::quat rotation, glm::vec3 scale, std::uint32_t parent = kNoParent) -> GRK_Result;
+
+  auto Reserve(std::size_t count) -> void;
+
+  auto GetParent(std::size_t index) const -> std::uint32_t { return parents_[index]; }
+
+  auto GetLocalPosition(std::size_t index) const -> glm::vec3;
+
+  auto SetLocalPosition(std::size_t index, glm::vec3 position) -> void;
+
+  auto GetLocalRotation(std::size_t index) const -> glm::quat;
+
+  auto SetLocalRotation(std::size_t index, glm::quat rotation) -> void;
+
+  auto GetLocalScale(std::size_t index) const -> glm::vec3;
+
+  auto SetLocalScale(std::size_t index, glm::vec3 scale) -> void;
+
+  /**Recomputes every local and world matrix, in SIMD batches when GRK_TRANSFORM_SIMD*/
+  auto UpdateWorldMatrices() -> void;
+
+  /**Recomputes every local and world matrix one transform at a time*/
+  auto UpdateWorldMatricesScalar() -> void;
+
+  /**The local matrices as of the last update, by index*/
+  auto GetLocalMatrices() const -> const std::vector<glm::mat4>& { return localMatrices_; }
+
+  /**The world matrices as of the last update, by index*/
+  auto GetWorldMatrices() const -> const std::vector<glm::mat4>& { return worldMatrices_; }
+
+ private:
+  /**Computes the local matrices of [begin, end) one at a time*/
+  auto ComputeLocalMatricesScalar(std::size_t begin, std::size_t end) -> void;
+
+  /**Multiplies in the parent world matrices one at a time*/
+  auto PropagateWorldMatricesScalar() -> void;
+
+#if GRK_TRANSFORM_SIMD
+  /**Computes the local matrices of the largest multiple of four transforms, four at a time
+   * @returns the number of transforms done*/
+  auto ComputeLocalMatricesSIMD() -> std::size_t;
+
+  /**Multiplies in the parent world matrices a column at a time*/
+  auto PropagateWorldMatricesSIMD() -> void;
+#endif
+
+ private:
+  /// Local translation columns.
+  std::vector<float> positionX_, positionY_, positionZ_;
+
+  /// Local rotation quaternion columns.
+  std::vector<float> rotationX_, rotationY_, rotationZ_, rotationW_;
+
+  /// Local scale columns.
+  std::vector<float> scaleX_, scaleY_, scaleZ_;
+
+  /// Index of each transform's parent, always lower than its own, or kNoParent.
+  std::vector<std::uint32_t> parents_;
+
+  /// Translation * rotation * scale of each transform.
+  std::vector<glm::mat4> localMatrices_;
+
+  /// Parent's world matrix * local matrix of each transform.
+  std::vector<glm::mat4> worldMatrices_;
+};
+} /*Grok3d*/
+
+#endif
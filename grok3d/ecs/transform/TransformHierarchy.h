@@ -0,0 +1,151 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+/** @file
+ * The entities with transforms bucketed by their depth in the transform hierarchy*/
+
+#ifndef __TRANSFORMHIERARCHY__H
+#define __TRANSFORMHIERARCHY__H
+
+#include "grok3d/grok3d_types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Grok3d {
+class GRK_TransformComponent;
+
+/**
+ * @brief Every transform's entity, in one list per depth in the hierarchy
+ *
+ * @details
+ * Level 0 holds the roots, level d the transforms whose parent is in level d - 1, so walking the
+ * levels in order visits every parent before its children.  That lets @link
+ * GRK_EntityComponentManager__::UpdateWorldTransforms UpdateWorldTransforms @endlink compute
+ * the world transforms in one sweep without recursing, and split each level across threads as
+ * nothing in a level depends on anything else in it.
+ *
+ * The levels are kept up to date by @link GRK_TransformComponent GRK_TransformComponent
+ * @endlink as parents change, moving an entity between levels is a swap with the end of its old
+ * level and a push onto its new one, so the order within a level is not stable.
+ *
+ * Static transforms are not in any level, the sweep never visits them.  Instead they are queued
+ * here whenever they are created or changed, to be baked by the next sweep.
+ *
+ * It also looks up the transform of an entity for the transforms, whose links to each other
+ * are entities, and counts the ticks their world transforms are stamped with for interpolation.*/
+class GRK_TransformHierarchy {
+ public:
+  /// Finds the transform of an entity in the manager's store, nullptr if it has none.
+  using Resolver = std::function<GRK_TransformComponent*(GRK_Entity)>;
+
+  auto SetResolver(Resolver resolver) -> void { resolver_ = std::move(resolver); }
+
+  /**The transform of entity, nullptr if it has none*/
+  auto GetTransform(GRK_Entity entity) const -> GRK_TransformComponent* { return resolver_(entity); }
+
+  /**The tick whose world transform updates are being made, starting at 1*/
+  auto GetTick() const -> std::uint64_t { return tick_; }
+
+  /**Ends the tick, called once the world transforms of the tick are all up to date*/
+  auto AdvanceTick() -> void { tick_++; }
+
+  /**Number of entities in all levels, static transforms are not counted*/
+  auto Size() const -> std::size_t { return slots_.size(); }
+
+  auto Contains(GRK_Entity entity) const -> bool { return slots_.find(entity) != slots_.end(); }
+
+  /**The entities of each depth, roots first*/
+  auto GetLevels() const -> const std::vector<std::vector<GRK_Entity>>& { return levels_; }
+
+  /**The level entity is in, it must be in the hierarchy*/
+  auto GetDepth(GRK_Entity entity) const -> std::size_t { return slots_.at(entity).depth; }
+
+  /**Puts entity in the level for depth, moving it out of its old level if it was in one*/
+  auto SetDepth(GRK_Entity entity, std::size_t depth) -> void {
+    auto slotIt = slots_.find(entity);
+    if (slotIt != slots_.end()) {
+      if (slotIt->second.depth == depth) {
+        return;
+      }
+      RemoveFromLevel(slotIt->second);
+    }
+
+    if (depth >= levels_.size()) {
+      levels_.resize(depth + 1);
+    }
+    slots_[entity] = Slot{depth, levels_[depth].size()};
+    levels_[depth].push_back(entity);
+  }
+
+  /**Asks for entity's static transform to be baked by the next sweep*/
+  auto QueueStaticBake(GRK_Entity entity) -> void { staticBakeQueue_.push_back(entity); }
+
+  /**The static transforms queued since the last bake, possibly repeated or deleted by now*/
+  auto GetStaticBakeQueue() const -> const std::vector<GRK_Entity>& { return staticBakeQueue_; }
+
+  auto ClearStaticBakeQueue() -> void { staticBakeQueue_.clear(); }
+
+  /**Removes entity from its level if it is in one, and from the static bake queue*/
+  auto Erase(GRK_Entity entity) -> void {
+    staticBakeQueue_.erase(
+        std::remove(staticBakeQueue_.begin(), staticBakeQueue_.end(), entity),
+        staticBakeQueue_.end());
+
+    auto slotIt = slots_.find(entity);
+    if (slotIt == slots_.end()) {
+      return;
+    }
+
+    const auto slot = slotIt->second;
+    slots_.erase(slotIt);
+    RemoveFromLevel(slot);
+  }
+
+ private:
+  /// Where an entity is in levels_.
+  struct Slot {
+    std::size_t depth;
+    std::size_t position;
+  };
+
+  /**Moves the last entity of slot's level into it and drops empty deepest levels*/
+  auto RemoveFromLevel(const Slot& slot) -> void {
+    auto& level = levels_[slot.depth];
+    const auto moved = level.back();
+    level[slot.position] = moved;
+    level.pop_back();
+    if (slot.position < level.size()) {
+      slots_[moved].position = slot.position;
+    }
+
+    while (!levels_.empty() && levels_.back().empty()) {
+      levels_.pop_back();
+    }
+  }
+
+ private:
+  /// levels_[d] holds the entities at depth d.
+  std::vector<std::vector<GRK_Entity>> levels_;
+
+  /// Level and position of each entity.
+  std::unordered_map<GRK_Entity, Slot> slots_;
+
+  /// Entity to transform lookup.
+  Resolver resolver_;
+
+  /// The current tick.
+  std::uint64_t tick_ = 1;
+
+  /// Static transforms to bake.
+  std::vector<GRK_Entity> staticBakeQueue_;
+};
+} /*Grok3d*/
+
+#endif
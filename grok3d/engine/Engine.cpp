@@ -13,7 +13,11 @@ using namespace std::chrono_literals;
 
 using namespace Grok3d;
 
-GRK_Engine::GRK_Engine() noexcept {
+GRK_Engine::GRK_Engine() noexcept :
+    // TODO use CVAR to set this as tickrate
+    // This is 144hz period in ns: 6944444ns
+    tickPeriod_(6944444ns),
+    renderInterpolation_(1.0) {
   //Inject dependency references so we can update the systems from ECM and set up systems with ECM
   entityComponentManager_.Initialize(&systemManager_);
   systemManager_.Initialize(&entityComponentManager_);
@@ -34,12 +38,26 @@ auto GRK_Engine::Initialize() -> GRK_Result {
 
 auto GRK_Engine::Update(double dt) -> void {
   systemManager_.UpdateSystems(dt);
+
+  if (pipelineUpdate_) {
+    pipelineUpdate_(dt);
+  }
+
+  entityComponentManager_.UpdateWorldTransforms();
 }
 
 auto GRK_Engine::Render() const -> GRK_Result {
   return systemManager_.Render();
 }
 
+auto GRK_Engine::GetRenderInterpolation() const -> double {
+  return renderInterpolation_;
+}
+
+auto GRK_Engine::SetTickPeriod(std::chrono::nanoseconds tickPeriod) -> void {
+  tickPeriod_ = tickPeriod;
+}
+
 auto GRK_Engine::GarbageCollect() -> void {
   entityComponentManager_.GarbageCollect();
 }
@@ -57,10 +75,6 @@ auto GRK_Engine::EnsureInitialized() -> void {
 };
 
 auto GRK_Engine::RunGameLoop() -> void {
-  // TODO use CVAR to set this as tickrate
-  // This is 144hz period in ns: 6944444ns
-  const auto tickPeriod = std::chrono::nanoseconds(6944444ns);
-
   // Fix my timestep referneced here: https://gafferongames.com/post/fix_your_timestep/
   auto currentTime = std::chrono::system_clock::now();
 
@@ -74,7 +88,10 @@ auto GRK_Engine::RunGameLoop() -> void {
 
     simulationTimeValues.accumulator += prevFrameTime;
 
-    RunTicks(simulationTimeValues, tickPeriod);
+    RunTicks(simulationTimeValues, tickPeriod_);
+
+    // Render the leftover time as a blend of the last two ticks rather than dropping it.
+    renderInterpolation_ = std::chrono::duration<double>(simulationTimeValues.accumulator) / tickPeriod_;
     auto renderStatus = Render();
 
     // TODO change this, shouldnt exit game engine should just not render until GLFW reinits
@@ -62,6 +62,21 @@ class GRK_Engine {
   /**Draw the scene*/
   auto Render() const -> GRK_Result;
 
+  /**
+   * @brief How far the frame being rendered is between the last two ticks
+   *
+   * @details
+   * The time left over in the accumulator after the last tick divided by the tick period, from 0
+   * (the previous tick) up to but not including 1 (the last tick).  Pass it to @link
+   * GRK_EntityComponentManager__::GetInterpolatedWorldMatrices GetInterpolatedWorldMatrices
+   * @endlink when extracting transforms to render, so frames between ticks do not judder at low
+   * tick rates.  1 until the game loop has run.*/
+  auto GetRenderInterpolation() const -> double;
+
+  /**Sets the fixed amount of simulated time each tick of the game loop advances by, 1/144s by
+   * default*/
+  auto SetTickPeriod(std::chrono::nanoseconds tickPeriod) -> void;
+
   /**Clean up deleted components*/
   auto GarbageCollect() -> void;
 
@@ -72,6 +87,26 @@ class GRK_Engine {
   auto InjectInitialization(
       std::function<GRK_Result(GRK_EntityComponentManager&)> initFunction) -> GRK_Result;
 
+  /**
+   * @brief Insert a @link GRK_SystemPipeline__ GRK_SystemPipeline @endlink to update every tick
+   *
+   * @details
+   * The pipeline is initialized against this engine's manager and updated right after the
+   * systems of the @link GRK_SystemManager GRK_SystemManager @endlink, at the cost of one
+   * indirect call per tick rather than one per system.  It must outlive the engine.
+   *
+   * @returns the result of the pipeline's Initialize*/
+  template<class SystemPipeline>
+  auto InjectSystemPipeline(SystemPipeline* pipeline) -> GRK_Result {
+    const auto result = pipeline->Initialize(&entityComponentManager_);
+    if (result != GRK_Result::Ok) {
+      return result;
+    }
+
+    pipelineUpdate_ = [pipeline](double dt) { return pipeline->Update(dt); };
+    return GRK_Result::Ok;
+  }
+
  private:
   auto EnsureInitialized() -> void;
 
@@ -87,6 +122,15 @@ class GRK_Engine {
    * using the @link GRK_EntityComponentManager GRK_EntityComponentManager @endlink
    * for an initial state*/
   std::function<GRK_Result(GRK_EntityComponentManager&)> initFunction_;
+
+  /// Updates the injected system pipeline, empty if there is none.
+  std::function<GRK_Result(double)> pipelineUpdate_;
+
+  /// Simulated time per tick.
+  std::chrono::nanoseconds tickPeriod_;
+
+  /// See GetRenderInterpolation.
+  double renderInterpolation_;
 };
 } /*Grok3d*/
 
@@ -18,11 +18,21 @@
 #include "ecs/component/TransformComponent.h"
 #include "ecs/component/GameLogicComponent.h"
 #include "ecs/component/RenderComponent.h"
+#include "ecs/component/NameComponent.h"
+#include "ecs/component/BoundsComponent.h"
 
 #include "ecs/system/System.h"
 #include "ecs/system/SystemManager.h"
 #include "ecs/system/GameLogicSystem.h"
 #include "ecs/system/RenderSystem.h"
+#include "ecs/system/SystemPipeline.h"
+
+#include "ecs/transform/StaticTransformPartition.h"
+#include "ecs/transform/TransformColumns.h"
+
+#include "ecs/spatial/AABB.h"
+#include "ecs/spatial/AABBTree.h"
+#include "ecs/spatial/SpatialHashGrid.h"
 
 #include "grok3d/shaders/shaderprogram.h"
 #include "grok3d/textures/texturehandle.h"
@@ -20,6 +20,22 @@
 /**constant (for now, future to make CVAR) that controls initial size of stores*/
 constexpr auto c_initial_entity_array_size = 1024;
 
+/**constant (for now, future to make CVAR) number of deleted entities in one garbage collection
+ * pass before the per component type removals are spread across worker threads*/
+constexpr auto c_parallel_garbage_collect_threshold = 256;
+
+/**constant (for now, future to make CVAR) number of transforms in one hierarchy level before
+ * the level's world transform updates are spread across worker threads*/
+constexpr auto c_parallel_transform_level_threshold = 4096;
+
+/**constant (for now, future to make CVAR) number of positions in a spatial hash grid before its
+ * rebuild is spread across worker threads*/
+constexpr auto c_parallel_spatial_hash_threshold = 8192;
+
+/**constant (for now, future to make CVAR) number of unchanged transforms between two changed
+ * ones that are uploaded anyway to join their upload ranges*/
+constexpr auto c_transform_upload_max_gap = 4;
+
 /** number of dimensions this engine is rendering.*/
 static constexpr unsigned int kDimensions = 3;
 
@@ -48,7 +64,12 @@ enum class GRK_Result : std::size_t {
   EngineFailureNoInitialState = 1u << 10u, ///< Engine must be initialized before use
   CriticalError = 1u << 11u,               ///< Wow...I blame you >_>
   RenderingTerminated = 1u << 12u,         ///< Rendering is done
-  OpenGLErrorOccurred = 1u << 13u          ///< Some OpenGL error happened, check std::err
+  OpenGLErrorOccurred = 1u << 13u,         ///< Some OpenGL error happened, check std::err
+  NameAlreadyTaken = 1u << 14u,            ///< Another entity already has that GRK_NameComponent
+  MalformedData = 1u << 15u,               ///< Serialized data is truncated, corrupt or from another build
+  CellAlreadyLoaded = 1u << 16u,           ///< The cell being loaded already has entities
+  SizeMismatch = 1u << 17u,                ///< The parallel spans given to a batch call have different lengths
+  InvalidArgument = 1u << 18u              ///< A policy or layout given to the engine cannot be used as is
 };
 
 using UT_GRK_Result = std::underlying_type_t<GRK_Result>;
@@ -83,12 +104,88 @@ class GRK_GameBehaviourBase;
 
 class GRK_RenderComponent;
 
+class GRK_NameComponent;
+
+class GRK_BoundsComponent;
+
+/**
+ * @brief Marks component types whose destruction must happen on the main thread
+ *
+ * @details
+ * Garbage collection removes the components of deleted entities on worker threads, one
+ * ComponentType per thread.  Components that own OpenGL objects (the context is only current on
+ * the main thread) or that run user code when destroyed specialize this to std::true_type so
+ * they are always removed from the main thread*/
+template<class ComponentType>
+struct GRK_IsMainThreadComponent : std::false_type {};
+
+template<>
+struct GRK_IsMainThreadComponent<GRK_GameLogicComponent> : std::true_type {};
+
+template<>
+struct GRK_IsMainThreadComponent<GRK_RenderComponent> : std::true_type {};
+
+struct GRK_DrawRecord;
+
+/**
+ * @brief Gives a component type a compact "hot" record that is stored apart from it
+ *
+ * @details
+ * type is void for ordinary components.  A component that specializes this with a record type
+ * (and has a <code>MakeHotRecord() const</code> member making one) is stored in a @link
+ * GRK_HotColdComponentStore GRK_HotColdComponentStore @endlink, where the records are kept
+ * contiguous for the loops that run every frame and the full components act as a side table*/
+template<class ComponentType>
+struct GRK_HotRecordOf {
+  using type = void;
+};
+
+template<>
+struct GRK_HotRecordOf<GRK_RenderComponent> {
+  using type = GRK_DrawRecord;
+};
+
+/**How a component store finds the component of an entity, see @link GRK_EntityIndexStrategyOf
+ * GRK_EntityIndexStrategyOf @endlink*/
+enum class GRK_EntityIndexStrategy {
+  Direct,    ///< An array indexed by entity id, for components nearly every entity has.
+  SparseSet, ///< Pages of such an array allocated only where entities have the component.
+  Hashed     ///< A hash map, for components very few entities have.
+};
+
+/**
+ * @brief Picks the entity to component lookup of a component type by how common it is
+ *
+ * @details
+ * Direct costs one slot per entity id ever created whether it has the component or not but
+ * finds it with one load, Hashed only costs memory for the components that exist but hashes on
+ * every lookup, and SparseSet sits in between.  Specialize for component types whose density is
+ * far from the default*/
+template<class ComponentType>
+struct GRK_EntityIndexStrategyOf {
+  static constexpr GRK_EntityIndexStrategy value = GRK_EntityIndexStrategy::SparseSet;
+};
+
+template<>
+struct GRK_EntityIndexStrategyOf<GRK_TransformComponent> {
+  static constexpr GRK_EntityIndexStrategy value = GRK_EntityIndexStrategy::Direct;
+};
+
+template<>
+struct GRK_EntityIndexStrategyOf<GRK_NameComponent> {
+  static constexpr GRK_EntityIndexStrategy value = GRK_EntityIndexStrategy::Hashed;
+};
+
 using GRK_VertexBufferObject  = unsigned int;
 using GRK_VertexArrayObject   = unsigned int;
 using GRK_ElementBufferObject = unsigned int;
 
 using GRK_ComponentBitMask = unsigned int;
 
+/**The highest bit of an entity's GRK_ComponentBitMask is not a component, it is set while the
+ * entity is disabled (see GRK_EntityComponentManager__::SetEntityEnabled)*/
+constexpr GRK_ComponentBitMask kDisabledEntityMask = IndexToMask(sizeof(GRK_ComponentBitMask) * 8 - 1);
+
 class GRK_SystemManager;
 
 class GRK_System;
@@ -107,7 +204,9 @@ class GRK_EntityComponentManager__;
 
 using GRK_EntityComponentManager = GRK_EntityComponentManager__<GRK_TransformComponent,
                                                                 GRK_GameLogicComponent,
-                                                                GRK_RenderComponent>;
+                                                                GRK_RenderComponent,
+                                                                GRK_NameComponent,
+                                                                GRK_BoundsComponent>;
 
 template<class ComponentType, class ECM = GRK_EntityComponentManager>
 class GRK_ComponentHandle;
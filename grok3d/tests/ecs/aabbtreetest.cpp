@@ -0,0 +1,198 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "grok3d/grok3d.h"
+#include "grok3d/grok3d_types.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Grok3d;
+using namespace testing;
+
+namespace {
+auto UnitBoxAt(const glm::dvec3& center) -> GRK_AABB {
+  return GRK_AABB{center - glm::dvec3(0.5), center + glm::dvec3(0.5)};
+}
+
+auto Sorted(std::vector<GRK_Entity> entities) -> std::vector<GRK_Entity> {
+  std::sort(entities.begin(), entities.end());
+  return entities;
+}
+
+// A row of unit boxes along x, entity i + 1 centered at (2i, 0, 0).
+auto MakeRow(GRK_AABBTree& tree, std::size_t count) -> std::vector<std::int32_t> {
+  std::vector<std::int32_t> proxies;
+  for (std::size_t i = 0; i < count; i++) {
+    proxies.push_back(tree.CreateProxy(UnitBoxAt(glm::dvec3(2.0 * i, 0, 0)), i + 1));
+  }
+  return proxies;
+}
+}
+
+TEST(AABBTreeTests, TestQueryOverlaps) {
+  GRK_AABBTree tree;
+  MakeRow(tree, 10);
+  ASSERT_TRUE(tree.Validate());
+  EXPECT_EQ(tree.Size(), 10u);
+
+  std::vector<GRK_Entity> results(16);
+  const auto found = tree.QueryOverlaps(GRK_AABB{glm::dvec3(3.9, -1, -1), glm::dvec3(6.1, 1, 1)}, results);
+  ASSERT_EQ(found, 2u);
+  EXPECT_EQ(Sorted({results[0], results[1]}), (std::vector<GRK_Entity>{3, 4}));
+
+  // Leaves are tested against the exact bounds, not the fat ones.
+  EXPECT_EQ(tree.QueryOverlaps(GRK_AABB{glm::dvec3(0.55, -1, -1), glm::dvec3(0.6, 1, 1)}, results), 0u);
+}
+
+TEST(AABBTreeTests, TestResultsAreTruncatedToTheSpan) {
+  GRK_AABBTree tree;
+  MakeRow(tree, 10);
+
+  std::vector<GRK_Entity> results(3);
+  const auto found = tree.QueryOverlaps(GRK_AABB{glm::dvec3(-100), glm::dvec3(100)}, results);
+  EXPECT_EQ(found, 10u);
+  for (const auto entity : results) {
+    EXPECT_GE(entity, 1u);
+    EXPECT_LE(entity, 10u);
+  }
+}
+
+TEST(AABBTreeTests, TestQueryRay) {
+  GRK_AABBTree tree;
+  MakeRow(tree, 10);
+  tree.CreateProxy(UnitBoxAt(glm::dvec3(4, 5, 0)), 100);
+
+  std::vector<GRK_Entity> results(16);
+  const GRK_Ray down{glm::dvec3(4, 10, 0), glm::dvec3(0, -1, 0)};
+  ASSERT_EQ(tree.QueryRay(down, 100.0, results), 2u);
+  EXPECT_EQ(Sorted({results[0], results[1]}), (std::vector<GRK_Entity>{3, 100}));
+
+  // Too short to reach the row.
+  ASSERT_EQ(tree.QueryRay(down, 6.0, results), 1u);
+  EXPECT_EQ(results[0], 100u);
+
+  // Pointing away.
+  EXPECT_EQ(tree.QueryRay(GRK_Ray{glm::dvec3(4, 10, 0), glm::dvec3(0, 1, 0)}, 100.0, results), 0u);
+}
+
+TEST(AABBTreeTests, TestQueryFrustum) {
+  GRK_AABBTree tree;
+  MakeRow(tree, 10);
+
+  // An orthographic box from x = 5 to 13.
+  const auto projection = glm::dmat4(
+      glm::dvec4(0.25, 0, 0, 0),
+      glm::dvec4(0, 1, 0, 0),
+      glm::dvec4(0, 0, 1, 0),
+      glm::dvec4(-2.25, 0, 0, 1));
+  std::vector<GRK_Entity> results(16);
+  const auto found = tree.QueryFrustum(GRK_Frustum::FromMatrix(projection), results);
+  ASSERT_EQ(found, 4u);
+  EXPECT_EQ(Sorted({results.begin(), results.begin() + found}), (std::vector<GRK_Entity>{4, 5, 6, 7}));
+}
+
+TEST(AABBTreeTests, TestMovesOnlyReinsertOutsideTheFatBox) {
+  GRK_AABBTree tree(0.5);
+  const auto proxies = MakeRow(tree, 4);
+
+  EXPECT_FALSE(tree.MoveProxy(proxies[0], UnitBoxAt(glm::dvec3(0.25, 0, 0))));
+  EXPECT_EQ(tree.GetBounds(proxies[0]).min, glm::dvec3(-0.25, -0.5, -0.5));
+  EXPECT_TRUE(tree.MoveProxy(proxies[0], UnitBoxAt(glm::dvec3(50, 0, 0))));
+  EXPECT_EQ(tree.GetFatBounds(proxies[0]).min, glm::dvec3(49, -1, -1));
+  EXPECT_EQ(tree.GetEntity(proxies[0]), 1u);
+  ASSERT_TRUE(tree.Validate());
+
+  std::vector<GRK_Entity> results(4);
+  ASSERT_EQ(tree.QueryOverlaps(UnitBoxAt(glm::dvec3(50, 0, 0)), results), 1u);
+  EXPECT_EQ(results[0], 1u);
+
+  tree.DestroyProxy(proxies[0]);
+  EXPECT_EQ(tree.QueryOverlaps(UnitBoxAt(glm::dvec3(50, 0, 0)), results), 0u);
+  EXPECT_EQ(tree.Size(), 3u);
+  ASSERT_TRUE(tree.Validate());
+}
+
+TEST(AABBTreeTests, TestStaysBalancedUnderRandomMoves) {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<double> position(-100.0, 100.0);
+
+  // Inserted in order the tree would degenerate into a list without rotations.
+  GRK_AABBTree tree;
+  auto proxies = MakeRow(tree, 1000);
+  ASSERT_TRUE(tree.Validate());
+  EXPECT_LE(tree.GetHeight(), 20);
+
+  for (int round = 0; round < 2000; round++) {
+    const auto proxy = proxies[random() % proxies.size()];
+    tree.MoveProxy(proxy, UnitBoxAt(glm::dvec3(position(random), position(random), position(random))));
+  }
+  for (std::size_t i = 0; i < proxies.size(); i += 2) {
+    tree.DestroyProxy(proxies[i]);
+  }
+  ASSERT_TRUE(tree.Validate());
+  EXPECT_EQ(tree.Size(), 500u);
+  EXPECT_LE(tree.GetHeight(), 20);
+
+  // Every proxy is found by a query around its own bounds.
+  std::vector<GRK_Entity> results(64);
+  for (std::size_t i = 1; i < proxies.size(); i += 2) {
+    const auto found = tree.QueryOverlaps(tree.GetBounds(proxies[i]), results);
+    ASSERT_LE(found, results.size());
+    EXPECT_NE(std::find(results.begin(), results.begin() + found, i + 1), results.begin() + found);
+  }
+}
+
+TEST(AABBTreeManagerTests, TestBoundsFollowTransforms) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto parent = ecm.CreateEntity();
+  auto child = ecm.CreateEntity();
+  auto unbounded = ecm.CreateEntity();
+  child.GetComponent<GRK_TransformComponent>()->SetParent(parent.GetComponent<GRK_TransformComponent>().operator->());
+  child.GetComponent<GRK_TransformComponent>()->TranslateLocal(0, 10, 0);
+  ASSERT_EQ(child.AddComponent(GRK_BoundsComponent(UnitBoxAt(glm::dvec3(0)))), GRK_Result::Ok);
+  unbounded.GetComponent<GRK_TransformComponent>()->TranslateLocal(0, 10, 0);
+
+  // Bounds are placed where the entity is when they are added.
+  const auto& index = ecm.GetSpatialIndex();
+  std::vector<GRK_Entity> results(4);
+  ASSERT_EQ(index.QueryOverlaps(UnitBoxAt(glm::dvec3(0, 10, 0)), results), 1u);
+  EXPECT_EQ(results[0], static_cast<GRK_Entity>(child));
+
+  // Moving the parent moves the child's bounds once the transforms are updated.
+  parent.GetComponent<GRK_TransformComponent>()->TranslateLocal(20, 0, 0);
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(ecm.GetMovedEntities().size(), 3u);
+  EXPECT_EQ(index.QueryOverlaps(UnitBoxAt(glm::dvec3(0, 10, 0)), results), 0u);
+  ASSERT_EQ(index.QueryOverlaps(UnitBoxAt(glm::dvec3(20, 10, 0)), results), 1u);
+  EXPECT_EQ(results[0], static_cast<GRK_Entity>(child));
+
+  // Nothing moved.
+  ecm.UpdateWorldTransforms();
+  EXPECT_TRUE(ecm.GetMovedEntities().empty());
+
+  // Growing the bounds refits without a move.
+  child.GetComponent<GRK_BoundsComponent>()->SetLocalBounds(GRK_AABB{glm::dvec3(-5), glm::dvec3(5)});
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(index.QueryOverlaps(UnitBoxAt(glm::dvec3(24, 10, 0)), results), 1u);
+
+  // Cell origins offset the bounds.
+  const GRK_CellID cell = 3;
+  ASSERT_EQ(ecm.SetCellOrigin(cell, glm::dvec3(0, 0, 1000)), GRK_Result::Ok);
+  ASSERT_EQ(ecm.SetEntityCell(static_cast<GRK_Entity>(child), cell), GRK_Result::Ok);
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(index.QueryOverlaps(UnitBoxAt(glm::dvec3(20, 10, 1000)), results), 1u);
+  EXPECT_TRUE(index.Validate());
+
+  ASSERT_EQ(ecm.DeleteEntity(static_cast<GRK_Entity>(child)), GRK_Result::Ok);
+  ecm.GarbageCollect();
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_TRUE(index.Validate());
+}
@@ -0,0 +1,819 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "grok3d/grok3d.h"
+#include "grok3d/grok3d_types.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Grok3d;
+using namespace testing;
+
+class TestEntityComponentManager : public Test {
+ protected:
+  GRK_SystemManager systemManager_;
+  GRK_EntityComponentManager ecm_;
+
+  TestEntityComponentManager() {
+    ecm_.Initialize(&systemManager_);
+  }
+
+  auto CreateEntities(std::size_t count) -> std::vector<GRK_EntityHandle> {
+    std::vector<GRK_EntityHandle> entities;
+    for (std::size_t i = 0; i < count; i++) {
+      entities.push_back(ecm_.CreateEntity());
+    }
+    return entities;
+  }
+};
+
+TEST_F(TestEntityComponentManager, TestGarbageCollectSequential) {
+  auto entities = CreateEntities(10);
+  entities[3].AddComponent(GRK_GameLogicComponent());
+
+  auto deleted = static_cast<GRK_Entity>(entities[3]);
+  entities[3].Destroy();
+  ecm_.GarbageCollect();
+
+  EXPECT_EQ(ecm_.GetEntityComponentsBitMask(deleted), 0u);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), 9u);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_GameLogicComponent>()->size(), 0u);
+  EXPECT_TRUE(ecm_.GetDeletedUncleanedEntities().empty());
+}
+
+TEST_F(TestEntityComponentManager, TestGarbageCollectParallel) {
+  const auto entityCount = c_parallel_garbage_collect_threshold * 3;
+  auto entities = CreateEntities(entityCount);
+  for (std::size_t i = 0; i < entityCount; i += 2) {
+    entities[i].AddComponent(GRK_GameLogicComponent());
+  }
+
+  // Delete enough entities to take the multithreaded path, keeping every third one.
+  std::vector<GRK_Entity> deleted;
+  for (std::size_t i = 0; i < entityCount; i++) {
+    if (i % 3 != 0) {
+      deleted.push_back(static_cast<GRK_Entity>(entities[i]));
+      entities[i].Destroy();
+    }
+  }
+  ASSERT_GE(ecm_.GetDeletedUncleanedEntities().size(), c_parallel_garbage_collect_threshold);
+
+  ecm_.GarbageCollect();
+
+  for (auto entity : deleted) {
+    EXPECT_EQ(ecm_.GetEntityComponentsBitMask(entity), 0u);
+  }
+
+  const auto survivorCount = entityCount / 3;
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), survivorCount);
+
+  // Survivors still resolve to their own components after all the swap removals.
+  for (std::size_t i = 0; i < entityCount; i += 3) {
+    auto transform = entities[i].GetComponent<GRK_TransformComponent>();
+    EXPECT_TRUE(transform.IsHandleValid());
+    EXPECT_EQ(transform.GetOwningEntity(), static_cast<GRK_Entity>(entities[i]));
+    EXPECT_EQ(
+        entities[i].HasComponents(IndexToMask(
+            GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_GameLogicComponent>())),
+        i % 2 == 0);
+  }
+}
+
+/** A behaviour whose destructor reads other stores, like user teardown code. */
+class TestTeardownBehaviour : public GRK_GameBehaviourBase {
+ public:
+  TestTeardownBehaviour(GRK_EntityHandle owningEntity, const GRK_EntityComponentManager* ecm, std::string name,
+                        GRK_Entity anchor, std::atomic<int>& inconsistentTeardowns)
+      : GRK_GameBehaviourBase(owningEntity),
+        ecm_(ecm),
+        name_(std::move(name)),
+        anchor_(anchor),
+        inconsistentTeardowns_(inconsistentTeardowns) {}
+
+  ~TestTeardownBehaviour() override {
+    // Every other component of the collected entities is gone by now.
+    const auto isConsistent =
+        ecm_->FindEntityByName("anchor") == anchor_ &&
+        ecm_->FindEntityByName(name_) == 0 &&
+        ecm_->GetSpatialIndex().Size() == 1 &&
+        ecm_->GetComponentStore<GRK_TransformComponent>()->size() == 1;
+    if (!isConsistent) {
+      inconsistentTeardowns_++;
+    }
+  }
+
+  void Update(double) override {}
+
+ private:
+  const GRK_EntityComponentManager* ecm_;
+  std::string name_;
+  GRK_Entity anchor_;
+  std::atomic<int>& inconsistentTeardowns_;
+};
+
+TEST_F(TestEntityComponentManager, TestGarbageCollectParallelDestroysGameLogicLast) {
+  auto anchor = ecm_.CreateEntity();
+  ASSERT_EQ(anchor.AddComponent(GRK_NameComponent("anchor")), GRK_Result::Ok);
+  ASSERT_EQ(anchor.AddComponent(GRK_BoundsComponent(GRK_AABB{glm::dvec3(-1), glm::dvec3(1)})), GRK_Result::Ok);
+
+  std::atomic<int> inconsistentTeardowns{0};
+  auto entities = CreateEntities(c_parallel_garbage_collect_threshold * 2);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    const auto name = "teardown" + std::to_string(i);
+    ASSERT_EQ(entities[i].AddComponent(GRK_NameComponent(name)), GRK_Result::Ok);
+    ASSERT_EQ(entities[i].AddComponent(GRK_BoundsComponent(GRK_AABB{glm::dvec3(0), glm::dvec3(1)})), GRK_Result::Ok);
+    ASSERT_EQ(entities[i].AddComponent(GRK_GameLogicComponent()), GRK_Result::Ok);
+    entities[i].GetComponent<GRK_GameLogicComponent>()->RegisterBehaviour(std::make_unique<TestTeardownBehaviour>(
+        entities[i], &ecm_, name, static_cast<GRK_Entity>(anchor), inconsistentTeardowns));
+  }
+
+  for (auto& entity : entities) {
+    entity.Destroy();
+  }
+  ASSERT_GE(ecm_.GetDeletedUncleanedEntities().size(), c_parallel_garbage_collect_threshold);
+  ecm_.GarbageCollect();
+
+  EXPECT_EQ(inconsistentTeardowns, 0);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_GameLogicComponent>()->size(), 0u);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_NameComponent>()->size(), 1u);
+}
+
+/** A runtime component with a non trivial move and destructor. */
+struct TestRuntimeComponent {
+  std::string name;
+  int value;
+};
+
+TEST_F(TestEntityComponentManager, TestRuntimeComponents) {
+  GRK_RuntimeComponentID nameID;
+  GRK_RuntimeComponentID valueID = 0;
+  ASSERT_EQ(ecm_.RegisterRuntimeComponent<TestRuntimeComponent>("TestRuntimeComponent", nameID), GRK_Result::Ok);
+  ASSERT_EQ(ecm_.RegisterRuntimeComponent<double>("double", valueID), GRK_Result::Ok);
+  EXPECT_NE(nameID, valueID);
+
+  auto entities = CreateEntities(100);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    auto entity = static_cast<GRK_Entity>(entities[i]);
+    EXPECT_EQ(
+        ecm_.AddRuntimeComponent(entity, nameID, TestRuntimeComponent{"entity" + std::to_string(i), static_cast<int>(i)}),
+        GRK_Result::Ok);
+    double value = i * 0.5;
+    EXPECT_EQ(ecm_.AddRuntimeComponent(entity, valueID, value), GRK_Result::Ok);
+    EXPECT_TRUE(entities[i].HasComponents(ecm_.GetRuntimeComponentMask(nameID) | ecm_.GetRuntimeComponentMask(valueID)));
+  }
+
+  auto first = static_cast<GRK_Entity>(entities[0]);
+  EXPECT_EQ(ecm_.AddRuntimeComponent(first, valueID, 1.0), GRK_Result::ComponentAlreadyAdded);
+  EXPECT_EQ(ecm_.RemoveRuntimeComponent(first, valueID), GRK_Result::Ok);
+  EXPECT_EQ(ecm_.GetRuntimeComponent(first, valueID), nullptr);
+  EXPECT_FALSE(entities[0].HasComponents(ecm_.GetRuntimeComponentMask(valueID)));
+
+  // Delete every other entity and let garbage collection clean the runtime stores up.
+  for (std::size_t i = 0; i < entities.size(); i += 2) {
+    entities[i].Destroy();
+  }
+  ecm_.GarbageCollect();
+
+  EXPECT_EQ(ecm_.GetRuntimeComponentStore(nameID)->Size(), 50u);
+  EXPECT_EQ(ecm_.GetRuntimeComponentStore(valueID)->Size(), 50u);
+  for (std::size_t i = 1; i < entities.size(); i += 2) {
+    auto entity = static_cast<GRK_Entity>(entities[i]);
+    auto* component = ecm_.GetRuntimeComponent<TestRuntimeComponent>(entity, nameID);
+    ASSERT_NE(component, nullptr);
+    EXPECT_EQ(component->name, "entity" + std::to_string(i));
+    EXPECT_EQ(component->value, static_cast<int>(i));
+    EXPECT_EQ(*ecm_.GetRuntimeComponent<double>(entity, valueID), i * 0.5);
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestRuntimeComponentsRunOutOfBits) {
+  GRK_RuntimeComponentID id;
+  auto result = GRK_Result::Ok;
+  std::size_t registered = 0;
+  while ((result = ecm_.RegisterRuntimeComponent<int>("int", id)) == GRK_Result::Ok) {
+    registered++;
+  }
+
+  EXPECT_EQ(result, GRK_Result::NoSpaceRemaining);
+  // The top bit is reserved for kDisabledEntityMask.
+  EXPECT_EQ(registered, sizeof(GRK_ComponentBitMask) * 8 - 1 - GRK_EntityComponentManager::GetComponentTypeCount());
+}
+
+TEST_F(TestEntityComponentManager, TestQueriesFollowComponentChanges) {
+  const auto transformMask = IndexToMask(GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_TransformComponent>());
+  const auto logicMask = IndexToMask(GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_GameLogicComponent>());
+
+  auto entities = CreateEntities(4);
+  entities[0].AddComponent(GRK_GameLogicComponent());
+
+  // Built from a scan of the existing entities.
+  const auto* withLogic = ecm_.GetQuery<GRK_TransformComponent, GRK_GameLogicComponent>();
+  const auto* withoutLogic = ecm_.GetQuery(transformMask, logicMask);
+  EXPECT_EQ(withLogic, ecm_.GetQuery(transformMask | logicMask));
+  EXPECT_EQ(withLogic->Size(), 1u);
+  EXPECT_TRUE(withLogic->Contains(static_cast<GRK_Entity>(entities[0])));
+  EXPECT_EQ(withoutLogic->Size(), 3u);
+
+  // Kept up to date incrementally afterwards.
+  entities[1].AddComponent(GRK_GameLogicComponent());
+  EXPECT_EQ(withLogic->Size(), 2u);
+  EXPECT_EQ(withoutLogic->Size(), 2u);
+  EXPECT_FALSE(withoutLogic->Contains(static_cast<GRK_Entity>(entities[1])));
+
+  entities[0].RemoveComponent<GRK_GameLogicComponent>();
+  EXPECT_FALSE(withLogic->Contains(static_cast<GRK_Entity>(entities[0])));
+  EXPECT_TRUE(withoutLogic->Contains(static_cast<GRK_Entity>(entities[0])));
+
+  auto created = ecm_.CreateEntity();
+  EXPECT_TRUE(withoutLogic->Contains(static_cast<GRK_Entity>(created)));
+
+  entities[1].Destroy();
+  entities[2].Destroy();
+  ecm_.GarbageCollect();
+  EXPECT_EQ(withLogic->Size(), 0u);
+  EXPECT_EQ(withoutLogic->Size(), 3u);
+  for (auto entity : *withoutLogic) {
+    EXPECT_NE(entity, static_cast<GRK_Entity>(entities[2]));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestSortComponentStore) {
+  auto entities = CreateEntities(64);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    // Scramble the positions relative to creation order.
+    const auto x = static_cast<double>((i * 37) % entities.size());
+    entities[i].GetComponent<GRK_TransformComponent>()->SetWorldPosition(x, 0, 0);
+  }
+
+  auto positionKey = [](const GRK_TransformComponent& transform) {
+    return GRK_MortonKey(transform.GetWorldPosition(), 1.0);
+  };
+  ecm_.SortComponentStore<GRK_TransformComponent>(positionKey);
+
+  const auto& transforms = *ecm_.GetComponentStore<GRK_TransformComponent>();
+  for (std::size_t i = 1; i < transforms.size(); i++) {
+    EXPECT_LT(transforms[i - 1].GetWorldPosition().x, transforms[i].GetWorldPosition().x);
+  }
+
+  // Every entity still finds its own transform.
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    auto transform = entities[i].GetComponent<GRK_TransformComponent>();
+    EXPECT_EQ(transform.GetOwningEntity(), static_cast<GRK_Entity>(entities[i]));
+    EXPECT_EQ(transform->GetWorldPosition().x, static_cast<double>((i * 37) % entities.size()));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestSortComponentStoreIncrementalConverges) {
+  auto entities = CreateEntities(16);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    entities[i].GetComponent<GRK_TransformComponent>()->SetWorldPosition(static_cast<double>(entities.size() - i), 0, 0);
+  }
+
+  auto positionKey = [](GRK_Entity, const GRK_TransformComponent& transform) {
+    return transform.GetWorldPosition().x;
+  };
+
+  // Reversed order needs at most one pass per element, each pass is size - 1 comparisons.
+  std::size_t passes = 0;
+  while (ecm_.SortComponentStoreIncremental<GRK_TransformComponent>(positionKey, entities.size() - 1) > 0) {
+    passes++;
+    ASSERT_LE(passes, entities.size());
+  }
+
+  const auto& transforms = *ecm_.GetComponentStore<GRK_TransformComponent>();
+  for (std::size_t i = 1; i < transforms.size(); i++) {
+    EXPECT_LT(transforms[i - 1].GetWorldPosition().x, transforms[i].GetWorldPosition().x);
+  }
+
+  for (auto& entity : entities) {
+    EXPECT_EQ(entity.GetComponent<GRK_TransformComponent>().GetOwningEntity(), static_cast<GRK_Entity>(entity));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestMatchComponentStoreOrder) {
+  auto entities = CreateEntities(8);
+  for (auto i : {5, 2, 7, 0}) {
+    entities[i].AddComponent(GRK_GameLogicComponent());
+  }
+
+  ecm_.MatchComponentStoreOrder<GRK_GameLogicComponent, GRK_TransformComponent>();
+
+  // Transforms are in creation order, so the logic components now are too.
+  const std::size_t expected[] = {0, 2, 5, 7};
+  for (std::size_t i = 0; i < 4; i++) {
+    auto logic = entities[expected[i]].GetComponent<GRK_GameLogicComponent>();
+    EXPECT_EQ(logic.operator->(), &ecm_.GetComponentStore<GRK_GameLogicComponent>()->at(i));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestSnapshotsAreIsolatedFromLaterChanges) {
+  EXPECT_EQ(ecm_.AcquireSnapshot(), nullptr);
+
+  auto entities = CreateEntities(4);
+  entities[0].GetComponent<GRK_TransformComponent>()->SetWorldPosition(1, 2, 3);
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+
+  auto first = ecm_.AcquireSnapshot();
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->GetStore<GRK_TransformComponent>()->Size(), 4u);
+  EXPECT_EQ(first->GetStore<GRK_GameLogicComponent>(), nullptr);
+
+  entities[0].GetComponent<GRK_TransformComponent>()->SetWorldPosition(4, 5, 6);
+  const auto deleted = static_cast<GRK_Entity>(entities[1]);
+  entities[1].Destroy();
+  ecm_.GarbageCollect();
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+
+  // The old snapshot still sees the world as it was.
+  const auto* oldTransform = first->GetComponent<GRK_TransformComponent>(static_cast<GRK_Entity>(entities[0]));
+  ASSERT_NE(oldTransform, nullptr);
+  EXPECT_EQ(oldTransform->GetWorldPosition().x, 1.0);
+  EXPECT_NE(first->GetEntityComponentsBitMask(deleted), 0u);
+
+  auto second = ecm_.AcquireSnapshot();
+  EXPECT_EQ(second->GetSequence(), first->GetSequence() + 1);
+  EXPECT_EQ(second->GetComponent<GRK_TransformComponent>(static_cast<GRK_Entity>(entities[0]))->GetWorldPosition().x, 4.0);
+  EXPECT_EQ(second->GetComponent<GRK_TransformComponent>(deleted), nullptr);
+  EXPECT_EQ(second->GetEntityComponentsBitMask(deleted), 0u);
+}
+
+TEST_F(TestEntityComponentManager, TestSnapshotSharesUnchangedStores) {
+  CreateEntities(4);
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto first = ecm_.AcquireSnapshot();
+
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto second = ecm_.AcquireSnapshot();
+
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first->GetStore<GRK_TransformComponent>(), second->GetStore<GRK_TransformComponent>());
+
+  ecm_.CreateEntity();
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto third = ecm_.AcquireSnapshot();
+  EXPECT_NE(second->GetStore<GRK_TransformComponent>(), third->GetStore<GRK_TransformComponent>());
+}
+
+TEST_F(TestEntityComponentManager, TestSnapshotCopiesTransformsAfterTheSweep) {
+  auto entities = CreateEntities(2);
+  entities[1].GetComponent<GRK_TransformComponent>()->SetParent(entities[0].GetComponent<GRK_TransformComponent>().operator->());
+  entities[0].GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 0, 0);
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto dirty = ecm_.AcquireSnapshot();
+
+  // Only the sweep writes the store here, it must still count as a change.
+  ecm_.UpdateWorldTransforms();
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto swept = ecm_.AcquireSnapshot();
+  EXPECT_NE(dirty->GetStore<GRK_TransformComponent>(), swept->GetStore<GRK_TransformComponent>());
+
+  // The swept copy holds its own world matrix instead of walking the live parent.
+  entities[0].GetComponent<GRK_TransformComponent>()->TranslateLocal(5, 0, 0);
+  const auto child = static_cast<GRK_Entity>(entities[1]);
+  EXPECT_EQ(swept->GetComponent<GRK_TransformComponent>(child)->GetWorldPosition().x, 1.0);
+
+  // A sweep with nothing to update leaves the store shared.
+  ecm_.UpdateWorldTransforms();
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto moved = ecm_.AcquireSnapshot();
+  ecm_.UpdateWorldTransforms();
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  EXPECT_EQ(moved->GetStore<GRK_TransformComponent>(), ecm_.AcquireSnapshot()->GetStore<GRK_TransformComponent>());
+}
+
+TEST_F(TestEntityComponentManager, TestSnapshotTransformsAreDetached) {
+  auto entities = CreateEntities(3);
+  entities[1].GetComponent<GRK_TransformComponent>()->SetParent(entities[0].GetComponent<GRK_TransformComponent>().operator->());
+  entities[2].GetComponent<GRK_TransformComponent>()->SetParent(entities[0].GetComponent<GRK_TransformComponent>().operator->());
+  entities[0].GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 0, 0);
+  entities[1].GetComponent<GRK_TransformComponent>()->TranslateLocal(0, 2, 0);
+
+  // Published dirty, the copies are cleaned on the way in.
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+  auto snapshot = ecm_.AcquireSnapshot();
+  entities[0].GetComponent<GRK_TransformComponent>()->TranslateLocal(5, 0, 0);
+
+  const auto* parent = snapshot->GetComponent<GRK_TransformComponent>(static_cast<GRK_Entity>(entities[0]));
+  const auto* child = snapshot->GetComponent<GRK_TransformComponent>(static_cast<GRK_Entity>(entities[1]));
+  ASSERT_NE(child, nullptr);
+  EXPECT_FALSE(child->IsWorldDirty());
+  EXPECT_EQ(child->GetWorldPosition(), glm::dvec3(1, 2, 0));
+  EXPECT_EQ(child->GetInterpolatedWorldMatrix(0.5), child->GetWorldMatrix());
+
+  // The links are only entities, nothing leads back into the live store.
+  EXPECT_EQ(child->GetParentEntity(), static_cast<GRK_Entity>(entities[0]));
+  EXPECT_EQ(child->GetParent(), nullptr);
+  EXPECT_EQ(parent->GetChild(0), nullptr);
+  EXPECT_EQ(parent->GetChild(1), nullptr);
+  EXPECT_EQ(entities[0].GetComponent<GRK_TransformComponent>()->ChildCount(), 2);
+  EXPECT_EQ(entities[1].GetComponent<GRK_TransformComponent>()->GetParent(),
+            entities[0].GetComponent<GRK_TransformComponent>().operator->());
+}
+
+TEST_F(TestEntityComponentManager, TestSnapshotReadWhileWriting) {
+  auto entities = CreateEntities(64);
+  ecm_.PublishSnapshot<GRK_TransformComponent>();
+
+  std::atomic<bool> done(false);
+  std::thread reader([this, &done]() {
+    while (!done) {
+      auto snapshot = ecm_.AcquireSnapshot();
+      const auto& store = snapshot->GetStore<GRK_TransformComponent>()->GetStore();
+      // Every published version has all transforms on one x value.
+      for (const auto& transform : store) {
+        ASSERT_EQ(transform.GetWorldPosition().x, store[0].GetWorldPosition().x);
+      }
+    }
+  });
+
+  for (int frame = 1; frame <= 200; frame++) {
+    for (auto& entity : entities) {
+      entity.GetComponent<GRK_TransformComponent>()->SetWorldPosition(frame, 0, 0);
+    }
+    ecm_.PublishSnapshot<GRK_TransformComponent>();
+  }
+
+  done = true;
+  reader.join();
+  EXPECT_EQ(ecm_.AcquireSnapshot()->GetSequence(), 201u);
+}
+
+TEST_F(TestEntityComponentManager, TestCapacityPolicyGrowsAndShrinks) {
+  GRK_CapacityPolicy policy;
+  policy.growthNumerator = 1;
+  policy.growthDenominator = 1;
+  policy.minimumGrowth = 8;
+  policy.minimumCapacity = 16;
+  policy.shrinkAfterCollections = 3;
+  ASSERT_EQ(ecm_.SetCapacityPolicy<GRK_TransformComponent>(policy), GRK_Result::Ok);
+
+  const auto* transforms = ecm_.GetComponentStore<GRK_TransformComponent>();
+  const auto initialCapacity = transforms->capacity();
+
+  auto entities = CreateEntities(initialCapacity + 1);
+  EXPECT_EQ(transforms->capacity(), initialCapacity * 2);
+
+  for (std::size_t i = 10; i < entities.size(); i++) {
+    entities[i].Destroy();
+  }
+
+  // Has to stay underused for shrinkAfterCollections collections in a row.
+  ecm_.GarbageCollect();
+  ecm_.GarbageCollect();
+  EXPECT_EQ(transforms->capacity(), initialCapacity * 2);
+  ecm_.GarbageCollect();
+  EXPECT_EQ(transforms->size(), 10u);
+  EXPECT_EQ(transforms->capacity(), GRK_ShrunkCapacity(policy, 10));
+
+  for (std::size_t i = 0; i < 10; i++) {
+    EXPECT_EQ(entities[i].GetComponent<GRK_TransformComponent>().GetOwningEntity(), static_cast<GRK_Entity>(entities[i]));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestCapacityPolicyRejectsUnusablePolicies) {
+  GRK_CapacityPolicy zeroDenominator;
+  zeroDenominator.growthDenominator = 0;
+  EXPECT_EQ(ecm_.SetCapacityPolicy<GRK_TransformComponent>(zeroDenominator), GRK_Result::InvalidArgument);
+
+  GRK_RuntimeComponentInfo info = GRK_MakeRuntimeComponentInfo<double>("value");
+  GRK_RuntimeComponentID valueID = 0;
+  info.alignment = 0;
+  EXPECT_EQ(ecm_.RegisterRuntimeComponent(info, valueID), GRK_Result::InvalidArgument);
+  info.alignment = 12;
+  EXPECT_EQ(ecm_.RegisterRuntimeComponent(info, valueID), GRK_Result::InvalidArgument);
+  info.alignment = alignof(double);
+  info.capacityPolicy = zeroDenominator;
+  EXPECT_EQ(ecm_.RegisterRuntimeComponent(info, valueID), GRK_Result::InvalidArgument);
+
+  // No minimum growth or capacity still grows an empty store.
+  info.capacityPolicy = GRK_CapacityPolicy();
+  info.capacityPolicy.minimumGrowth = 0;
+  info.capacityPolicy.minimumCapacity = 0;
+  ASSERT_EQ(ecm_.RegisterRuntimeComponent(info, valueID), GRK_Result::Ok);
+  EXPECT_EQ(ecm_.SetCapacityPolicy(valueID, zeroDenominator), GRK_Result::InvalidArgument);
+  EXPECT_EQ(GRK_GrowCapacity(info.capacityPolicy, 0), 1u);
+
+  auto entities = CreateEntities(3);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    double value = static_cast<double>(i);
+    ASSERT_EQ(ecm_.AddRuntimeComponent(static_cast<GRK_Entity>(entities[i]), valueID, value), GRK_Result::Ok);
+  }
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    EXPECT_EQ(*ecm_.GetRuntimeComponent<double>(static_cast<GRK_Entity>(entities[i]), valueID), static_cast<double>(i));
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestMemoryReport) {
+  GRK_RuntimeComponentID valueID = 0;
+  ASSERT_EQ(ecm_.RegisterRuntimeComponent<double>("value", valueID), GRK_Result::Ok);
+
+  auto entities = CreateEntities(5);
+  for (auto& entity : entities) {
+    double value = 1.0;
+    ecm_.AddRuntimeComponent(static_cast<GRK_Entity>(entity), valueID, value);
+  }
+
+  const auto reports = ecm_.GetMemoryReport();
+  ASSERT_EQ(reports.size(), GRK_EntityComponentManager::GetComponentTypeCount() + 1);
+
+  const auto& transformReport = reports[GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_TransformComponent>()];
+  EXPECT_EQ(transformReport.size, 5u);
+  EXPECT_EQ(transformReport.storeBytesUsed, 5 * sizeof(GRK_TransformComponent));
+  EXPECT_EQ(transformReport.storeBytesReserved, transformReport.capacity * sizeof(GRK_TransformComponent));
+  EXPECT_GT(transformReport.indexBytesReserved, transformReport.indexBytesUsed);
+
+  const auto& valueReport = reports.back();
+  EXPECT_EQ(valueReport.name, "value");
+  EXPECT_EQ(valueReport.componentTypeIndex, GRK_EntityComponentManager::GetComponentTypeCount() + valueID);
+  EXPECT_EQ(valueReport.storeBytesUsed, 5 * sizeof(double));
+}
+
+TEST_F(TestEntityComponentManager, TestDisabledEntitiesArePartitionedToTheTail) {
+  auto entities = CreateEntities(6);
+  const auto* transforms = ecm_.GetComponentStore<GRK_TransformComponent>();
+  const auto* everything = ecm_.GetQuery<GRK_TransformComponent>();
+
+  ASSERT_EQ(entities[1].Disable(), GRK_Result::Ok);
+  ASSERT_EQ(entities[3].Disable(), GRK_Result::Ok);
+  EXPECT_FALSE(entities[1].IsEnabled());
+  EXPECT_TRUE(entities[2].IsEnabled());
+  EXPECT_EQ(ecm_.GetActiveComponentCount<GRK_TransformComponent>(), 4u);
+  EXPECT_EQ(everything->Size(), 4u);
+  EXPECT_FALSE(everything->Contains(static_cast<GRK_Entity>(entities[1])));
+
+  auto isInTail = [&](GRK_EntityHandle& entity) {
+    const auto* transform = entity.GetComponent<GRK_TransformComponent>().operator->();
+    return transform >= &(*transforms)[ecm_.GetActiveComponentCount<GRK_TransformComponent>()];
+  };
+  EXPECT_TRUE(isInTail(entities[1]));
+  EXPECT_TRUE(isInTail(entities[3]));
+  EXPECT_FALSE(isInTail(entities[0]));
+
+  // New enabled components go in front of the disabled ones, removals keep the partition.
+  auto created = ecm_.CreateEntity();
+  EXPECT_FALSE(isInTail(created));
+  entities[0].Destroy();
+  ecm_.GarbageCollect();
+  EXPECT_EQ(ecm_.GetActiveComponentCount<GRK_TransformComponent>(), 4u);
+  EXPECT_TRUE(isInTail(entities[1]));
+  EXPECT_TRUE(isInTail(entities[3]));
+
+  ASSERT_EQ(entities[1].Enable(), GRK_Result::Ok);
+  EXPECT_TRUE(entities[1].IsEnabled());
+  EXPECT_FALSE(isInTail(entities[1]));
+  EXPECT_TRUE(everything->Contains(static_cast<GRK_Entity>(entities[1])));
+  EXPECT_EQ(ecm_.GetActiveComponentCount<GRK_TransformComponent>(), 5u);
+
+  for (auto& entity : entities) {
+    if (!entity.IsDestroyed()) {
+      EXPECT_EQ(entity.GetComponent<GRK_TransformComponent>().GetOwningEntity(), static_cast<GRK_Entity>(entity));
+    }
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestDisabledEntitiesCanStillBeQueried) {
+  auto entities = CreateEntities(3);
+  entities[2].Disable();
+
+  const auto transformMask = IndexToMask(GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_TransformComponent>());
+  const auto* disabled = ecm_.GetQuery(transformMask | kDisabledEntityMask);
+  EXPECT_EQ(disabled->Size(), 1u);
+  EXPECT_TRUE(disabled->Contains(static_cast<GRK_Entity>(entities[2])));
+}
+
+namespace {
+struct MoveRightSystem {
+  using Include = GRK_ComponentList<GRK_TransformComponent>;
+  using Exclude = GRK_ComponentList<GRK_GameLogicComponent>;
+
+  auto Update(double dt, GRK_Entity, GRK_TransformComponent& transform) -> void {
+    transform.TranslateLocal(dt, 0, 0);
+  }
+};
+
+struct CountScriptedSystem {
+  using Include = GRK_ComponentList<GRK_TransformComponent, GRK_GameLogicComponent>;
+
+  auto Initialize(GRK_EntityComponentManager*) -> GRK_Result {
+    initialized = true;
+    return GRK_Result::Ok;
+  }
+
+  auto Update(double, GRK_Entity, GRK_TransformComponent&, GRK_GameLogicComponent&) -> void {
+    updates++;
+  }
+
+  bool initialized = false;
+  std::size_t updates = 0;
+};
+}
+
+TEST_F(TestEntityComponentManager, TestSystemPipelineUpdatesMatchingEntities) {
+  using Pipeline = GRK_SystemPipeline<MoveRightSystem, CountScriptedSystem>;
+  static_assert(Pipeline::GetSignature<MoveRightSystem>().exclude ==
+                IndexToMask(GRK_EntityComponentManager::GetComponentTypeAccessIndex<GRK_GameLogicComponent>()));
+
+  auto entities = CreateEntities(3);
+  entities[2].AddComponent(GRK_GameLogicComponent());
+
+  Pipeline pipeline;
+  ASSERT_EQ(pipeline.Initialize(&ecm_), GRK_Result::Ok);
+  EXPECT_TRUE(pipeline.GetSystem<CountScriptedSystem>().initialized);
+  EXPECT_EQ(pipeline.GetSystemQuery<MoveRightSystem>()->Size(), 2u);
+
+  // Entities added after Initialize are picked up by the cached queries.
+  auto late = ecm_.CreateEntity();
+  late.AddComponent(GRK_GameLogicComponent());
+
+  pipeline.Update(1.0);
+  pipeline.Update(1.0);
+
+  EXPECT_EQ(entities[0].GetComponent<GRK_TransformComponent>()->GetWorldPosition().x, 2.0);
+  EXPECT_EQ(entities[1].GetComponent<GRK_TransformComponent>()->GetWorldPosition().x, 2.0);
+  EXPECT_EQ(entities[2].GetComponent<GRK_TransformComponent>()->GetWorldPosition().x, 0.0);
+  EXPECT_EQ(pipeline.GetSystem<CountScriptedSystem>().updates, 4u);
+}
+
+TEST_F(TestEntityComponentManager, TestFindEntityByName) {
+  auto entities = CreateEntities(3);
+  EXPECT_EQ(entities[0].AddComponent(GRK_NameComponent("player")), GRK_Result::Ok);
+  EXPECT_EQ(entities[1].AddComponent(GRK_NameComponent("boss_turret_3")), GRK_Result::Ok);
+  EXPECT_EQ(entities[2].AddComponent(GRK_NameComponent("player")), GRK_Result::NameAlreadyTaken);
+
+  const auto player = GRK_SymbolTable::Global().Find("player");
+  EXPECT_NE(player, kNoSymbol);
+  EXPECT_EQ(ecm_.FindEntityByName(player), static_cast<GRK_Entity>(entities[0]));
+  EXPECT_EQ(ecm_.FindEntityByName("boss_turret_3"), static_cast<GRK_Entity>(entities[1]));
+  EXPECT_EQ(ecm_.FindEntityByName("never_interned"), 0u);
+  EXPECT_EQ(GRK_SymbolTable::Global().Find("never_interned"), kNoSymbol);
+  EXPECT_EQ(entities[1].GetComponent<GRK_NameComponent>()->GetNameString(), "boss_turret_3");
+
+  // Once the first player is gone the name is free again.
+  const auto firstPlayer = static_cast<GRK_Entity>(entities[0]);
+  entities[0].Destroy();
+  EXPECT_EQ(ecm_.FindEntityByName(player), firstPlayer);
+  ecm_.GarbageCollect();
+  EXPECT_EQ(ecm_.FindEntityByName(player), 0u);
+  EXPECT_EQ(entities[2].AddComponent(GRK_NameComponent(player)), GRK_Result::Ok);
+  EXPECT_EQ(ecm_.FindEntityByName(player), static_cast<GRK_Entity>(entities[2]));
+}
+
+TEST_F(TestEntityComponentManager, TestSymbolIndexSurvivesChurn) {
+  GRK_SymbolIndex index;
+  for (GRK_Symbol symbol = 1; symbol <= 1000; symbol++) {
+    index.Put(symbol, symbol * 10);
+  }
+  for (GRK_Symbol symbol = 1; symbol <= 1000; symbol += 2) {
+    index.Erase(symbol);
+  }
+
+  EXPECT_EQ(index.Size(), 500u);
+  for (GRK_Symbol symbol = 1; symbol <= 1000; symbol++) {
+    EXPECT_EQ(index.Find(symbol), symbol % 2 == 0 ? symbol * 10 : 0u);
+  }
+}
+
+TEST_F(TestEntityComponentManager, TestCellSaveUnloadLoadRoundTrip) {
+  constexpr GRK_CellID cell = 7;
+  auto entities = CreateEntities(4);
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    entities[i].GetComponent<GRK_TransformComponent>()->TranslateLocal(static_cast<double>(i), 0, 0);
+    ASSERT_EQ(ecm_.SetEntityCell(static_cast<GRK_Entity>(entities[i]), i < 3 ? cell : kNoCell), GRK_Result::Ok);
+  }
+  entities[2].GetComponent<GRK_TransformComponent>()->SetLocalScale(2, 2, 2);
+  entities[1].Disable();
+  EXPECT_EQ(ecm_.GetCellEntities(cell).size(), 3u);
+  EXPECT_EQ(ecm_.GetEntityCell(static_cast<GRK_Entity>(entities[3])), kNoCell);
+
+  std::vector<std::byte> blob;
+  ASSERT_EQ(ecm_.SaveCell(cell, blob), GRK_Result::Ok);
+  ASSERT_EQ(ecm_.UnloadCell(cell), GRK_Result::Ok);
+  EXPECT_TRUE(ecm_.GetCellEntities(cell).empty());
+  EXPECT_EQ(ecm_.UnloadCell(cell), GRK_Result::NoSuchElement);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), 1u);
+
+  ASSERT_EQ(ecm_.LoadCell(blob), GRK_Result::Ok);
+  EXPECT_EQ(ecm_.LoadCell(blob), GRK_Result::CellAlreadyLoaded);
+  ASSERT_EQ(ecm_.GetCellEntities(cell).size(), 3u);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), 4u);
+  EXPECT_EQ(ecm_.GetActiveComponentCount<GRK_TransformComponent>(), 3u);
+  EXPECT_EQ(ecm_.GetQuery<GRK_TransformComponent>()->Size(), 3u);
+
+  const auto defaultScale = GRK_TransformComponent().GetLocalScale().x;
+  std::vector<double> positions;
+  for (const auto entity : ecm_.GetCellEntities(cell)) {
+    GRK_EntityHandle handle(&ecm_, entity);
+    auto transform = handle.GetComponent<GRK_TransformComponent>();
+    EXPECT_EQ(transform.GetOwningEntity(), entity);
+    EXPECT_EQ(handle.IsEnabled(), transform->GetLocalPosition().x != 1.0);
+    EXPECT_EQ(transform->GetLocalScale().x, transform->GetLocalPosition().x == 2.0 ? 2.0 : defaultScale);
+    positions.push_back(transform->GetLocalPosition().x);
+  }
+  EXPECT_THAT(positions, UnorderedElementsAre(0.0, 1.0, 2.0));
+}
+
+TEST_F(TestEntityComponentManager, TestCellRoundTripKeepsParentLinks) {
+  constexpr GRK_CellID cell = 9;
+  // outside <- door, and house <- (roof <- chimney, wall), with everything but outside in the cell.
+  auto entities = CreateEntities(6);
+  auto transform = [&entities](std::size_t i) { return entities[i].GetComponent<GRK_TransformComponent>(); };
+  enum { kOutside, kDoor, kHouse, kWall, kRoof, kChimney };
+  transform(kDoor)->SetParent(transform(kOutside).operator->());
+  transform(kRoof)->SetParent(transform(kHouse).operator->());
+  transform(kWall)->SetParent(transform(kHouse).operator->());
+  transform(kChimney)->SetParent(transform(kRoof).operator->());
+  transform(kHouse)->TranslateLocal(10, 0, 0);
+  transform(kRoof)->TranslateLocal(0, 3, 0);
+  transform(kChimney)->TranslateLocal(1, 1, 0);
+  for (std::size_t i = kDoor; i < entities.size(); i++) {
+    ASSERT_EQ(ecm_.SetEntityCell(static_cast<GRK_Entity>(entities[i]), cell), GRK_Result::Ok);
+  }
+
+  std::vector<std::byte> blob;
+  ASSERT_EQ(ecm_.SaveCell(cell, blob), GRK_Result::Ok);
+  ASSERT_EQ(ecm_.UnloadCell(cell), GRK_Result::Ok);
+  ASSERT_EQ(ecm_.LoadCell(blob), GRK_Result::Ok);
+  ecm_.UpdateWorldTransforms();
+
+  // Find the loaded entities by their local positions.
+  auto find = [this](const glm::dvec3& localPosition) -> GRK_TransformComponent* {
+    for (const auto entity : ecm_.GetCellEntities(cell)) {
+      auto* loaded = ecm_.GetTransformHierarchy().GetTransform(entity);
+      if (loaded->GetLocalPosition() == localPosition) {
+        return loaded;
+      }
+    }
+    return nullptr;
+  };
+  auto* house = find(glm::dvec3(10, 0, 0));
+  auto* roof = find(glm::dvec3(0, 3, 0));
+  auto* chimney = find(glm::dvec3(1, 1, 0));
+  ASSERT_NE(house, nullptr);
+  ASSERT_NE(roof, nullptr);
+  ASSERT_NE(chimney, nullptr);
+  EXPECT_EQ(house->GetParent(), nullptr);
+  EXPECT_EQ(roof->GetParent(), house);
+  EXPECT_EQ(chimney->GetParent(), roof);
+  ASSERT_EQ(house->ChildCount(), 2);
+  EXPECT_EQ(house->GetChild(0), roof);
+  EXPECT_EQ(chimney->GetWorldPosition(), glm::dvec3(11, 4, 0));
+  EXPECT_EQ(ecm_.GetTransformHierarchy().GetLevels().size(), 3u);
+
+  // The door's parent stayed outside the cell, so it loads as a root.
+  std::size_t roots = 0;
+  for (const auto entity : ecm_.GetCellEntities(cell)) {
+    roots += ecm_.GetTransformHierarchy().GetTransform(entity)->GetParent() == nullptr ? 1 : 0;
+  }
+  EXPECT_EQ(roots, 2u);
+  EXPECT_EQ(transform(kOutside)->ChildCount(), 0);
+}
+
+TEST_F(TestEntityComponentManager, TestLoadCellRejectsMalformedBlobs) {
+  constexpr GRK_CellID cell = 3;
+  auto entities = CreateEntities(2);
+  for (auto& entity : entities) {
+    ecm_.SetEntityCell(static_cast<GRK_Entity>(entity), cell);
+  }
+
+  std::vector<std::byte> blob;
+  ASSERT_EQ(ecm_.SaveCell(cell, blob), GRK_Result::Ok);
+  ASSERT_EQ(ecm_.UnloadCell(cell), GRK_Result::Ok);
+
+  auto truncated = blob;
+  truncated.resize(blob.size() - 8);
+  EXPECT_EQ(ecm_.LoadCell(truncated), GRK_Result::MalformedData);
+
+  auto badMagic = blob;
+  badMagic[0] = std::byte{0};
+  EXPECT_EQ(ecm_.LoadCell(badMagic), GRK_Result::MalformedData);
+
+  // Claiming an extra entity leaves it without a transform.
+  auto extraEntity = blob;
+  GRK_CellBlobHeader header;
+  std::memcpy(&header, extraEntity.data(), sizeof(header));
+  header.entityCount++;
+  std::memcpy(extraEntity.data(), &header, sizeof(header));
+  EXPECT_EQ(ecm_.LoadCell(extraEntity), GRK_Result::MalformedData);
+
+  // Two transforms that are each other's parent.
+  auto cycle = blob;
+  const GRK_CellBlobParentLink links[2] = {{1, 0}, {0, 0}};
+  std::memcpy(
+      cycle.data() + GRK_CellBlobPadded(sizeof(GRK_CellBlobHeader)) + GRK_CellBlobPadded(2 * sizeof(std::uint32_t)),
+      links,
+      sizeof(links));
+  EXPECT_EQ(ecm_.LoadCell(cycle), GRK_Result::MalformedData);
+
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), 0u);
+  EXPECT_EQ(ecm_.LoadCell(blob), GRK_Result::Ok);
+  EXPECT_EQ(ecm_.GetComponentStore<GRK_TransformComponent>()->size(), 2u);
+}
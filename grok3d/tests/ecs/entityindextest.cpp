@@ -0,0 +1,96 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "grok3d/ecs/store/EntityIndex.h"
+
+using namespace Grok3d;
+using namespace testing;
+
+struct TestDirectComponent {};
+struct TestSparseComponent {};
+struct TestHashedComponent {};
+
+namespace Grok3d {
+template<>
+struct GRK_EntityIndexStrategyOf<TestDirectComponent> {
+  static constexpr GRK_EntityIndexStrategy value = GRK_EntityIndexStrategy::Direct;
+};
+
+template<>
+struct GRK_EntityIndexStrategyOf<TestHashedComponent> {
+  static constexpr GRK_EntityIndexStrategy value = GRK_EntityIndexStrategy::Hashed;
+};
+}
+
+static_assert(std::is_same<GRK_EntityIndex<TestDirectComponent>::Slots, GRK_DirectEntitySlots>::value);
+static_assert(std::is_same<GRK_EntityIndex<TestSparseComponent>::Slots, GRK_PagedEntitySlots>::value);
+static_assert(std::is_same<GRK_EntityIndex<TestHashedComponent>::Slots, GRK_HashedEntitySlots>::value);
+static_assert(std::is_same<GRK_EntityIndex<GRK_TransformComponent>::Slots, GRK_DirectEntitySlots>::value);
+
+template<class ComponentType>
+class TestEntityIndex : public Test {
+ protected:
+  GRK_EntityIndex<ComponentType> index_;
+};
+
+using IndexedComponentTypes = Types<TestDirectComponent, TestSparseComponent, TestHashedComponent>;
+TYPED_TEST_CASE(TestEntityIndex, IndexedComponentTypes);
+
+TYPED_TEST(TestEntityIndex, TestPutAndLookUp) {
+  auto& index = this->index_;
+  index.put(3, 0);
+  index.put(1000, 1);
+
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_TRUE(index.contains(1000));
+  EXPECT_FALSE(index.contains(4));
+  EXPECT_EQ(index.at(3), 0u);
+  EXPECT_EQ(index.at(4), kNoComponentInstance);
+  EXPECT_EQ(index.reverse_at(1), 1000u);
+}
+
+TYPED_TEST(TestEntityIndex, TestSwapRemoveSequence) {
+  auto& index = this->index_;
+  index.put(10, 0);
+  index.put(20, 1);
+  index.put(30, 2);
+
+  // Swap 10 and 30, then remove 30 the way the manager does: erase it, then move the last one
+  // into its place.
+  index.put(10, 2);
+  index.put(30, 0);
+  index.erase(30);
+  index.reverse_erase(2);
+  index.put(10, 0);
+
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_FALSE(index.contains(30));
+  EXPECT_EQ(index.at(10), 0u);
+  EXPECT_EQ(index.at(20), 1u);
+  EXPECT_EQ(index.reverse_at(0), 10u);
+  EXPECT_EQ(index.reverse_at(1), 20u);
+}
+
+TYPED_TEST(TestEntityIndex, TestShrinkKeepsEntries) {
+  auto& index = this->index_;
+  for (GRK_Entity entity = 1; entity <= 1000; entity++) {
+    index.put(entity, entity - 1);
+  }
+  for (GRK_Entity entity = 1000; entity > 1; entity--) {
+    index.erase(entity);
+  }
+
+  std::size_t usedBefore, reservedBefore;
+  index.EstimateBytes(usedBefore, reservedBefore);
+  index.shrink_to_fit();
+  std::size_t usedAfter, reservedAfter;
+  index.EstimateBytes(usedAfter, reservedAfter);
+
+  EXPECT_LT(reservedAfter, reservedBefore);
+  EXPECT_EQ(index.size(), 1u);
+  EXPECT_EQ(index.at(1), 0u);
+  EXPECT_EQ(index.reverse_at(0), 1u);
+}
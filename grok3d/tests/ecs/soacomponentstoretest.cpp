@@ -0,0 +1,191 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "grok3d/ecs/store/ComponentStore.h"
+#include "grok3d/ecs/EntityComponentManager.h"
+
+#include <string>
+
+using namespace Grok3d;
+using namespace testing;
+
+class TestSoAComponent {
+ public:
+  TestSoAComponent() = default;
+  TestSoAComponent(float position, int health, std::string name)
+      : position_(position), health_(health), name_(std::move(name)) {}
+
+  auto GetPosition() const { return position_; }
+  auto GetHealth() const { return health_; }
+  auto GetName() const { return name_; }
+
+ private:
+  float position_ = 0;
+  int health_ = 0;
+  std::string name_;
+
+ public:
+  GRK_FIELDS(TestSoAComponent, position_, health_, name_);
+};
+
+/** Pointers to the private members, taken from the field list. */
+static constexpr auto kPosition = std::get<0>(GRK_ComponentFields<TestSoAComponent>::type::members);
+static constexpr auto kHealth = std::get<1>(GRK_ComponentFields<TestSoAComponent>::type::members);
+
+namespace Grok3d {
+template<>
+struct GRK_UseSoALayout<TestSoAComponent> : std::true_type {};
+}
+
+TEST(SoAComponentStoreTests, TestStoreSelection) {
+  EXPECT_TRUE((std::is_same<GRK_ComponentStore<TestSoAComponent>, GRK_SoAComponentStore<TestSoAComponent>>::value));
+  EXPECT_TRUE((std::is_same<GRK_ComponentStore<int>, std::vector<int>>::value));
+  EXPECT_EQ(GRK_ComponentFields<TestSoAComponent>::type::size, 3u);
+  EXPECT_EQ(GRK_ComponentFields<TestSoAComponent>::type::IndexOf<kHealth>(), 1u);
+}
+
+TEST(SoAComponentStoreTests, TestPushBackAndGather) {
+  GRK_ComponentStore<TestSoAComponent> store;
+  store.reserve(8);
+  EXPECT_GE(store.capacity(), 8u);
+
+  store.push_back(TestSoAComponent(1.0f, 10, "a"));
+  store.push_back(TestSoAComponent(2.0f, 20, "b"));
+
+  ASSERT_EQ(store.size(), 2u);
+  TestSoAComponent second = store[1];
+  EXPECT_EQ(second.GetPosition(), 2.0f);
+  EXPECT_EQ(second.GetHealth(), 20);
+  EXPECT_EQ(second.GetName(), "b");
+
+  store[0].Get<kHealth>() = 15;
+  EXPECT_EQ(store.Get<kHealth>(0), 15);
+}
+
+TEST(SoAComponentStoreTests, TestColumnIsContiguous) {
+  GRK_SoAComponentStore<TestSoAComponent> store;
+  for (int i = 0; i < 16; i++) {
+    store.push_back(TestSoAComponent(static_cast<float>(i), i, "x"));
+  }
+
+  auto positions = store.Column<kPosition>();
+  ASSERT_EQ(positions.size(), 16u);
+  for (auto& position : positions) {
+    position *= 2;
+  }
+
+  for (std::size_t i = 0; i < store.size(); i++) {
+    EXPECT_EQ(static_cast<TestSoAComponent>(store[i]).GetPosition(), 2.0f * i);
+    EXPECT_EQ(&positions[i], &store.Get<kPosition>(i));
+  }
+}
+
+TEST(SoAComponentStoreTests, TestSwapRemove) {
+  GRK_SoAComponentStore<TestSoAComponent> store;
+  store.push_back(TestSoAComponent(1.0f, 1, "first"));
+  store.push_back(TestSoAComponent(2.0f, 2, "second"));
+  store.push_back(TestSoAComponent(3.0f, 3, "third"));
+
+  // What the entity component manager does when removing a component.
+  store[0] = std::move(store.back());
+  store.pop_back();
+
+  ASSERT_EQ(store.size(), 2u);
+  TestSoAComponent moved = store[0];
+  EXPECT_EQ(moved.GetPosition(), 3.0f);
+  EXPECT_EQ(moved.GetHealth(), 3);
+  EXPECT_EQ(moved.GetName(), "third");
+
+  swap(store[0], store[1]);
+  EXPECT_EQ(static_cast<TestSoAComponent>(store[0]).GetName(), "second");
+  EXPECT_EQ(static_cast<TestSoAComponent>(store[1]).GetName(), "third");
+}
+
+TEST(SoAComponentStoreTests, TestShrinkTo) {
+  GRK_ComponentStore<TestSoAComponent> store;
+  store.reserve(64);
+  for (int i = 0; i < 5; i++) {
+    store.push_back(TestSoAComponent(static_cast<float>(i), i, std::to_string(i)));
+  }
+
+  GRK_ShrinkStoreTo(store, 8);
+  EXPECT_EQ(store.capacity(), 8u);
+  ASSERT_EQ(store.size(), 5u);
+  for (std::size_t i = 0; i < store.size(); i++) {
+    EXPECT_EQ(static_cast<TestSoAComponent>(store[i]).GetName(), std::to_string(i));
+  }
+
+  // Never under the size and never up.
+  GRK_ShrinkStoreTo(store, 2);
+  EXPECT_EQ(store.capacity(), 5u);
+  GRK_ShrinkStoreTo(store, 32);
+  EXPECT_EQ(store.capacity(), 5u);
+
+  std::vector<int> values(3, 7);
+  values.reserve(100);
+  GRK_ShrinkStoreTo(values, 10);
+  EXPECT_EQ(values.capacity(), 10u);
+  EXPECT_EQ(values, std::vector<int>(3, 7));
+}
+
+/** The built in components with a struct of arrays one added, so the manager's paths for the
+ * layout are exercised. */
+using TestSoAManager = GRK_EntityComponentManager__<GRK_TransformComponent,
+                                                    GRK_GameLogicComponent,
+                                                    GRK_RenderComponent,
+                                                    GRK_NameComponent,
+                                                    GRK_BoundsComponent,
+                                                    TestSoAComponent>;
+
+static auto HealthOf(TestSoAManager& ecm, GRK_Entity entity) -> int {
+  auto reference = ecm.GetComponentReference<TestSoAComponent>(entity);
+  return reference.IsValid() ? reference.Get<kHealth>() : -1;
+}
+
+TEST(SoAComponentStoreTests, TestManagerStore) {
+  TestSoAManager ecm;
+  std::vector<GRK_Entity> entities;
+  for (int i = 0; i < 4; i++) {
+    entities.push_back(static_cast<GRK_Entity>(ecm.CreateEntity()));
+    ASSERT_EQ(
+        ecm.AddComponent(entities.back(), TestSoAComponent(static_cast<float>(i), i * 10, std::to_string(i))),
+        GRK_Result::Ok);
+  }
+  const auto bare = static_cast<GRK_Entity>(ecm.CreateEntity());
+
+  // References write through to the columns.
+  EXPECT_FALSE(ecm.GetComponentReference<TestSoAComponent>(bare).IsValid());
+  ecm.GetComponentReference<TestSoAComponent>(entities[2]).Get<kHealth>() = 25;
+  auto health = ecm.GetComponentColumn<TestSoAComponent, kHealth>();
+  ASSERT_EQ(health.size(), 4u);
+  EXPECT_EQ(health[2], 25);
+  EXPECT_EQ(static_cast<TestSoAComponent>(ecm.GetComponentReference<TestSoAComponent>(entities[3])).GetName(), "3");
+
+  // Removal swaps the last component into the hole.
+  ASSERT_EQ(ecm.RemoveComponent<TestSoAComponent>(entities[0]), GRK_Result::Ok);
+  EXPECT_EQ((ecm.GetComponentColumn<TestSoAComponent, kHealth>().size()), 3u);
+  EXPECT_EQ(HealthOf(ecm, entities[0]), -1);
+  EXPECT_EQ(ecm.GetComponentReference<TestSoAComponent>(entities[3]).GetIndex(), 0u);
+  EXPECT_EQ(HealthOf(ecm, entities[3]), 30);
+  EXPECT_EQ(
+      static_cast<TestSoAComponent>(ecm.GetComponentReference<TestSoAComponent>(entities[3])).GetName(), "3");
+
+  // Garbage collecting a deleted entity removes its component too.
+  ASSERT_EQ(ecm.DeleteEntity(entities[1]), GRK_Result::Ok);
+  ecm.GarbageCollect();
+  EXPECT_EQ((ecm.GetComponentColumn<TestSoAComponent, kHealth>().size()), 2u);
+  EXPECT_EQ(HealthOf(ecm, entities[2]), 25);
+  EXPECT_EQ(HealthOf(ecm, entities[3]), 30);
+
+  // Sorting moves whole components and keeps the index in step.
+  ecm.SortComponentStore<TestSoAComponent>([](const auto& component) { return -component.template Get<kHealth>(); });
+  health = ecm.GetComponentColumn<TestSoAComponent, kHealth>();
+  EXPECT_EQ(std::vector<int>(health.begin(), health.end()), (std::vector<int>{30, 25}));
+  EXPECT_EQ(ecm.GetComponentReference<TestSoAComponent>(entities[3]).GetIndex(), 0u);
+  EXPECT_EQ(HealthOf(ecm, entities[2]), 25);
+  EXPECT_EQ(
+      static_cast<TestSoAComponent>(ecm.GetComponentReference<TestSoAComponent>(entities[2])).GetName(), "2");
+}
@@ -0,0 +1,163 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "grok3d/grok3d.h"
+#include "grok3d/grok3d_types.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Grok3d;
+using namespace testing;
+
+namespace {
+auto RandomPositions(std::size_t count, float extent) -> std::vector<glm::vec3> {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> coordinate(-extent, extent);
+  std::vector<glm::vec3> positions(count);
+  for (auto& position : positions) {
+    position = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+  }
+  return positions;
+}
+
+// Entity i + 1 is at positions[i].
+auto EntitiesFor(const std::vector<glm::vec3>& positions) -> std::vector<GRK_Entity> {
+  std::vector<GRK_Entity> entities(positions.size());
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    entities[i] = static_cast<GRK_Entity>(i + 1);
+  }
+  return entities;
+}
+
+auto Neighbours(const GRK_SpatialHashGrid& grid, const glm::vec3& position, float radius) -> std::vector<GRK_Entity> {
+  std::vector<GRK_Entity> found;
+  grid.ForEachNeighbour(position, radius, [&found](GRK_Entity entity, const glm::vec3&) {
+    found.push_back(entity);
+  });
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+auto BruteForceNeighbours(
+    const std::vector<glm::vec3>& positions,
+    const glm::vec3& position,
+    float radius) -> std::vector<GRK_Entity> {
+  std::vector<GRK_Entity> found;
+  for (std::size_t i = 0; i < positions.size(); i++) {
+    const auto offset = positions[i] - position;
+    if (glm::dot(offset, offset) <= radius * radius) {
+      found.push_back(static_cast<GRK_Entity>(i + 1));
+    }
+  }
+  return found;
+}
+}
+
+TEST(SpatialHashGridTests, TestForEachNeighbour) {
+  const std::vector<glm::vec3> positions = {
+      glm::vec3(0, 0, 0), glm::vec3(0.5f, 0, 0), glm::vec3(-1.5f, 0, 0), glm::vec3(0, 3, 0)};
+  GRK_SpatialHashGrid grid(1.0f, 64);
+  ASSERT_EQ(grid.Build(EntitiesFor(positions), positions), GRK_Result::Ok);
+  EXPECT_EQ(grid.Size(), 4u);
+
+  EXPECT_EQ(Neighbours(grid, glm::vec3(0), 1.0f), (std::vector<GRK_Entity>{1, 2}));
+  EXPECT_EQ(Neighbours(grid, glm::vec3(0), 1.5f), (std::vector<GRK_Entity>{1, 2, 3}));
+  EXPECT_EQ(Neighbours(grid, glm::vec3(0, 3, 0), 0.1f), (std::vector<GRK_Entity>{4}));
+  EXPECT_TRUE(Neighbours(grid, glm::vec3(10, 10, 10), 2.0f).empty());
+
+  const std::vector<GRK_Entity> tooFew = {1, 2};
+  EXPECT_EQ(grid.Build(tooFew, positions), GRK_Result::SizeMismatch);
+  EXPECT_EQ(grid.Size(), 0u);
+}
+
+TEST(SpatialHashGridTests, TestMatchesBruteForce) {
+  // Few buckets so distinct cells collide, and enough points for the parallel build.
+  const auto positions = RandomPositions(static_cast<std::size_t>(c_parallel_spatial_hash_threshold) * 2, 50.0f);
+  GRK_SpatialHashGrid grid(2.0f, 256);
+  ASSERT_EQ(grid.Build(EntitiesFor(positions), positions), GRK_Result::Ok);
+
+  auto sorted = grid.GetSortedEntities();
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(sorted, EntitiesFor(positions));
+  for (std::size_t i = 0; i < grid.Size(); i++) {
+    EXPECT_EQ(grid.GetSortedPositions()[i], positions[grid.GetSortedEntities()[i] - 1]);
+  }
+
+  for (std::size_t i = 0; i < 100; i++) {
+    const auto& center = positions[i * 37];
+    EXPECT_EQ(Neighbours(grid, center, 3.0f), BruteForceNeighbours(positions, center, 3.0f));
+  }
+}
+
+TEST(SpatialHashGridTests, TestBuildFromManagerTransforms) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto leader = ecm.CreateEntity();
+  auto follower = ecm.CreateEntity();
+  auto hidden = ecm.CreateEntity();
+  auto remote = ecm.CreateEntity();
+  leader.GetComponent<GRK_TransformComponent>()->TranslateLocal(10, 0, 0);
+  follower.GetComponent<GRK_TransformComponent>()->SetParent(leader.GetComponent<GRK_TransformComponent>().operator->());
+  follower.GetComponent<GRK_TransformComponent>()->TranslateLocal(0, 1, 0);
+  hidden.GetComponent<GRK_TransformComponent>()->TranslateLocal(10, 1, 0);
+  ASSERT_EQ(ecm.SetEntityEnabled(static_cast<GRK_Entity>(hidden), false), GRK_Result::Ok);
+
+  // Cell origins are included, so this is next to the leader too.
+  constexpr GRK_CellID cell = 4;
+  ASSERT_EQ(ecm.SetEntityCell(static_cast<GRK_Entity>(remote), cell), GRK_Result::Ok);
+  ASSERT_EQ(ecm.SetCellOrigin(cell, glm::dvec3(10, -1, 0)), GRK_Result::Ok);
+  ecm.UpdateWorldTransforms();
+
+  GRK_SpatialHashGrid grid;
+  ecm.BuildSpatialHashGrid(grid);
+  EXPECT_EQ(grid.Size(), 3u);
+  std::vector<GRK_Entity> expected = {
+      static_cast<GRK_Entity>(leader), static_cast<GRK_Entity>(follower), static_cast<GRK_Entity>(remote)};
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(Neighbours(grid, glm::vec3(10, 0, 0), 1.0f), expected);
+  EXPECT_EQ(Neighbours(grid, glm::vec3(10, 1, 0), 0.5f), std::vector<GRK_Entity>{static_cast<GRK_Entity>(follower)});
+
+  // Rebuilding after the leader moves moves the follower with it.
+  leader.GetComponent<GRK_TransformComponent>()->TranslateLocal(-20, 0, 0);
+  ecm.UpdateWorldTransforms();
+  ecm.BuildSpatialHashGrid(grid);
+  EXPECT_EQ(Neighbours(grid, glm::vec3(10, 1, 0), 0.5f), std::vector<GRK_Entity>{});
+  EXPECT_EQ(Neighbours(grid, glm::vec3(-10, 1, 0), 0.5f), std::vector<GRK_Entity>{static_cast<GRK_Entity>(follower)});
+}
+
+TEST(SpatialHashGridTests, TestBuildFromManagerTransformsInChunks) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  // Enough entities to be gathered on several workers, with offset cell members in every chunk.
+  constexpr GRK_CellID cell = 7;
+  const auto count = c_parallel_spatial_hash_threshold + 100;
+  std::vector<GRK_Entity> entities;
+  for (std::size_t i = 0; i < count; i++) {
+    auto entity = ecm.CreateEntity();
+    entity.GetComponent<GRK_TransformComponent>()->TranslateLocal(static_cast<double>(i) * 4, 0, 0);
+    entities.push_back(static_cast<GRK_Entity>(entity));
+    if (i % 1000 == 0) {
+      ASSERT_EQ(ecm.SetEntityCell(entities.back(), cell), GRK_Result::Ok);
+    }
+  }
+  ASSERT_EQ(ecm.SetCellOrigin(cell, glm::dvec3(0, 100, 0)), GRK_Result::Ok);
+  ecm.UpdateWorldTransforms();
+
+  GRK_SpatialHashGrid grid;
+  ecm.BuildSpatialHashGrid(grid);
+  EXPECT_EQ(grid.Size(), count);
+  for (std::size_t i = 0; i < count; i += 500) {
+    const auto y = i % 1000 == 0 ? 100.0f : 0.0f;
+    EXPECT_EQ(Neighbours(grid, glm::vec3(static_cast<float>(i) * 4, y, 0), 1.0f), std::vector<GRK_Entity>{entities[i]});
+  }
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "grok3d/grok3d.h"
+#include "grok3d/grok3d_types.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace Grok3d;
+using namespace testing;
+
+namespace {
+auto ExpectMatricesNear(const glm::mat4& actual, const glm::mat4& expected) -> void {
+  for (int c = 0; c < 4; c++) {
+    for (int r = 0; r < 4; r++) {
+      EXPECT_NEAR(actual[c][r], expected[c][r], 1e-4f) << "column " << c << " row " << r;
+    }
+  }
+}
+
+// A random forest where every transform's parent, if any, comes before it.
+auto MakeRandomHierarchy(std::size_t count) -> GRK_TransformColumns {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+  std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+  GRK_TransformColumns columns;
+  for (std::size_t i = 0; i < count; i++) {
+    const auto axis = glm::normalize(glm::vec3(offset(random), offset(random), offset(random)));
+    const auto parent = i == 0 || random() % 4 == 0
+                        ? GRK_TransformColumns::kNoParent
+                        : static_cast<std::uint32_t>(random() % i);
+    EXPECT_EQ(columns.Add(
+        glm::vec3(offset(random), offset(random), offset(random)),
+        glm::angleAxis(angle(random), axis),
+        glm::vec3(scale(random), scale(random), scale(random)),
+        parent), GRK_Result::Ok);
+  }
+  return columns;
+}
+}
+
+TEST(TransformColumnsTests, TestMatchesGlmTransforms) {
+  GRK_TransformColumns columns;
+  const auto rotation = glm::angleAxis(std::acos(0.0f), glm::vec3(0, 0, 1));
+  ASSERT_EQ(columns.Add(glm::vec3(10, 0, 0), rotation, glm::vec3(1, 1, 1)), GRK_Result::Ok);
+  ASSERT_EQ(columns.Add(glm::vec3(0, 2, 0), glm::quat(1, 0, 0, 0), glm::vec3(2, 2, 2), 0), GRK_Result::Ok);
+  EXPECT_EQ(columns.Add(glm::vec3(0), glm::quat(1, 0, 0, 0), glm::vec3(1), 5), GRK_Result::NoSuchElement);
+  EXPECT_EQ(columns.Size(), 2u);
+
+  columns.UpdateWorldMatrices();
+
+  const auto parent = glm::translate(glm::mat4(1.0f), glm::vec3(10, 0, 0)) * glm::mat4_cast(rotation);
+  const auto child = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0, 2, 0)), glm::vec3(2, 2, 2));
+  ExpectMatricesNear(columns.GetWorldMatrices()[0], parent);
+  ExpectMatricesNear(columns.GetWorldMatrices()[1], parent * child);
+}
+
+TEST(TransformColumnsTests, TestSIMDMatchesScalar) {
+  // Not a multiple of the batch width so the scalar tail is exercised too.
+  auto simd = MakeRandomHierarchy(103);
+  auto scalar = MakeRandomHierarchy(103);
+
+  simd.UpdateWorldMatrices();
+  scalar.UpdateWorldMatricesScalar();
+
+  for (std::size_t i = 0; i < simd.Size(); i++) {
+    ExpectMatricesNear(simd.GetLocalMatrices()[i], scalar.GetLocalMatrices()[i]);
+    ExpectMatricesNear(simd.GetWorldMatrices()[i], scalar.GetWorldMatrices()[i]);
+  }
+
+  // Changing a root moves its whole subtree on the next update.
+  simd.SetLocalPosition(0, simd.GetLocalPosition(0) + glm::vec3(1, 0, 0));
+  scalar.SetLocalPosition(0, scalar.GetLocalPosition(0) + glm::vec3(1, 0, 0));
+  simd.UpdateWorldMatrices();
+  scalar.UpdateWorldMatricesScalar();
+  for (std::size_t i = 0; i < simd.Size(); i++) {
+    ExpectMatricesNear(simd.GetWorldMatrices()[i], scalar.GetWorldMatrices()[i]);
+  }
+}
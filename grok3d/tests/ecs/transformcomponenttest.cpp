@@ -0,0 +1,653 @@
+/* Copyright (c) 2018 Brandon Pollack
+* Contact @ grok3dengine@gmail.com
+* This file is available under the MIT license included in the project
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "grok3d/grok3d.h"
+#include "grok3d/grok3d_types.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace Grok3d;
+using namespace testing;
+
+class TestTransformComponent : public Test {
+ protected:
+  GRK_SystemManager systemManager_;
+  GRK_EntityComponentManager ecm_;
+
+  // vehicle <- turret <- barrel, and vehicle <- wheel
+  std::vector<GRK_EntityHandle> entities_ = CreateRig();
+  GRK_TransformComponent& vehicle_ = GetTransform(0);
+  GRK_TransformComponent& turret_ = GetTransform(1);
+  GRK_TransformComponent& barrel_ = GetTransform(2);
+  GRK_TransformComponent& wheel_ = GetTransform(3);
+  std::array<GRK_TransformComponent*, 4> rig_ = {&vehicle_, &turret_, &barrel_, &wheel_};
+
+  TestTransformComponent() {
+    turret_.SetParent(&vehicle_);
+    barrel_.SetParent(&turret_);
+    wheel_.SetParent(&vehicle_);
+
+    vehicle_.SetWorldPosition(10, 0, 0);
+    turret_.TranslateLocal(0, 2, 0);
+    barrel_.TranslateLocal(0, 0, 3);
+    wheel_.TranslateLocal(-1, 0, 0);
+  }
+
+  auto CreateRig() -> std::vector<GRK_EntityHandle> {
+    ecm_.Initialize(&systemManager_);
+    std::vector<GRK_EntityHandle> entities;
+    for (int i = 0; i < 4; i++) {
+      entities.push_back(ecm_.CreateEntity());
+    }
+    return entities;
+  }
+
+  auto GetTransform(std::size_t i) -> GRK_TransformComponent& {
+    return *entities_[i].GetComponent<GRK_TransformComponent>().operator->();
+  }
+
+  auto UpdateRig() -> void {
+    ecm_.UpdateWorldTransforms();
+  }
+};
+
+TEST_F(TestTransformComponent, TestWorldPositionFollowsParents) {
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(10, 2, 3));
+
+  UpdateRig();
+  for (const auto* transform : rig_) {
+    EXPECT_FALSE(transform->IsWorldDirty());
+  }
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(10, 2, 3));
+  EXPECT_EQ(wheel_.GetWorldPosition(), glm::dvec3(9, 0, 0));
+}
+
+TEST_F(TestTransformComponent, TestLocalChangesDirtyOnlyDescendants) {
+  UpdateRig();
+
+  turret_.TranslateLocal(0, 1, 0);
+  EXPECT_FALSE(vehicle_.IsWorldDirty());
+  EXPECT_TRUE(turret_.IsWorldDirty());
+  EXPECT_TRUE(barrel_.IsWorldDirty());
+  EXPECT_FALSE(wheel_.IsWorldDirty());
+
+  // Dirty transforms still answer correctly before the propagation pass.
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(10, 3, 3));
+
+  UpdateRig();
+  EXPECT_FALSE(barrel_.IsWorldDirty());
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(10, 3, 3));
+
+  barrel_.SetWorldPosition(0, 0, 0);
+  UpdateRig();
+  EXPECT_EQ(barrel_.GetLocalPosition(), glm::dvec3(-10, -3, 0));
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(0, 0, 0));
+}
+
+TEST_F(TestTransformComponent, TestDetachedChildrenBecomeRoots) {
+  UpdateRig();
+
+  vehicle_.DetachChildren();
+  EXPECT_EQ(vehicle_.ChildCount(), 0);
+  EXPECT_TRUE(turret_.IsWorldDirty());
+  EXPECT_TRUE(barrel_.IsWorldDirty());
+
+  UpdateRig();
+  EXPECT_EQ(turret_.GetWorldPosition(), glm::dvec3(0, 2, 0));
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(0, 2, 3));
+}
+
+namespace {
+// Loose enough for single precision transform storage.
+constexpr double kTolerance = sizeof(GRK_TransformScalar) < sizeof(double) ? 1e-5 : 1e-9;
+
+auto ExpectNear(glm::dvec3 actual, glm::dvec3 expected) -> void {
+  EXPECT_NEAR(actual.x, expected.x, kTolerance);
+  EXPECT_NEAR(actual.y, expected.y, kTolerance);
+  EXPECT_NEAR(actual.z, expected.z, kTolerance);
+}
+
+auto ExpectNear(const glm::dmat4& actual, const glm::dmat4& expected) -> void {
+  for (int column = 0; column < 4; column++) {
+    ExpectNear(glm::dvec3(actual[column]), glm::dvec3(expected[column]));
+    EXPECT_NEAR(actual[column].w, expected[column].w, kTolerance);
+  }
+}
+}
+
+TEST_F(TestTransformComponent, TestRotationAndScaleApplyToChildren) {
+  const auto quarterTurn = std::acos(0.0);
+  vehicle_.RotateLocal(quarterTurn, glm::dvec3(0, 0, 1));
+  turret_.SetLocalScale(2, 2, 2);
+
+  // The turret's offset is rotated by the vehicle, the barrel's by the vehicle and scaled by the turret.
+  ExpectNear(turret_.GetWorldPosition(), glm::dvec3(8, 0, 0));
+  ExpectNear(barrel_.GetWorldPosition(), glm::dvec3(8, 0, 6));
+  ExpectNear(wheel_.GetWorldPosition(), glm::dvec3(10, -1, 0));
+
+  UpdateRig();
+  ExpectNear(barrel_.GetWorldPosition(), glm::dvec3(8, 0, 6));
+  ExpectNear(barrel_.GetWorldMatrix(), vehicle_.GetLocalMatrix() * turret_.GetLocalMatrix() * barrel_.GetLocalMatrix());
+
+  barrel_.SetWorldPosition(0, 0, 0);
+  UpdateRig();
+  ExpectNear(barrel_.GetWorldPosition(), glm::dvec3(0, 0, 0));
+}
+
+TEST_F(TestTransformComponent, TestChildLinks) {
+  auto extra = ecm_.CreateEntity();
+  auto& antenna = *extra.GetComponent<GRK_TransformComponent>().operator->();
+  antenna.SetParent(&vehicle_);
+
+  EXPECT_EQ(vehicle_.ChildCount(), 3);
+  EXPECT_EQ(vehicle_.GetChild(0), &turret_);
+  EXPECT_EQ(vehicle_.GetChild(1), &wheel_);
+  EXPECT_EQ(vehicle_.GetChild(2), &antenna);
+  EXPECT_EQ(vehicle_.GetChild(3), nullptr);
+  EXPECT_EQ(antenna.GetSiblingIndex(), 2u);
+  EXPECT_EQ(vehicle_.GetChildIndex(&barrel_), static_cast<std::size_t>(-1));
+  EXPECT_EQ(vehicle_.GetSiblingIndex(), static_cast<std::size_t>(-1));
+  EXPECT_EQ(barrel_.GetParent(), &turret_);
+  EXPECT_EQ(barrel_.GetParentEntity(), static_cast<GRK_Entity>(entities_[1]));
+
+  // Taking out the middle child closes the gap.
+  wheel_.SetParent(&turret_);
+  EXPECT_EQ(vehicle_.ChildCount(), 2);
+  EXPECT_EQ(vehicle_.GetChild(1), &antenna);
+  EXPECT_EQ(vehicle_.GetChildIndex(&antenna), 1u);
+  EXPECT_EQ(turret_.GetChildIndex(&wheel_), 1u);
+  EXPECT_TRUE(wheel_.IsChildOf(&turret_));
+  EXPECT_FALSE(wheel_.IsChildOf(&vehicle_));
+
+  // Transforms not owned by a manager have nothing to link to.
+  GRK_TransformComponent loose;
+  loose.SetParent(&vehicle_);
+  EXPECT_EQ(loose.GetParent(), nullptr);
+  EXPECT_EQ(vehicle_.ChildCount(), 2);
+}
+
+TEST_F(TestTransformComponent, TestParentingIntoALoopIsIgnored) {
+  vehicle_.SetParent(&vehicle_);
+  EXPECT_EQ(vehicle_.GetParent(), nullptr);
+
+  // The barrel is the vehicle's grandchild.
+  vehicle_.SetParent(&barrel_);
+  EXPECT_EQ(vehicle_.GetParent(), nullptr);
+  EXPECT_EQ(vehicle_.GetHierarchyDepth(), 0u);
+  EXPECT_EQ(barrel_.GetHierarchyDepth(), 2u);
+  EXPECT_EQ(turret_.GetParent(), &vehicle_);
+
+  turret_.SetParent(&wheel_);
+  UpdateRig();
+  EXPECT_EQ(barrel_.GetHierarchyDepth(), 3u);
+  EXPECT_EQ(barrel_.GetWorldPosition(), glm::dvec3(9, 2, 3));
+}
+
+TEST_F(TestTransformComponent, TestLinksSurviveStoreMoves) {
+  // Disabling moves the vehicle's transform to the tail of the store.
+  ASSERT_EQ(entities_[0].Disable(), GRK_Result::Ok);
+  auto& vehicle = GetTransform(0);
+  auto& turret = GetTransform(1);
+  EXPECT_EQ(turret.GetParent(), &vehicle);
+  EXPECT_EQ(vehicle.GetChild(0), &turret);
+
+  vehicle.TranslateLocal(1, 0, 0);
+  UpdateRig();
+  EXPECT_EQ(GetTransform(2).GetWorldPosition(), glm::dvec3(11, 2, 3));
+
+  // Deleting the turret makes the barrel a root.
+  entities_[1].Destroy();
+  ecm_.GarbageCollect();
+  EXPECT_EQ(GetTransform(2).GetParent(), nullptr);
+  EXPECT_EQ(GetTransform(2).GetHierarchyDepth(), 0u);
+  EXPECT_EQ(GetTransform(0).ChildCount(), 1);
+  EXPECT_EQ(GetTransform(0).GetChild(0), &GetTransform(3));
+}
+
+TEST(TransformComponentManagerTests, TestUpdateWorldTransformsCleansEveryTransform) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto entity = ecm.CreateEntity();
+  entity.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 2, 3);
+  EXPECT_TRUE(entity.GetComponent<GRK_TransformComponent>()->IsWorldDirty());
+
+  ecm.UpdateWorldTransforms();
+  EXPECT_FALSE(entity.GetComponent<GRK_TransformComponent>()->IsWorldDirty());
+  EXPECT_EQ(entity.GetComponent<GRK_TransformComponent>()->GetWorldPosition(), glm::dvec3(1, 2, 3));
+}
+
+TEST(TransformComponentManagerTests, TestGetWorldMatrices) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto first = ecm.CreateEntity();
+  auto second = ecm.CreateEntity();
+  first.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 2, 3);
+  second.GetComponent<GRK_TransformComponent>()->SetLocalScale(4, 4, 4);
+  ecm.UpdateWorldTransforms();
+
+  const std::vector<GRK_Entity> entities = {static_cast<GRK_Entity>(second), static_cast<GRK_Entity>(first)};
+  std::vector<glm::mat4> matrices(entities.size());
+  ASSERT_EQ(ecm.GetWorldMatrices(entities, matrices), GRK_Result::Ok);
+  EXPECT_EQ(matrices[0][0][0], 4.0f);
+  EXPECT_EQ(matrices[1][3], glm::vec4(1, 2, 3, 1));
+
+  std::vector<glm::mat4> tooFew(1);
+  EXPECT_EQ(ecm.GetWorldMatrices(entities, tooFew), GRK_Result::NoSpaceRemaining);
+
+  const std::vector<GRK_Entity> missing = {0};
+  EXPECT_EQ(ecm.GetWorldMatrices(missing, matrices), GRK_Result::NoSuchEntity);
+  EXPECT_EQ(matrices[0], glm::mat4(1.0f));
+}
+
+TEST(TransformComponentManagerTests, TestCameraRelativeMatricesUseCellOrigins) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  // Far enough out that single precision could not tell 1 apart from 0 at scene coordinates.
+  const auto origin = glm::dvec3(1e9, 0, -1e9);
+  const GRK_CellID cell = 7;
+  ASSERT_EQ(ecm.SetCellOrigin(cell, origin), GRK_Result::Ok);
+  EXPECT_EQ(ecm.SetCellOrigin(kNoCell, origin), GRK_Result::NoSuchElement);
+
+  auto anchored = ecm.CreateEntity();
+  auto loose = ecm.CreateEntity();
+  ASSERT_EQ(ecm.SetEntityCell(static_cast<GRK_Entity>(anchored), cell), GRK_Result::Ok);
+  anchored.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 2, 3);
+  loose.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 2, 3);
+  ecm.UpdateWorldTransforms();
+
+  const std::vector<GRK_Entity> entities = {static_cast<GRK_Entity>(anchored), static_cast<GRK_Entity>(loose)};
+  std::vector<glm::mat4> matrices(entities.size());
+  ASSERT_EQ(ecm.GetCameraRelativeMatrices(entities, origin + glm::dvec3(1, 2, 0), matrices), GRK_Result::Ok);
+  EXPECT_EQ(matrices[0][3], glm::vec4(0, 0, 3, 1));
+  EXPECT_EQ(matrices[1][3], glm::vec4(-1e9f, 0, 1e9f, 1));
+
+  // The origin travels with the cell.
+  std::vector<std::byte> blob;
+  ASSERT_EQ(ecm.SaveCell(cell, blob), GRK_Result::Ok);
+  ASSERT_EQ(ecm.UnloadCell(cell), GRK_Result::Ok);
+  EXPECT_EQ(ecm.GetCellOrigin(cell), glm::dvec3(0));
+  ASSERT_EQ(ecm.LoadCell(blob), GRK_Result::Ok);
+  EXPECT_EQ(ecm.GetCellOrigin(cell), origin);
+}
+
+TEST(TransformComponentManagerTests, TestInterpolationBetweenTicks) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto parentEntity = ecm.CreateEntity();
+  auto childEntity = ecm.CreateEntity();
+  auto parent = parentEntity.GetComponent<GRK_TransformComponent>();
+  auto child = childEntity.GetComponent<GRK_TransformComponent>();
+  child->SetParent(parent.operator->());
+  child->TranslateLocal(0, 1, 0);
+  parent->TranslateLocal(2, 0, 0);
+
+  // A new transform has nothing to come from.
+  ecm.UpdateWorldTransforms();
+  ExpectNear(glm::dvec3(parent->GetInterpolatedWorldMatrix(0.0)[3]), glm::dvec3(2, 0, 0));
+
+  parent->TranslateLocal(8, 0, 0);
+  parent->RotateLocal(std::acos(0.0), glm::dvec3(0, 0, 1));
+  ecm.UpdateWorldTransforms();
+  ExpectNear(glm::dvec3(parent->GetInterpolatedWorldMatrix(0.0)[3]), glm::dvec3(2, 0, 0));
+  ExpectNear(glm::dvec3(parent->GetInterpolatedWorldMatrix(0.25)[3]), glm::dvec3(4, 0, 0));
+  ExpectNear(glm::dvec3(parent->GetInterpolatedWorldMatrix(1.0)[3]), glm::dvec3(10, 0, 0));
+
+  // Children blend their own world matrices, so the child cuts straight across the parent's turn.
+  const auto halfway = child->GetInterpolatedWorldMatrix(0.5);
+  ExpectNear(glm::dvec3(halfway[3]), glm::dvec3(5.5, 0.5, 0));
+  ExpectNear(glm::dvec3(halfway[0]), glm::dvec3(std::sqrt(0.5), std::sqrt(0.5), 0));
+
+  const std::vector<GRK_Entity> entities = {static_cast<GRK_Entity>(parentEntity)};
+  std::vector<glm::mat4> matrices(entities.size());
+  ASSERT_EQ(ecm.GetInterpolatedWorldMatrices(entities, 0.5, matrices), GRK_Result::Ok);
+  ExpectNear(glm::dvec3(matrices[0][3]), glm::dvec3(6, 0, 0));
+
+  // A tick without changes leaves nothing to interpolate.
+  ecm.UpdateWorldTransforms();
+  ExpectNear(glm::dvec3(parent->GetInterpolatedWorldMatrix(0.0)[3]), glm::dvec3(10, 0, 0));
+  ExpectNear(glm::dvec3(child->GetInterpolatedWorldMatrix(0.0)[3]), glm::dvec3(9, 0, 0));
+}
+
+TEST(TransformComponentManagerTests, TestHierarchyLevelsFollowParents) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  std::vector<GRK_EntityHandle> entities;
+  for (int i = 0; i < 4; i++) {
+    entities.push_back(ecm.CreateEntity());
+  }
+  auto transform = [&](std::size_t i) { return entities[i].GetComponent<GRK_TransformComponent>().operator->(); };
+  const auto& hierarchy = ecm.GetTransformHierarchy();
+  EXPECT_EQ(hierarchy.GetLevels().size(), 1u);
+
+  // 0 <- 1 <- 2, then 3 becomes the parent of 0.
+  transform(1)->SetParent(transform(0));
+  transform(2)->SetParent(transform(1));
+  EXPECT_EQ(hierarchy.GetDepth(static_cast<GRK_Entity>(entities[2])), 2u);
+  transform(0)->SetParent(transform(3));
+  EXPECT_EQ(hierarchy.GetLevels().size(), 4u);
+  EXPECT_EQ(transform(2)->GetHierarchyDepth(), 3u);
+  EXPECT_EQ(hierarchy.GetDepth(static_cast<GRK_Entity>(entities[2])), 3u);
+
+  transform(3)->TranslateLocal(1, 0, 0);
+  transform(2)->TranslateLocal(0, 1, 0);
+  ecm.UpdateWorldTransforms();
+  EXPECT_FALSE(transform(2)->IsWorldDirty());
+  EXPECT_EQ(transform(2)->GetWorldPosition(), glm::dvec3(1, 1, 0));
+
+  // Moving 1 to 3 leaves 0 without children and pulls 2 up a level.
+  transform(1)->SetParent(transform(3));
+  EXPECT_EQ(transform(0)->ChildCount(), 0);
+  EXPECT_EQ(hierarchy.GetDepth(static_cast<GRK_Entity>(entities[2])), 2u);
+
+  transform(3)->DetachChildren();
+  EXPECT_EQ(hierarchy.GetLevels().size(), 2u);
+  EXPECT_EQ(hierarchy.GetDepth(static_cast<GRK_Entity>(entities[1])), 0u);
+
+  entities[2].Destroy();
+  ecm.GarbageCollect();
+  EXPECT_EQ(hierarchy.Size(), 3u);
+  EXPECT_EQ(hierarchy.GetLevels().size(), 1u);
+}
+
+TEST(TransformComponentManagerTests, TestWideLevelsUpdateInParallel) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto root = ecm.CreateEntity();
+  std::vector<GRK_EntityHandle> children;
+  for (int i = 0; i < c_parallel_transform_level_threshold + 10; i++) {
+    children.push_back(ecm.CreateEntity());
+  }
+
+  auto* rootTransform = root.GetComponent<GRK_TransformComponent>().operator->();
+  for (std::size_t i = 0; i < children.size(); i++) {
+    auto* child = children[i].GetComponent<GRK_TransformComponent>().operator->();
+    child->SetParent(rootTransform);
+    child->TranslateLocal(static_cast<double>(i), 0, 0);
+  }
+  rootTransform->TranslateLocal(0, 5, 0);
+
+  ecm.UpdateWorldTransforms();
+  for (std::size_t i = 0; i < children.size(); i++) {
+    const auto* child = children[i].GetComponent<GRK_TransformComponent>().operator->();
+    ASSERT_FALSE(child->IsWorldDirty());
+    ASSERT_EQ(child->GetWorldPosition(), glm::dvec3(static_cast<double>(i), 5, 0));
+  }
+}
+
+TEST(TransformComponentManagerTests, TestStaticTransformsAreBakedOnce) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto building = ecm.CreateEntity(GRK_TransformMobility::Static);
+  auto door = ecm.CreateEntity();
+  auto mover = ecm.CreateEntity();
+  auto buildingTransform = building.GetComponent<GRK_TransformComponent>();
+  auto doorTransform = door.GetComponent<GRK_TransformComponent>();
+  ASSERT_TRUE(buildingTransform->IsStatic());
+  buildingTransform->TranslateLocal(10, 0, 0);
+  doorTransform->SetParent(buildingTransform.operator->());
+  doorTransform->TranslateLocal(0, 1, 0);
+
+  // Static transforms can not hang off dynamic ones.
+  buildingTransform->SetParent(mover.GetComponent<GRK_TransformComponent>().operator->());
+  EXPECT_EQ(buildingTransform->GetParent(), nullptr);
+
+  const auto& statics = ecm.GetStaticTransforms();
+  EXPECT_EQ(ecm.GetTransformHierarchy().Size(), 2u);
+  ecm.UpdateWorldTransforms();
+  ASSERT_EQ(statics.Size(), 1u);
+  EXPECT_EQ(statics.GetEntities()[0], static_cast<GRK_Entity>(building));
+  EXPECT_EQ(statics.GetWorldMatrices()[0][3], glm::vec4(10, 0, 0, 1));
+  EXPECT_EQ(doorTransform->GetWorldPosition(), glm::dvec3(10, 1, 0));
+
+  // Nothing is baked again while nothing moves.
+  const auto version = statics.GetVersion();
+  mover.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 0, 0);
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(statics.GetVersion(), version);
+  EXPECT_EQ(ecm.GetMovedEntities(), std::vector<GRK_Entity>{static_cast<GRK_Entity>(mover)});
+
+  // Moving it anyway rebakes it and its dynamic children follow, without interpolating.
+  buildingTransform->TranslateLocal(5, 0, 0);
+  EXPECT_EQ(statics.GetWorldMatrices()[0][3], glm::vec4(10, 0, 0, 1));
+  ecm.UpdateWorldTransforms();
+  EXPECT_NE(statics.GetVersion(), version);
+  EXPECT_EQ(statics.GetWorldMatrices()[0][3], glm::vec4(15, 0, 0, 1));
+  EXPECT_EQ(doorTransform->GetWorldPosition(), glm::dvec3(15, 1, 0));
+  EXPECT_EQ(glm::dvec3(buildingTransform->GetInterpolatedWorldMatrix(0.0)[3]), glm::dvec3(15, 0, 0));
+
+  // Static transforms stay static through a cell round trip.
+  const GRK_CellID cell = 2;
+  ASSERT_EQ(ecm.SetEntityCell(static_cast<GRK_Entity>(building), cell), GRK_Result::Ok);
+  std::vector<std::byte> blob;
+  ASSERT_EQ(ecm.SaveCell(cell, blob), GRK_Result::Ok);
+  ASSERT_EQ(ecm.UnloadCell(cell), GRK_Result::Ok);
+  EXPECT_EQ(statics.Size(), 0u);
+  ASSERT_EQ(ecm.LoadCell(blob), GRK_Result::Ok);
+  ecm.UpdateWorldTransforms();
+  ASSERT_EQ(statics.Size(), 1u);
+  EXPECT_EQ(statics.GetWorldMatrices()[0][3], glm::vec4(15, 0, 0, 1));
+  EXPECT_EQ(ecm.GetTransformHierarchy().Size(), 2u);
+}
+
+TEST(TransformComponentManagerTests, TestRemovingTransformUnlinksIt) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  auto parent = ecm.CreateEntity();
+  auto child = ecm.CreateEntity();
+  auto building = ecm.CreateEntity(GRK_TransformMobility::Static);
+  auto childTransform = child.GetComponent<GRK_TransformComponent>();
+  childTransform->SetParent(parent.GetComponent<GRK_TransformComponent>().operator->());
+  childTransform->TranslateLocal(0, 1, 0);
+  parent.GetComponent<GRK_TransformComponent>()->TranslateLocal(10, 0, 0);
+  ecm.UpdateWorldTransforms();
+  ASSERT_EQ(ecm.GetStaticTransforms().Size(), 1u);
+
+  // The static transform is removed while still queued to be baked again.
+  building.GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 0, 0);
+  ASSERT_EQ(parent.RemoveComponent<GRK_TransformComponent>(), GRK_Result::Ok);
+  ASSERT_EQ(building.RemoveComponent<GRK_TransformComponent>(), GRK_Result::Ok);
+  EXPECT_EQ(ecm.GetTransformHierarchy().Size(), 1u);
+  EXPECT_TRUE(ecm.GetTransformHierarchy().GetStaticBakeQueue().empty());
+  EXPECT_EQ(ecm.GetStaticTransforms().Size(), 0u);
+
+  // The child is a root now and the sweep never reaches the removed transforms.  Removing moved
+  // the store around, so the child's transform is looked up again.
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(child.GetComponent<GRK_TransformComponent>()->GetParent(), nullptr);
+  EXPECT_EQ(child.GetComponent<GRK_TransformComponent>()->GetWorldPosition(), glm::dvec3(0, 1, 0));
+
+  // A new transform on the old parent does not adopt its old children.
+  ASSERT_EQ(parent.AddComponent(GRK_TransformComponent()), GRK_Result::Ok);
+  EXPECT_EQ(parent.GetComponent<GRK_TransformComponent>()->ChildCount(), 0);
+  EXPECT_EQ(child.GetComponent<GRK_TransformComponent>()->GetParentEntity(), 0u);
+  ecm.UpdateWorldTransforms();
+  EXPECT_EQ(ecm.GetTransformHierarchy().Size(), 2u);
+}
+
+TEST(TransformComponentManagerTests, TestCoalesceIndexRanges) {
+  const std::vector<std::size_t> indices = {1, 2, 2, 3, 6, 9, 10};
+  std::vector<GRK_IndexRange> ranges;
+
+  GRK_CoalesceIndexRanges(indices, 0, ranges);
+  ASSERT_EQ(ranges.size(), 3u);
+  EXPECT_EQ(ranges[0].first, 1u);
+  EXPECT_EQ(ranges[0].count, 3u);
+  EXPECT_EQ(ranges[1].first, 6u);
+  EXPECT_EQ(ranges[1].count, 1u);
+  EXPECT_EQ(ranges[2].first, 9u);
+  EXPECT_EQ(ranges[2].count, 2u);
+
+  GRK_CoalesceIndexRanges(indices, 2, ranges);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].first, 1u);
+  EXPECT_EQ(ranges[0].count, 10u);
+
+  GRK_CoalesceIndexRanges(notstd::span<const std::size_t>(), 2, ranges);
+  EXPECT_TRUE(ranges.empty());
+}
+
+TEST(TransformComponentManagerTests, TestChangedTransformRanges) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  std::vector<GRK_EntityHandle> entities;
+  for (int i = 0; i < 20; i++) {
+    entities.push_back(ecm.CreateEntity());
+  }
+
+  // Every new transform changes.
+  ecm.UpdateWorldTransforms();
+  ASSERT_EQ(ecm.GetChangedTransformRanges().size(), 1u);
+  EXPECT_EQ(ecm.GetChangedTransformRanges()[0].count, 20u);
+
+  // The store is in creation order, so these are two runs far enough apart to stay separate.
+  static_assert(c_transform_upload_max_gap < 17, "the runs below would be joined");
+  const auto layoutVersion = ecm.GetStoreLayoutVersion<GRK_TransformComponent>();
+  entities[19].GetComponent<GRK_TransformComponent>()->TranslateLocal(3, 0, 0);
+  entities[1].GetComponent<GRK_TransformComponent>()->TranslateLocal(2, 0, 0);
+  entities[0].GetComponent<GRK_TransformComponent>()->TranslateLocal(1, 0, 0);
+  ecm.UpdateWorldTransforms();
+  const auto& ranges = ecm.GetChangedTransformRanges();
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0].first, 0u);
+  EXPECT_EQ(ranges[0].count, 2u);
+  EXPECT_EQ(ranges[1].first, 19u);
+  EXPECT_EQ(ranges[1].count, 1u);
+  EXPECT_EQ(ecm.GetStoreLayoutVersion<GRK_TransformComponent>(), layoutVersion);
+
+  std::vector<glm::mat4> matrices(2);
+  ASSERT_EQ(ecm.WriteStoreWorldMatrices(ranges[0].first, matrices), GRK_Result::Ok);
+  EXPECT_EQ(matrices[0][3], glm::vec4(1, 0, 0, 1));
+  EXPECT_EQ(matrices[1][3], glm::vec4(2, 0, 0, 1));
+  EXPECT_EQ(ecm.WriteStoreWorldMatrices(19, matrices), GRK_Result::NoSuchElement);
+
+  ecm.UpdateWorldTransforms();
+  EXPECT_TRUE(ecm.GetChangedTransformRanges().empty());
+
+  // Removing a transform moves another into its slot.
+  entities[5].Destroy();
+  ecm.GarbageCollect();
+  EXPECT_NE(ecm.GetStoreLayoutVersion<GRK_TransformComponent>(), layoutVersion);
+}
+
+TEST(TransformComponentManagerTests, TestBatchTranslateAndSetWorldPositions) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  // A formation of three under a leader.
+  auto leader = ecm.CreateEntity();
+  std::vector<GRK_Entity> members;
+  for (int i = 0; i < 3; i++) {
+    auto member = ecm.CreateEntity();
+    member.GetComponent<GRK_TransformComponent>()->SetParent(leader.GetComponent<GRK_TransformComponent>().operator->());
+    members.push_back(static_cast<GRK_Entity>(member));
+  }
+  leader.GetComponent<GRK_TransformComponent>()->TranslateLocal(10, 0, 0);
+  leader.GetComponent<GRK_TransformComponent>()->SetLocalScale(2, 2, 2);
+  ecm.UpdateWorldTransforms();
+
+  const std::vector<glm::dvec3> offsets = {glm::dvec3(1, 0, 0), glm::dvec3(0, 1, 0), glm::dvec3(0, 0, 1)};
+  ASSERT_EQ(ecm.TranslateLocal(members, offsets), GRK_Result::Ok);
+  std::vector<glm::dvec3> positions(members.size());
+  ASSERT_EQ(ecm.GetWorldPositions(members, positions), GRK_Result::Ok);
+  ExpectNear(positions[0], glm::dvec3(12, 0, 0));
+  ExpectNear(positions[1], glm::dvec3(10, 2, 0));
+  ExpectNear(positions[2], glm::dvec3(10, 0, 2));
+
+  // Moving the leader first in the same batch is seen by the members after it.
+  std::vector<GRK_Entity> everyone = {static_cast<GRK_Entity>(leader)};
+  everyone.insert(everyone.end(), members.begin(), members.end());
+  const std::vector<glm::dvec3> targets = {
+      glm::dvec3(0, 0, 0), glm::dvec3(4, 0, 0), glm::dvec3(0, 4, 0), glm::dvec3(0, 0, 4)};
+  ASSERT_EQ(ecm.SetWorldPositions(everyone, targets), GRK_Result::Ok);
+  ExpectNear(ecm.GetComponent<GRK_TransformComponent>(members[0])->GetLocalPosition(), glm::dvec3(2, 0, 0));
+  ecm.UpdateWorldTransforms();
+  positions.resize(everyone.size());
+  ASSERT_EQ(ecm.GetWorldPositions(everyone, positions), GRK_Result::Ok);
+  for (std::size_t i = 0; i < everyone.size(); i++) {
+    ExpectNear(positions[i], targets[i]);
+  }
+
+  // Nothing moves when any part of the batch is bad.
+  EXPECT_EQ(ecm.TranslateLocal(members, notstd::span<const glm::dvec3>(offsets.data(), 2)), GRK_Result::SizeMismatch);
+  const std::vector<GRK_Entity> withMissing = {members[0], 12345, members[2]};
+  EXPECT_EQ(ecm.SetWorldPositions(withMissing, offsets), GRK_Result::NoSuchEntity);
+  EXPECT_FALSE(ecm.GetComponent<GRK_TransformComponent>(members[0])->IsWorldDirty());
+  EXPECT_EQ(ecm.GetWorldPositions(withMissing, positions), GRK_Result::NoSuchEntity);
+  EXPECT_EQ(positions[1], glm::dvec3(0));
+}
+
+TEST(TransformComponentManagerTests, TestBatchDirtiesEachMovedSubtree) {
+  GRK_SystemManager systemManager;
+  GRK_EntityComponentManager ecm;
+  ecm.Initialize(&systemManager);
+
+  // root <- middle <- leaf, and a bystander that is not moved.
+  std::vector<GRK_Entity> chain;
+  for (int i = 0; i < 3; i++) {
+    auto entity = ecm.CreateEntity();
+    if (i > 0) {
+      entity.GetComponent<GRK_TransformComponent>()->SetParent(ecm.GetComponent<GRK_TransformComponent>(chain.back()).operator->());
+    }
+    chain.push_back(static_cast<GRK_Entity>(entity));
+  }
+  const auto bystander = static_cast<GRK_Entity>(ecm.CreateEntity());
+  ecm.UpdateWorldTransforms();
+
+  // The leaf comes first, its grandparent's subtree covers it.
+  const std::vector<GRK_Entity> batch = {chain[2], chain[0]};
+  const std::vector<glm::dvec3> offsets = {glm::dvec3(0, 0, 1), glm::dvec3(5, 0, 0)};
+  ASSERT_EQ(ecm.TranslateLocal(batch, offsets), GRK_Result::Ok);
+  for (const auto entity : chain) {
+    EXPECT_TRUE(ecm.GetComponent<GRK_TransformComponent>(entity)->IsWorldDirty());
+  }
+  EXPECT_FALSE(ecm.GetComponent<GRK_TransformComponent>(bystander)->IsWorldDirty());
+
+  ecm.UpdateWorldTransforms();
+  std::vector<glm::dvec3> positions(chain.size());
+  ASSERT_EQ(ecm.GetWorldPositions(chain, positions), GRK_Result::Ok);
+  ExpectNear(positions[0], glm::dvec3(5, 0, 0));
+  ExpectNear(positions[1], glm::dvec3(5, 0, 0));
+  ExpectNear(positions[2], glm::dvec3(5, 0, 1));
+  EXPECT_THAT(ecm.GetMovedEntities(), UnorderedElementsAreArray(chain));
+
+  // Runs under different parents each get their parent's new position.
+  const std::vector<GRK_Entity> everyone = {chain[0], chain[1], chain[2], bystander};
+  const std::vector<glm::dvec3> targets = {
+      glm::dvec3(1, 1, 1), glm::dvec3(2, 2, 2), glm::dvec3(3, 3, 3), glm::dvec3(4, 4, 4)};
+  ASSERT_EQ(ecm.SetWorldPositions(everyone, targets), GRK_Result::Ok);
+  ecm.UpdateWorldTransforms();
+  positions.resize(everyone.size());
+  ASSERT_EQ(ecm.GetWorldPositions(everyone, positions), GRK_Result::Ok);
+  for (std::size_t i = 0; i < everyone.size(); i++) {
+    ExpectNear(positions[i], targets[i]);
+  }
+
+  // Empty batches do nothing.
+  EXPECT_EQ(ecm.TranslateLocal({}, {}), GRK_Result::Ok);
+  EXPECT_EQ(ecm.SetWorldPositions({}, {}), GRK_Result::Ok);
+}
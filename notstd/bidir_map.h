@@ -74,17 +74,27 @@ class bidir_map {
   size_t max_size() const noexcept {
     return m_forwardMap.max_size();
   }
+  /**number of buckets in each direction's map*/
+  size_t bucket_count() const noexcept {
+    return m_forwardMap.bucket_count();
+  }
 
   // Iterators
   auto begin() noexcept {
     return m_forwardMap.begin();
   }
+  auto begin() const noexcept {
+    return m_forwardMap.begin();
+  }
   auto reverse_begin() noexcept {
     return m_reverseMap.begin();
   }
   auto end() noexcept {
     return m_forwardMap.end();
   }
+  auto end() const noexcept {
+    return m_forwardMap.end();
+  }
   auto reverse_end() noexcept {
     return m_reverseMap.end();
   }
@@ -140,6 +150,11 @@ class bidir_map {
     m_forwardMap.clear();
     m_reverseMap.clear();
   }
+  /**rehash both directions for at least n buckets, 0 fits the buckets to the current size*/
+  void rehash(size_t n) {
+    m_forwardMap.rehash(n);
+    m_reverseMap.rehash(n);
+  }
 
  private:
   MapType_t m_forwardMap;   ///< The forward map
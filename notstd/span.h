@@ -0,0 +1,75 @@
+
+/**@file*/
+
+#ifndef __NOTSTD_SPAN__
+#define __NOTSTD_SPAN__
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace notstd {
+/**A non owning view of a contiguous sequence of T, a stand in for c++20's std::span (dynamic
+ * extent only)
+ *
+ * @tparam T the element type, const T for a read only view*/
+template<class T>
+class span {
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = T*;
+
+  constexpr span() noexcept : data_(nullptr), size_(0) {}
+
+  constexpr span(T* data, size_type size) noexcept : data_(data), size_(size) {}
+
+  constexpr span(T* first, T* last) noexcept : data_(first), size_(static_cast<size_type>(last - first)) {}
+
+  template<std::size_t N>
+  constexpr span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+  /**views over a vector, a span<const T> can be made from a const vector*/
+  template<class Alloc>
+  span(std::vector<value_type, Alloc>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+  /**@overload*/
+  template<class Alloc, class U = T, class = std::enable_if_t<std::is_const<U>::value>>
+  span(const std::vector<value_type, Alloc>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+  /**a span<T> converts to a span<const T>*/
+  template<class U, class = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+  constexpr span(const span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+  // Capacity
+  constexpr auto size() const noexcept -> size_type { return size_; }
+  constexpr auto size_bytes() const noexcept -> size_type { return size_ * sizeof(T); }
+  constexpr auto empty() const noexcept -> bool { return size_ == 0; }
+
+  // Access
+  constexpr auto data() const noexcept -> pointer { return data_; }
+  constexpr auto operator[](size_type i) const -> reference { return data_[i]; }
+  constexpr auto front() const -> reference { return data_[0]; }
+  constexpr auto back() const -> reference { return data_[size_ - 1]; }
+
+  // Iterators
+  constexpr auto begin() const noexcept -> iterator { return data_; }
+  constexpr auto end() const noexcept -> iterator { return data_ + size_; }
+
+  // Subviews
+  constexpr auto first(size_type count) const -> span { return span(data_, count); }
+  constexpr auto last(size_type count) const -> span { return span(data_ + size_ - count, count); }
+  constexpr auto subspan(size_type offset, size_type count) const -> span {
+    return span(data_ + offset, count);
+  }
+
+ private:
+  T* data_;         ///< first element
+  size_type size_;  ///< number of elements
+};
+} /*notstd*/
+
+#endif